@@ -0,0 +1,944 @@
+#include "simulations/sorting/quicksort/QuicksortController.h"
+#include "simulations/sorting/quicksort/ParallelQuicksort.h"
+#include "simulations/pathfinding/astar/AStarController.h"
+#include "simulations/pathfinding/astar/BatchPathSolver.h"
+#include "simulations/pathfinding/astar/BitParallelBfs.h"
+#include "simulations/pathfinding/astar/CrowdSimulation.h"
+#include "simulations/pathfinding/astar/CooperativePathfinder.h"
+#include "simulations/pathfinding/astar/MovingAiLoader.h"
+#include "simulations/pathfinding/astar/MapGenerator.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Headless engine benchmark. Generates full traces without opening a window
+// and prints one record per (engine, distribution, size) as CSV or JSON.
+
+struct BenchOptions {
+    std::vector<std::string> engines = {"quicksort", "astar"};
+    std::vector<int> sortSizes = {1000, 10000, 100000};
+    std::vector<int> gridSizes = {16, 32, 64};
+    std::vector<std::string> sortDistributions = {"random", "few-unique"};  // Sorted/reversed are quadratic with FIRST pivots
+    std::vector<std::string> gridDistributions = {"open", "walls-20", "walls-35"};
+    QuicksortEngineSettings sortEngine;
+    std::vector<PartitionKernel> kernels = {PartitionKernel::HOARE};  // Parallel sort only
+    AStarOpenListKind openList = AStarOpenListKind::INDEXED_HEAP;
+    AStarNeighborhood neighborhood = AStarNeighborhood::FOUR;
+    AStarHeuristic heuristic = AStarHeuristic::MANHATTAN;
+    AStarTieBreak tieBreak = AStarTieBreak::HEAP_ORDER;
+    int sectorSize = 32;   // HPA* only
+    int queryCount = 1000; // Batch only
+    int threads = 0;       // Batch only; 0 uses every hardware thread
+    std::vector<int> agentCounts = {1000, 10000, 50000};  // Crowd and cooperative only
+    int window = 16;       // Cooperative only
+    int terrain = 1;       // A* and D* Lite engines: heaviest noise terrain weight, 1 keeps every cell at cost 1
+    std::string mapPath;   // Scenario runner only: Moving AI .map and .scen files
+    std::string scenPath;
+    std::string format = "csv";
+    unsigned int seed = 12345;
+    int repeat = 3;
+    size_t keyframeInterval = 0;   // Quicksort and A* traces; 0 keeps each controller's default
+};
+
+struct BenchRecord {
+    std::string engine;
+    std::string distribution;
+    int size;
+    size_t steps;
+    double wallMs;           // Best of the repeats
+    double stepsPerSecond;
+    double bytesPerStep;     // Retained trace memory divided by step count
+    long peakRssKb;          // Process peak so far, so runs are ordered small to large
+    AStarSearchCounters counters;  // A* only
+    double buildMs = 0.0;          // HPA*, crowd and ALT only: one-off precomputation, not part of wall_ms
+    // Scenario runner only
+    int mismatches = 0;            // Paths off the reference optimum, unreachable ones included; also dstar
+    double usPerQuery = 0.0;
+    double p50Us = 0.0;
+    double p95Us = 0.0;
+    double p99Us = 0.0;
+    double expansionsPerSecond = 0.0;
+};
+
+static long getPeakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return -1;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return static_cast<long>(usage.ru_maxrss / 1024);  // Bytes on macOS
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+static std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static std::vector<int> splitIntList(const std::string& value) {
+    std::vector<int> items;
+    for (const auto& item : splitList(value)) {
+        items.push_back(std::atoi(item.c_str()));
+    }
+    return items;
+}
+
+static void printUsage() {
+    std::cout << "Usage: sim_bench [options]\n"
+              << "  --engine quicksort,psort,astar,jps,jps-plus,hpa,batch,bfs,crowd,coop,scen,mapgen,dstar  Engines to run\n"
+              << "  --sizes 1000,10000              Quicksort array sizes\n"
+              << "  --grids 32,64                   A* grid side lengths\n"
+              << "  --sort-dist random,sorted,reversed,few-unique\n"
+              << "  --pivot first|median3|ninther|random\n"
+              << "  --partition hoare|three-way|dual\n"
+              << "  --introsort on|off\n"
+              << "  --kernel hoare,lomuto,block,avx2  Partition kernels for psort\n"
+              << "  --open-list indexed|lazy|bucket A* open list implementation\n"
+              << "  --terrain N                     A* and dstar engines: noise terrain weights from 1 to N (at most 9)\n"
+              << "  --connectivity 4|8              A* neighborhood (JPS engines stay 4-connected)\n"
+              << "  --heuristic manhattan|octile|euclidean|chebyshev|zero|alt\n"
+              << "  --tie-break heap|low-h|low-g\n"
+              << "  --sector N                      HPA* sector side (at most 64)\n"
+              << "  --queries N                     Random start/goal pairs per batch\n"
+              << "  --threads N                     Batch workers, 0 for every hardware thread\n"
+              << "  --agents 1000,10000             Crowd and cooperative agent counts\n"
+              << "  --window N                      Cooperative planning window in steps\n"
+              << "  --map FILE --scen FILE          Moving AI map and scenarios for the scen runner\n"
+              << "  --grid-dist open,walls-20,walls-35,random,backtracker,prim,kruskal,caves,noise\n"
+              << "  --format csv|json\n"
+              << "  --seed N                        Input generator seed\n"
+              << "  --repeat N                      Runs per record, best time is kept\n"
+              << "  --keyframes N                   Quicksort and A* steps between trace keyframes\n";
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--engine") options.engines = splitList(value);
+        else if (arg == "--sizes") options.sortSizes = splitIntList(value);
+        else if (arg == "--grids") options.gridSizes = splitIntList(value);
+        else if (arg == "--sort-dist") options.sortDistributions = splitList(value);
+        else if (arg == "--grid-dist") options.gridDistributions = splitList(value);
+        else if (arg == "--pivot") {
+            if (value == "first") options.sortEngine.pivotStrategy = QuicksortPivotStrategy::FIRST;
+            else if (value == "median3") options.sortEngine.pivotStrategy = QuicksortPivotStrategy::MEDIAN_OF_THREE;
+            else if (value == "ninther") options.sortEngine.pivotStrategy = QuicksortPivotStrategy::NINTHER;
+            else if (value == "random") options.sortEngine.pivotStrategy = QuicksortPivotStrategy::RANDOM;
+            else {
+                std::cerr << "Unknown pivot strategy " << value << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--partition") {
+            if (value == "hoare") options.sortEngine.partitionScheme = QuicksortPartitionScheme::HOARE;
+            else if (value == "three-way") options.sortEngine.partitionScheme = QuicksortPartitionScheme::THREE_WAY;
+            else if (value == "dual") options.sortEngine.partitionScheme = QuicksortPartitionScheme::DUAL_PIVOT;
+            else {
+                std::cerr << "Unknown partition scheme " << value << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--introsort") options.sortEngine.introsortFallback = (value == "on");
+        else if (arg == "--kernel") {
+            options.kernels.clear();
+            for (const auto& name : splitList(value)) {
+                if (name == "hoare") options.kernels.push_back(PartitionKernel::HOARE);
+                else if (name == "lomuto") options.kernels.push_back(PartitionKernel::LOMUTO);
+                else if (name == "block") options.kernels.push_back(PartitionKernel::BRANCHLESS_BLOCK);
+                else if (name == "avx2") options.kernels.push_back(PartitionKernel::AVX2);
+                else {
+                    std::cerr << "Unknown partition kernel " << name << "\n";
+                    return false;
+                }
+            }
+        }
+        else if (arg == "--open-list") {
+            if (value == "lazy") options.openList = AStarOpenListKind::LAZY_HEAP;
+            else if (value == "bucket") options.openList = AStarOpenListKind::BUCKET_QUEUE;
+            else options.openList = AStarOpenListKind::INDEXED_HEAP;
+        }
+        else if (arg == "--connectivity") {
+            options.neighborhood = value == "8" ? AStarNeighborhood::EIGHT : AStarNeighborhood::FOUR;
+        }
+        else if (arg == "--heuristic") {
+            if (value == "manhattan") options.heuristic = AStarHeuristic::MANHATTAN;
+            else if (value == "octile") options.heuristic = AStarHeuristic::OCTILE;
+            else if (value == "euclidean") options.heuristic = AStarHeuristic::EUCLIDEAN;
+            else if (value == "chebyshev") options.heuristic = AStarHeuristic::CHEBYSHEV;
+            else if (value == "zero") options.heuristic = AStarHeuristic::ZERO;
+            else if (value == "alt") options.heuristic = AStarHeuristic::LANDMARKS;
+            else {
+                std::cerr << "Unknown heuristic " << value << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--tie-break") {
+            if (value == "heap") options.tieBreak = AStarTieBreak::HEAP_ORDER;
+            else if (value == "low-h") options.tieBreak = AStarTieBreak::LOW_H;
+            else if (value == "low-g") options.tieBreak = AStarTieBreak::LOW_G;
+            else {
+                std::cerr << "Unknown tie-break " << value << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--sector") options.sectorSize = std::max(2, std::min(64, std::atoi(value.c_str())));
+        else if (arg == "--queries") options.queryCount = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--threads") options.threads = std::max(0, std::atoi(value.c_str()));
+        else if (arg == "--agents") options.agentCounts = splitIntList(value);
+        else if (arg == "--window") options.window = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--terrain") options.terrain = std::max(1, std::min(AStarController::MAX_CELL_WEIGHT, std::atoi(value.c_str())));
+        else if (arg == "--map") options.mapPath = value;
+        else if (arg == "--scen") options.scenPath = value;
+        else if (arg == "--format") options.format = value;
+        else if (arg == "--seed") options.seed = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--repeat") options.repeat = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--keyframes") options.keyframeInterval = static_cast<size_t>(std::max(0, std::atoi(value.c_str())));
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<int> makeSortInput(const std::string& distribution, int size, unsigned int seed) {
+    std::vector<int> data(size);
+    std::mt19937 rng(seed);
+    for (int i = 0; i < size; i++) {
+        data[i] = i;
+    }
+    
+    if (distribution == "sorted") {
+        return data;
+    }
+    if (distribution == "reversed") {
+        std::reverse(data.begin(), data.end());
+        return data;
+    }
+    if (distribution == "few-unique") {
+        for (auto& value : data) {
+            value = static_cast<int>(rng() % 8);
+        }
+        return data;
+    }
+    std::shuffle(data.begin(), data.end(), rng);
+    return data;
+}
+
+static const char* const MAP_KIND_NAMES[] = {"random", "backtracker", "prim", "kruskal", "caves", "noise"};
+
+static bool parseMapKind(const std::string& name, MapGeneratorKind& kind) {
+    for (int i = 0; i < 6; i++) {
+        if (name == MAP_KIND_NAMES[i]) {
+            kind = static_cast<MapGeneratorKind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::vector<std::pair<int, int>> makeGridWalls(const std::string& distribution, int side, unsigned int seed) {
+    std::vector<std::pair<int, int>> walls;
+    MapGeneratorKind kind;
+    if (parseMapKind(distribution, kind)) {
+        // Corner to corner, like every grid engine's query
+        std::vector<std::uint8_t> mask;
+        MapGenerator generator;
+        generator.generate(kind, side, side, seed, MapGenerator::getDefaultDensity(kind), {0, side * side - 1}, mask);
+        for (int i = 0; i < side * side; i++) {
+            if (mask[i]) walls.push_back({i % side, i / side});
+        }
+        return walls;
+    }
+    
+    int density = 0;
+    if (distribution.compare(0, 6, "walls-") == 0) {
+        density = std::atoi(distribution.c_str() + 6);
+    }
+    if (density <= 0) return walls;
+    
+    std::mt19937 rng(seed);
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            if (static_cast<int>(rng() % 100) < density) {
+                walls.push_back({x, y});
+            }
+        }
+    }
+    return walls;
+}
+
+static BenchRecord makeRecord(const std::string& engine, const std::string& distribution, int size,
+                              size_t steps, double bestMs, size_t traceBytes) {
+    BenchRecord record;
+    record.engine = engine;
+    record.distribution = distribution;
+    record.size = size;
+    record.steps = steps;
+    record.wallMs = bestMs;
+    record.stepsPerSecond = bestMs > 0.0 ? steps / (bestMs / 1000.0) : 0.0;
+    record.bytesPerStep = steps > 0 ? static_cast<double>(traceBytes) / steps : 0.0;
+    record.peakRssKb = getPeakRssKb();
+    return record;
+}
+
+static BenchRecord benchQuicksort(const std::string& distribution, int size, const BenchOptions& options) {
+    QuicksortController controller;
+    controller.setLazyGeneration(false);
+    if (options.keyframeInterval > 0) controller.setKeyframeInterval(options.keyframeInterval);
+    controller.setEngineSettings(options.sortEngine);
+    controller.initialize(makeSortInput(distribution, size, options.seed));
+    
+    // reset() regenerates the whole trace from the original input
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        auto start = std::chrono::steady_clock::now();
+        controller.reset();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    return makeRecord("quicksort", distribution, size, controller.getTotalSteps(), bestMs, controller.getTraceMemoryBytes());
+}
+
+static BenchRecord benchAStar(const std::string& engine, AStarSearchEngine searchEngine, const std::string& distribution,
+                              int side, const BenchOptions& options) {
+    side = std::max(2, side);  // Start and goal need separate corners
+    AStarController controller;
+    controller.setLazyGeneration(false);
+    if (options.keyframeInterval > 0) controller.setKeyframeInterval(options.keyframeInterval);
+    controller.setOpenListKind(options.openList);
+    controller.setSearchEngine(searchEngine);
+    controller.setNeighborhood(options.neighborhood);
+    controller.setHeuristic(options.heuristic);
+    controller.setTieBreak(options.tieBreak);
+    controller.initialize(side, side, 0, 0, side - 1, side - 1);
+    controller.setWalls(makeGridWalls(distribution, side, options.seed));
+    if (options.terrain > 1) {
+        controller.generateTerrain(options.seed, options.terrain);
+    }
+    
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        auto start = std::chrono::steady_clock::now();
+        controller.reset();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    std::string recordDistribution = options.terrain > 1 ? distribution + "+terrain" + std::to_string(options.terrain) : distribution;
+    BenchRecord record = makeRecord(engine, recordDistribution, side, controller.getTotalSteps(), bestMs,
+                                    controller.getTraceMemoryBytes());
+    record.counters = controller.getSearchCounters();
+    if (options.heuristic == AStarHeuristic::LANDMARKS) {
+        record.buildMs = controller.getLandmarkStats().buildMs;   // Tables are built by the first run only
+    }
+    return record;
+}
+
+static BenchRecord benchHierarchical(const std::string& distribution, int side, const BenchOptions& options) {
+    // No trace and no controller grids, so maps of millions of cells fit
+    side = std::max(2, side);
+    HierarchicalPathfinder pathfinder;
+    pathfinder.initialize(side, side, options.sectorSize);
+    int startIndex = 0;
+    int goalIndex = side * side - 1;
+    for (const auto& wall : makeGridWalls(distribution, side, options.seed)) {
+        int cellIndex = wall.second * side + wall.first;
+        if (cellIndex != startIndex && cellIndex != goalIndex) {
+            pathfinder.setBlocked(cellIndex, true);
+        }
+    }
+    pathfinder.rebuildDirtySectors();
+    double buildMs = pathfinder.getStats().rebuildMs;
+    
+    // Same corner-to-corner query as the A* records
+    std::vector<int> path;
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        auto start = std::chrono::steady_clock::now();
+        pathfinder.findPath(startIndex, goalIndex, path);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    BenchRecord record = makeRecord("hpa", distribution, side, path.size(), bestMs, 0);
+    record.counters.expansions = pathfinder.getStats().abstractExpansions + pathfinder.getStats().refineExpansions;
+    record.buildMs = buildMs;
+    return record;
+}
+
+static BenchRecord benchBatch(const std::string& distribution, int side, const BenchOptions& options) {
+    side = std::max(2, side);
+    AStarGrid grid;
+    grid.resize(side, side);
+    for (const auto& wall : makeGridWalls(distribution, side, options.seed)) {
+        grid.types[grid.index(wall.first, wall.second)] = CellType::WALL;
+    }
+    
+    // Random pairs of open cells; unreachable pairs stay in, agents ask those too
+    std::vector<int> openCells;
+    for (int i = 0; i < grid.size(); i++) {
+        if (grid.types[i] != CellType::WALL) openCells.push_back(i);
+    }
+    std::vector<PathQuery> queries;
+    std::mt19937 rng(options.seed + 1);
+    for (int i = 0; i < options.queryCount && !openCells.empty(); i++) {
+        queries.push_back({openCells[rng() % openCells.size()], openCells[rng() % openCells.size()]});
+    }
+    
+    BatchPathSolver solver(options.threads);
+    solver.setNeighborhood(options.neighborhood);
+    solver.setHeuristic(options.heuristic);
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        solver.solveBatch(grid, queries);
+        double ms = solver.getLastStats().wallMs;
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    // One step per query, so steps_per_sec is queries per second
+    BenchRecord record = makeRecord("batch-" + std::to_string(solver.getThreadCount()) + "t", distribution, side,
+                                    queries.size(), bestMs, 0);
+    record.counters.expansions = solver.getLastStats().expansions;
+    return record;
+}
+
+static BenchRecord benchBitBfs(const std::string& distribution, int side, const BenchOptions& options) {
+    side = std::max(2, side);
+    BitParallelBfs bfs;
+    bfs.initialize(side, side);
+    for (const auto& wall : makeGridWalls(distribution, side, options.seed)) {
+        int cellIndex = wall.second * side + wall.first;
+        if (cellIndex != 0) bfs.setBlocked(cellIndex, true);
+    }
+    
+    // Full distance field from the start corner plus the path to the far one
+    std::vector<int> path;
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        auto start = std::chrono::steady_clock::now();
+        bfs.computeDistanceField(0);
+        bfs.extractPath(side * side - 1, path);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    // Steps are cells given a distance; expansions count 64-cell word updates
+    BenchRecord record = makeRecord("bfs", distribution, side, bfs.getStats().reachedCells, bestMs, 0);
+    record.counters.expansions = bfs.getStats().wordOps;
+    return record;
+}
+
+static BenchRecord benchCrowd(const std::string& distribution, int side, int agentCount, const BenchOptions& options) {
+    side = std::max(2, side);
+    int goalIndex = side * side - 1;
+    FlowField field;
+    field.initialize(side, side, options.neighborhood == AStarNeighborhood::EIGHT);
+    for (const auto& wall : makeGridWalls(distribution, side, options.seed)) {
+        int cellIndex = wall.second * side + wall.first;
+        if (cellIndex != goalIndex) field.setBlocked(cellIndex, true);
+    }
+    field.build(goalIndex);
+    
+    // One second of 60 Hz ticks; every run restarts from the same spawn
+    const int tickCount = 60;
+    CrowdSimulation crowd;
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        crowd.spawn(field, agentCount, options.seed);
+        double ms = 0.0;
+        for (int tick = 0; tick < tickCount; tick++) {
+            crowd.update(field, 1.0f / 60.0f);
+            ms += crowd.getLastTick().tickMs;
+        }
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    // Steps are agent updates; the field is built once, up front
+    BenchRecord record = makeRecord("crowd-" + std::to_string(agentCount), distribution, side,
+                                    static_cast<size_t>(agentCount) * tickCount, bestMs, 0);
+    record.counters.expansions = field.getStats().reachedCells;
+    record.buildMs = field.getStats().buildMs;
+    return record;
+}
+
+static BenchRecord benchCooperative(const std::string& distribution, int side, int agentCount, const BenchOptions& options) {
+    side = std::max(2, side);
+    CooperativePathfinder pathfinder;
+    pathfinder.initialize(side, side, options.window);
+    std::vector<int> openCells;
+    std::vector<std::uint8_t> walls(static_cast<size_t>(side) * side, 0);
+    for (const auto& wall : makeGridWalls(distribution, side, options.seed)) {
+        walls[wall.second * side + wall.first] = 1;
+    }
+    for (int i = 0; i < side * side; i++) {
+        if (walls[i]) pathfinder.setBlocked(i, true);
+        else openCells.push_back(i);
+    }
+    
+    // Distinct starts, distinct goals; agents may be asked to cross the whole map
+    agentCount = std::min<int>(agentCount, static_cast<int>(openCells.size()));
+    std::mt19937 rng(options.seed + 1);
+    std::shuffle(openCells.begin(), openCells.end(), rng);
+    std::vector<int> starts(openCells.begin(), openCells.begin() + agentCount);
+    std::shuffle(openCells.begin(), openCells.end(), rng);
+    
+    // A few rolling windows, executing half of each, as the planner is meant to run
+    const int windowCount = 4;
+    double bestMs = 0.0;
+    long long expansions = 0;
+    for (int run = 0; run < options.repeat; run++) {
+        pathfinder.clearAgents();
+        for (int i = 0; i < agentCount; i++) {
+            pathfinder.addAgent(starts[i], openCells[i]);
+        }
+        double ms = 0.0;
+        expansions = 0;
+        for (int window = 0; window < windowCount; window++) {
+            pathfinder.planWindow();
+            ms += pathfinder.getStats().wallMs;
+            expansions += pathfinder.getStats().expansions;
+            pathfinder.advance(options.window / 2);
+        }
+        if (run == 0 || ms < bestMs) bestMs = ms;
+    }
+    
+    // Steps are agent plans, so steps_per_sec is agents planned per second
+    BenchRecord record = makeRecord("coop-" + std::to_string(agentCount), distribution, side,
+                                    static_cast<size_t>(agentCount) * windowCount, bestMs, 0);
+    record.counters.expansions = expansions;
+    return record;
+}
+
+// Untraced parallel sort of random input, serially and then at 1, 2, 4 and
+// every hardware thread. One record per run; steps are the element count.
+static void benchParallelSort(int size, PartitionKernel kernel, const BenchOptions& options, std::vector<BenchRecord>& records) {
+    std::vector<int> threadCounts = {1, 2, 4};
+    int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (hardwareThreads > 4) threadCounts.push_back(hardwareThreads);
+    
+    std::vector<ParallelScalingResult> best;
+    for (int run = 0; run < options.repeat; run++) {
+        auto results = ParallelQuicksort::measureScaling(size, threadCounts, options.seed, kernel);
+        if (best.empty()) {
+            best = results;
+            continue;
+        }
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i].milliseconds < best[i].milliseconds) best[i] = results[i];
+        }
+    }
+    
+    std::string kernelName = getPartitionKernelName(kernel);
+    std::transform(kernelName.begin(), kernelName.end(), kernelName.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (kernel == PartitionKernel::AVX2 && !isPartitionKernelSupported(kernel)) {
+        kernelName += "-fallback";   // Runs the block kernel
+    }
+    for (const auto& result : best) {
+        std::string threads = result.threadCount == 0 ? "serial" : std::to_string(result.threadCount) + "t";
+        std::string engine = "psort-" + kernelName + "-" + threads;
+        records.push_back(makeRecord(engine, "random", size, static_cast<size_t>(size), result.milliseconds, 0));
+    }
+}
+
+static BenchRecord benchMapGenerator(const std::string& name, MapGeneratorKind kind, int side, const BenchOptions& options) {
+    side = std::max(2, side);
+    MapGenerator generator;
+    std::vector<std::uint8_t> walls;
+    double bestMs = 0.0;
+    for (int run = 0; run < options.repeat; run++) {
+        generator.generate(kind, side, side, options.seed, MapGenerator::getDefaultDensity(kind), {0, side * side - 1}, walls);
+        if (run == 0 || generator.getLastMs() < bestMs) bestMs = generator.getLastMs();
+    }
+    
+    // Steps are cells, so steps_per_sec is cells generated per second; expansions count the walls
+    BenchRecord record = makeRecord("mapgen", name, side, walls.size(), bestMs, 0);
+    record.counters.expansions = std::count(walls.begin(), walls.end(), 1);
+    return record;
+}
+
+// Exact distances to the goal in double precision: straight steps 1, diagonals
+// sqrt 2 without cutting wall corners, the same moves D* Lite makes
+static std::vector<double> referenceDistances(const std::vector<std::uint8_t>& blocked, const std::vector<std::uint8_t>& weights,
+                                              int side, int goalIndex, bool diagonal) {
+    static const int DX[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+    static const int DY[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    std::vector<double> distance(blocked.size(), INFINITY);
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> open;
+    distance[goalIndex] = 0.0;
+    open.push({0.0, goalIndex});
+    while (!open.empty()) {
+        auto [cost, cell] = open.top();
+        open.pop();
+        if (cost > distance[cell]) continue;
+        int x = cell % side;
+        int y = cell / side;
+        for (int direction = 0; direction < (diagonal ? 8 : 4); direction++) {
+            int nx = x + DX[direction];
+            int ny = y + DY[direction];
+            if (nx < 0 || nx >= side || ny < 0 || ny >= side || blocked[ny * side + nx]) continue;
+            if (direction >= 4 && (blocked[y * side + nx] || blocked[ny * side + x])) continue;
+            // Backwards from the goal, so the move enters the cell being relaxed from
+            double next = cost + (direction >= 4 ? std::sqrt(2.0) : 1.0) * weights[cell];
+            if (next < distance[ny * side + nx]) {
+                distance[ny * side + nx] = next;
+                open.push({next, ny * side + nx});
+            }
+        }
+    }
+    return distance;
+}
+
+// Regression for D* Lite repairs: the start walks diagonally toward the goal
+// while random cells flip, and after every repair the extracted path must be
+// a legal walk from start to goal whose length matches a fresh Dijkstra.
+// With --terrain the cells carry noise weights, as in the A* engines
+static BenchRecord benchDStarCheck(const std::string& distribution, int side, bool diagonal, const BenchOptions& options) {
+    side = std::max(2, side);
+    int goalIndex = side * side - 1;
+    std::vector<std::uint8_t> blocked(side * side, 0);
+    std::vector<std::uint8_t> weights(side * side, 1);
+    DStarLite planner;
+    planner.initialize(side, side, 0, goalIndex, diagonal);
+    if (options.terrain > 1) {
+        MapGenerator generator;
+        generator.generateTerrain(side, side, options.seed, options.terrain, weights);
+        for (int i = 0; i < side * side; i++) {
+            planner.setWeight(i, weights[i]);
+        }
+    }
+    for (const auto& wall : makeGridWalls(distribution, side, options.seed)) {
+        int cellIndex = wall.second * side + wall.first;
+        if (cellIndex == 0 || cellIndex == goalIndex) continue;
+        blocked[cellIndex] = 1;
+        planner.setBlocked(cellIndex, true);
+    }
+    
+    std::mt19937 rng(options.seed + 2);
+    int start = 0;
+    int mismatches = 0;
+    double totalMs = 0.0;
+    std::vector<int> path;
+    for (int edit = 0; edit < options.queryCount; edit++) {
+        // One diagonal step, back to the corner at the far edge
+        int next = start % side < side - 2 && start / side < side - 2 ? start + side + 1 : 0;
+        if (!blocked[next] && next != goalIndex) {
+            start = next;
+            planner.setStart(start);
+        }
+        // Flips near the start change its route; far ones mostly do not
+        int flipX = std::max(0, std::min(side - 1, start % side + static_cast<int>(rng() % 9) - 4));
+        int flipY = std::max(0, std::min(side - 1, start / side + static_cast<int>(rng() % 9) - 4));
+        int cellIndex = flipY * side + flipX;
+        if (cellIndex != start && cellIndex != goalIndex) {
+            blocked[cellIndex] ^= 1;
+            planner.setBlocked(cellIndex, blocked[cellIndex] != 0);
+        }
+        
+        auto begin = std::chrono::steady_clock::now();
+        planner.computeShortestPath();
+        planner.extractPath(path);
+        auto end = std::chrono::steady_clock::now();
+        totalMs += std::chrono::duration<double, std::milli>(end - begin).count();
+        
+        double expected = referenceDistances(blocked, weights, side, goalIndex, diagonal)[start];
+        bool legal = !path.empty() && path.front() == start && path.back() == goalIndex;
+        double length = 0.0;
+        for (size_t i = 1; legal && i < path.size(); i++) {
+            int dx = std::abs(path[i] % side - path[i - 1] % side);
+            int dy = std::abs(path[i] / side - path[i - 1] / side);
+            bool corner = dx == 1 && dy == 1 &&
+                          (blocked[path[i - 1] / side * side + path[i] % side] || blocked[path[i] / side * side + path[i - 1] % side]);
+            legal = !blocked[path[i]] && dx <= 1 && dy <= 1 && dx + dy > 0 && (diagonal || dx + dy == 1) && !corner;
+            length += (dx + dy == 2 ? std::sqrt(2.0) : 1.0) * weights[path[i]];
+        }
+        bool matches = std::isinf(expected) ? path.empty() : legal && std::fabs(length - expected) < 1e-9;
+        if (!matches) mismatches++;
+    }
+    
+    // One step per repair, so steps_per_sec is repairs per second
+    std::string recordDistribution = options.terrain > 1 ? distribution + "+terrain" + std::to_string(options.terrain) : distribution;
+    BenchRecord record = makeRecord(diagonal ? "dstar-8" : "dstar-4", recordDistribution, side, options.queryCount, totalMs, 0);
+    record.counters.expansions = planner.getCounters().totalExpansions;
+    record.mismatches = mismatches;
+    return record;
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    // Nearest rank
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(1, rank)) - 1];
+}
+
+static bool benchScenarios(const BenchOptions& options, std::vector<BenchRecord>& records) {
+    if (options.mapPath.empty() || options.scenPath.empty()) {
+        std::cerr << "The scen engine needs --map and --scen\n";
+        return false;
+    }
+    MovingAiLoader loader;
+    AStarGrid grid;
+    std::vector<MovingAiScenario> scenarios;
+    auto loadBegin = std::chrono::steady_clock::now();
+    if (!loader.loadMap(options.mapPath, grid) || !loader.loadScenarios(options.scenPath, grid, scenarios)) {
+        std::cerr << loader.getError() << "\n";
+        return false;
+    }
+    auto loadEnd = std::chrono::steady_clock::now();
+    double loadMs = std::chrono::duration<double, std::milli>(loadEnd - loadBegin).count();
+    
+    // The reference optima are octile lengths without corner cutting, so the
+    // runner always searches that way, whatever --connectivity says
+    std::vector<PathQuery> queries;
+    for (const auto& scenario : scenarios) {
+        queries.push_back({scenario.startIndex, scenario.goalIndex});
+    }
+    BatchPathSolver solver(options.threads);
+    solver.setNeighborhood(AStarNeighborhood::EIGHT);
+    solver.setHeuristic(AStarHeuristic::OCTILE);
+    std::vector<PathQueryResult> results;
+    std::vector<double> bestUs(queries.size(), 0.0);
+    for (int run = 0; run < options.repeat; run++) {
+        results = solver.solveBatch(grid, queries);
+        for (size_t i = 0; i < results.size(); i++) {
+            if (run == 0 || results[i].runtimeUs < bestUs[i]) bestUs[i] = results[i].runtimeUs;
+        }
+    }
+    
+    // Lengths are recounted from the moves in double, so float rounding over a
+    // long path cannot pass for a suboptimal one or hide it
+    std::vector<std::uint8_t> mismatched(queries.size(), 0);
+    for (size_t i = 0; i < results.size(); i++) {
+        const std::vector<int>& path = results[i].path;
+        if (path.empty()) {
+            mismatched[i] = 1;
+            continue;
+        }
+        int straight = 0;
+        int diagonal = 0;
+        for (size_t step = 1; step < path.size(); step++) {
+            bool movesX = grid.toX(path[step]) != grid.toX(path[step - 1]);
+            bool movesY = grid.toY(path[step]) != grid.toY(path[step - 1]);
+            if (movesX && movesY) diagonal++;
+            else straight++;
+        }
+        double length = straight + diagonal * std::sqrt(2.0);
+        mismatched[i] = std::fabs(length - scenarios[i].optimalLength) > 1e-4 ? 1 : 0;
+    }
+    
+    std::string mapName = options.mapPath.substr(options.mapPath.find_last_of("/\\") + 1);
+    auto summarize = [&](const std::string& engine, const std::vector<size_t>& members) {
+        std::vector<double> latencies;
+        double totalUs = 0.0;
+        long long expansions = 0;
+        long long heapPushes = 0;
+        int mismatches = 0;
+        for (size_t i : members) {
+            latencies.push_back(bestUs[i]);
+            totalUs += bestUs[i];
+            expansions += results[i].expansions;
+            heapPushes += results[i].heapPushes;
+            mismatches += mismatched[i];
+        }
+        std::sort(latencies.begin(), latencies.end());
+        
+        // One step per scenario, so steps_per_sec is queries per second
+        BenchRecord record = makeRecord(engine, mapName, grid.width, members.size(), totalUs / 1000.0, 0);
+        record.counters.expansions = expansions;
+        record.counters.heapPushes = heapPushes;
+        record.buildMs = loadMs;
+        record.mismatches = mismatches;
+        record.usPerQuery = members.empty() ? 0.0 : totalUs / members.size();
+        record.p50Us = percentile(latencies, 0.50);
+        record.p95Us = percentile(latencies, 0.95);
+        record.p99Us = percentile(latencies, 0.99);
+        record.expansionsPerSecond = totalUs > 0.0 ? expansions / (totalUs / 1e6) : 0.0;
+        records.push_back(record);
+    };
+    
+    std::map<int, std::vector<size_t>> buckets;
+    std::vector<size_t> everyScenario;
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        buckets[scenarios[i].bucket].push_back(i);
+        everyScenario.push_back(i);
+    }
+    for (const auto& bucket : buckets) {
+        summarize("scen-b" + std::to_string(bucket.first), bucket.second);
+    }
+    summarize("scen", everyScenario);
+    return true;
+}
+
+static void printRecords(const std::vector<BenchRecord>& records, const std::string& format) {
+    if (format == "json") {
+        std::cout << "[\n";
+        for (size_t i = 0; i < records.size(); i++) {
+            const BenchRecord& r = records[i];
+            std::cout << "  {\"engine\": \"" << r.engine << "\", \"distribution\": \"" << r.distribution
+                      << "\", \"size\": " << r.size << ", \"steps\": " << r.steps
+                      << ", \"wall_ms\": " << r.wallMs << ", \"steps_per_sec\": " << r.stepsPerSecond
+                      << ", \"bytes_per_step\": " << r.bytesPerStep << ", \"peak_rss_kb\": " << r.peakRssKb
+                      << ", \"expansions\": " << r.counters.expansions << ", \"heap_pushes\": " << r.counters.heapPushes << ", \"heap_pops\": " << r.counters.heapPops
+                      << ", \"decrease_keys\": " << r.counters.decreaseKeys << ", \"stale_pops\": " << r.counters.stalePops
+                      << ", \"build_ms\": " << r.buildMs << ", \"mismatches\": " << r.mismatches
+                      << ", \"us_per_query\": " << r.usPerQuery << ", \"p50_us\": " << r.p50Us << ", \"p95_us\": " << r.p95Us
+                      << ", \"p99_us\": " << r.p99Us << ", \"expansions_per_sec\": " << r.expansionsPerSecond << "}"
+                      << (i + 1 < records.size() ? ",\n" : "\n");
+        }
+        std::cout << "]\n";
+        return;
+    }
+    
+    std::cout << "engine,distribution,size,steps,wall_ms,steps_per_sec,bytes_per_step,peak_rss_kb,"
+              << "expansions,heap_pushes,heap_pops,decrease_keys,stale_pops,build_ms,"
+              << "mismatches,us_per_query,p50_us,p95_us,p99_us,expansions_per_sec\n";
+    for (const auto& r : records) {
+        std::cout << r.engine << "," << r.distribution << "," << r.size << "," << r.steps << ","
+                  << r.wallMs << "," << r.stepsPerSecond << "," << r.bytesPerStep << "," << r.peakRssKb << ","
+                  << r.counters.expansions << "," << r.counters.heapPushes << "," << r.counters.heapPops << "," << r.counters.decreaseKeys << ","
+                  << r.counters.stalePops << "," << r.buildMs << "," << r.mismatches << "," << r.usPerQuery << ","
+                  << r.p50Us << "," << r.p95Us << "," << r.p99Us << "," << r.expansionsPerSecond << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+    
+    // Sizes run in ascending order so the peak RSS column grows with the workload
+    std::sort(options.sortSizes.begin(), options.sortSizes.end());
+    std::sort(options.gridSizes.begin(), options.gridSizes.end());
+    
+    std::vector<BenchRecord> records;
+    for (const auto& engine : options.engines) {
+        if (engine == "quicksort") {
+            for (int size : options.sortSizes) {
+                for (const auto& distribution : options.sortDistributions) {
+                    records.push_back(benchQuicksort(distribution, size, options));
+                }
+            }
+        } else if (engine == "psort") {
+            for (int size : options.sortSizes) {
+                for (PartitionKernel kernel : options.kernels) {
+                    benchParallelSort(size, kernel, options, records);
+                }
+            }
+        } else if (engine == "astar" || engine == "jps" || engine == "jps-plus") {
+            AStarSearchEngine searchEngine = engine == "jps" ? AStarSearchEngine::JPS :
+                                             engine == "jps-plus" ? AStarSearchEngine::JPS_PLUS : AStarSearchEngine::ASTAR;
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    records.push_back(benchAStar(engine, searchEngine, distribution, side, options));
+                }
+            }
+        } else if (engine == "batch") {
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    records.push_back(benchBatch(distribution, side, options));
+                }
+            }
+        } else if (engine == "coop") {
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    for (int agentCount : options.agentCounts) {
+                        records.push_back(benchCooperative(distribution, side, agentCount, options));
+                    }
+                }
+            }
+        } else if (engine == "crowd") {
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    for (int agentCount : options.agentCounts) {
+                        records.push_back(benchCrowd(distribution, side, agentCount, options));
+                    }
+                }
+            }
+        } else if (engine == "bfs") {
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    records.push_back(benchBitBfs(distribution, side, options));
+                }
+            }
+        } else if (engine == "hpa") {
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    records.push_back(benchHierarchical(distribution, side, options));
+                }
+            }
+        } else if (engine == "mapgen") {
+            for (int side : options.gridSizes) {
+                for (int i = 0; i < 6; i++) {
+                    records.push_back(benchMapGenerator(MAP_KIND_NAMES[i], static_cast<MapGeneratorKind>(i), side, options));
+                }
+            }
+        } else if (engine == "dstar") {
+            for (int side : options.gridSizes) {
+                for (const auto& distribution : options.gridDistributions) {
+                    records.push_back(benchDStarCheck(distribution, side, false, options));
+                    records.push_back(benchDStarCheck(distribution, side, true, options));
+                }
+            }
+        } else if (engine == "scen") {
+            if (!benchScenarios(options, records)) return 1;
+        } else {
+            std::cerr << "Unknown engine " << engine << "\n";
+            return 1;
+        }
+    }
+    
+    printRecords(records, options.format);
+    
+    // A scenario or D* Lite repair off its reference optimum fails the run, for regression scripts
+    for (const auto& record : records) {
+        if (record.mismatches > 0) return 2;
+    }
+    return 0;
+}
\ No newline at end of file
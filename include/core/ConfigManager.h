@@ -16,6 +16,8 @@ struct SimulationSettings {
     int defaultArraySize = 50;
     int minArraySize = 10;
     int maxArraySize = 100;
+    bool lazyStepGeneration = false;  // Produce trace steps on demand instead of up front
+    int stepHistoryLimit = 4096;      // Steps kept behind the frontier in lazy mode (0 = all)
 };
 
 struct ThemeSettings {
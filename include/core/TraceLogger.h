@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class TraceLevel : std::uint8_t {
+    DEBUG = 0,
+    INFO = 1,
+    WARN = 2
+};
+
+// Lowest level that is compiled in (0 = DEBUG, 1 = INFO, 2 = WARN, 3 = none).
+// Release builds drop DEBUG and INFO entirely; define SIM_TRACE_MIN_LEVEL to override.
+#ifndef SIM_TRACE_MIN_LEVEL
+#ifdef NDEBUG
+#define SIM_TRACE_MIN_LEVEL 2
+#else
+#define SIM_TRACE_MIN_LEVEL 0
+#endif
+#endif
+
+// In-memory trace log. Writers claim a slot in a fixed ring with a single
+// atomic increment and store the format pointer plus raw integer arguments;
+// nothing is formatted or written to disk until dumpTrace() is called.
+// Older entries are overwritten once the ring wraps; a slot torn between two
+// writers a full lap apart is skipped by the reader rather than printed.
+class TraceLogger {
+public:
+    static constexpr size_t CAPACITY = 8192;  // Must be a power of two
+    static constexpr size_t MAX_ARGS = 4;
+    
+    static TraceLogger& instance();
+    
+    // format must be a string literal; each "{}" is replaced by the next argument
+    void log(TraceLevel level, const char* format);
+    template <typename... Args>
+    void log(TraceLevel level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many trace arguments");
+        const std::int64_t values[] = { static_cast<std::int64_t>(args)... };
+        write(level, format, values, sizeof...(Args));
+    }
+    
+    // Formats the retained entries oldest first. Returns false if the file can't be opened.
+    bool dumpTrace(const std::string& path) const;
+    void clear();
+    
+    size_t getEntryCount() const;
+    
+private:
+    struct Entry {
+        // Odd while a writer is filling the slot, 2 * (index + 1) once published
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<const char*> format{nullptr};
+        std::atomic<std::int64_t> args[MAX_ARGS] = {};
+        std::atomic<std::uint8_t> argCount{0};
+        std::atomic<TraceLevel> level{TraceLevel::DEBUG};
+    };
+    
+    TraceLogger() = default;
+    TraceLogger(const TraceLogger&) = delete;
+    TraceLogger& operator=(const TraceLogger&) = delete;
+    
+    void write(TraceLevel level, const char* format, const std::int64_t* args, size_t argCount);
+    
+    Entry m_entries[CAPACITY];
+    std::atomic<std::uint64_t> m_writeIndex{0};
+};
+
+#define SIM_TRACE_AT(level, ...) TraceLogger::instance().log(level, __VA_ARGS__)
+
+#if SIM_TRACE_MIN_LEVEL <= 0
+#define SIM_TRACE_DEBUG(...) SIM_TRACE_AT(TraceLevel::DEBUG, __VA_ARGS__)
+#else
+#define SIM_TRACE_DEBUG(...) do {} while (0)
+#endif
+
+#if SIM_TRACE_MIN_LEVEL <= 1
+#define SIM_TRACE_INFO(...) SIM_TRACE_AT(TraceLevel::INFO, __VA_ARGS__)
+#else
+#define SIM_TRACE_INFO(...) do {} while (0)
+#endif
+
+#if SIM_TRACE_MIN_LEVEL <= 2
+#define SIM_TRACE_WARN(...) SIM_TRACE_AT(TraceLevel::WARN, __VA_ARGS__)
+#else
+#define SIM_TRACE_WARN(...) do {} while (0)
+#endif
\ No newline at end of file
@@ -1,9 +1,19 @@
 #pragma once
+#include "IndexedHeap.h"
+#include "BucketQueue.h"
+#include "DStarLite.h"
+#include "HierarchicalPathfinder.h"
+#include "BitParallelBfs.h"
+#include "FlowField.h"
+#include "LandmarkTable.h"
+#include "MapGenerator.h"
+#include <algorithm>
 #include <vector>
 #include <functional>
 #include <string>
 #include <queue>
-#include <unordered_set>
+#include <deque>
+#include <cstdint>
 
 enum class AStarState {
     READY,
@@ -13,7 +23,7 @@ enum class AStarState {
     NO_PATH_EXISTS
 };
 
-enum class CellType {
+enum class CellType : std::uint8_t {
     EMPTY,
     WALL,
     START,
@@ -23,43 +33,159 @@ enum class CellType {
     PATH
 };
 
-struct GridCell {
-    int x, y;
-    CellType type;
-    float gCost;    // Distance from start
-    float hCost;    // Heuristic distance to goal
-    float fCost;    // gCost + hCost
-    int parentX, parentY;  // Store parent coordinates instead of pointer
-    bool hasParent;
-    
-    GridCell() : x(0), y(0), type(CellType::EMPTY), gCost(0), hCost(0), fCost(0), parentX(-1), parentY(-1), hasParent(false) {}
-    GridCell(int x_, int y_) : x(x_), y(y_), type(CellType::EMPTY), gCost(0), hCost(0), fCost(0), parentX(-1), parentY(-1), hasParent(false) {}
+// Structure-of-arrays grid in one row-major layout: cell (x, y) is element
+// y * width + x of every array. Copies and scans touch a few contiguous
+// buffers instead of one heap allocation per row.
+struct AStarGrid {
+    int width;
+    int height;
+    std::vector<CellType> types;
+    std::vector<std::uint8_t> weights;   // Cost multiplier for entering the cell, 1 (road) and up
+    std::vector<float> gCost;            // Distance from start
+    std::vector<float> hCost;            // Heuristic distance to goal
+    std::vector<float> fCost;            // gCost + hCost
+    std::vector<std::int32_t> parent;    // Linear index of the parent cell, -1 if none
+    
+    AStarGrid() : width(0), height(0) {}
+    
+    void resize(int gridWidth, int gridHeight);
+    bool empty() const { return types.empty(); }
+    int size() const { return width * height; }
+    int index(int x, int y) const { return y * width + x; }
+    int toX(int cellIndex) const { return cellIndex % width; }
+    int toY(int cellIndex) const { return cellIndex / width; }
+    bool inBounds(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    size_t getMemoryBytes() const;
+};
+
+// What a step shows; the HUD text is formatted from it on demand
+enum class AStarStepKind {
+    START,
+    START_OPENED,
+    EXAMINE,
+    BUILD_PATH,
+    PATH_FOUND,
+    NO_PATH
+};
+
+enum class AStarOpenListKind {
+    INDEXED_HEAP,   // 4-ary heap with decrease-key, one entry per open cell
+    LAZY_HEAP,      // Binary heap that re-pushes improved cells and skips stale entries on pop
+    BUCKET_QUEUE    // Dial's buckets over integer f; the indexed heap stands in when f can be fractional
+};
+
+// Which successors an expansion generates
+enum class AStarSearchEngine {
+    ASTAR,      // Every walkable neighbor
+    JPS,        // Jump Point Search: scans straight lines and only opens jump points
+    JPS_PLUS    // JPS reading jump distances precomputed from the walls
+};
+
+// Which planner keeps the planned path overlay up to date across edits
+enum class AStarPlannerKind {
+    INCREMENTAL,    // D* Lite: optimal, repairs only what an edit invalidated
+    HIERARCHICAL    // HPA*: near-optimal, rebuilds only the edited sectors; 4-connected
 };
 
+enum class AStarNeighborhood {
+    FOUR,     // Straight moves only
+    EIGHT     // Adds diagonals costing sqrt 2; never cuts a wall corner
+};
+
+enum class AStarHeuristic {
+    MANHATTAN,
+    OCTILE,
+    EUCLIDEAN,
+    CHEBYSHEV,
+    ZERO,      // Dijkstra
+    LANDMARKS  // ALT: exact distances to a few landmarks bound the rest by the triangle inequality
+};
+
+// How cells with equal f leave the open list
+enum class AStarTieBreak {
+    HEAP_ORDER,   // Whatever the heap yields
+    LOW_H,        // Closest to the goal first, tends to dive straight in
+    LOW_G         // Closest to the start first
+};
+
+// One engine's run over the current map, for side-by-side comparison
+struct AStarEngineResult {
+    AStarSearchEngine engine;
+    long long expansions;
+    double runtimeMs;      // Best of the repetitions, trace recording included
+    int pathLength;        // Moves from start to goal, -1 when unreachable
+};
+
+// Open-list work done by the search generated so far
+struct AStarSearchCounters {
+    long long expansions = 0;
+    long long heapPushes = 0;
+    long long heapPops = 0;
+    long long decreaseKeys = 0;
+    long long stalePops = 0;   // Popped entries whose cell was already closed (lazy heap only)
+};
+
+// One cell's state before and after a step, so the step can be replayed or undone
+struct AStarCellChange {
+    std::int32_t index;
+    CellType oldType;
+    CellType newType;
+    std::int32_t oldParent;
+    std::int32_t newParent;
+    float oldG, newG;
+    float oldH, newH;
+    float oldF, newF;
+};
+
+// Steps are delta-encoded: only the cells the step touched are stored, and
+// the controller applies or reverts them against m_currentGrid in O(changes)
 struct AStarStep {
-    std::vector<std::vector<GridCell>> grid;
+    AStarStepKind kind;
+    std::vector<AStarCellChange> changes;
     int currentX, currentY;
     bool hasCurrentCell;
-    std::string description;
     int stepCount;
     int openListSize;
     int closedListSize;
-    std::vector<std::pair<int, int>> path;  // Store the final path
+};
+
+// Grid snapshot taken every getKeyframeSpacing() steps so seek() only has to
+// replay a bounded number of deltas
+struct AStarKeyframe {
+    size_t stepIndex;   // Grid before this step is applied
+    AStarGrid grid;
 };
 
 class AStarController {
 public:
+    // Heaviest terrain; mud at 5 already makes most paths detour
+    static constexpr int MAX_CELL_WEIGHT = 9;
+    
     AStarController();
     ~AStarController();
     
     void initialize(int gridWidth, int gridHeight, int startX, int startY, int goalX, int goalY);
+    void initialize(const AStarGrid& walls, int startX, int startY, int goalX, int goalY);  // Walls of a loaded map, one search
     void setWall(int x, int y);
     void clearWall(int x, int y);
     void toggleWall(int x, int y);
+    void setWalls(const std::vector<std::pair<int, int>>& cells);  // Regenerates once for the whole set
     void setStart(int x, int y);
     void setGoal(int x, int y);
     void clearGrid();
-    void generateRandomMaze(float wallDensity = 0.3f);
+    void generateRandomMaze(float wallDensity = 0.3f);  // Random fill with the seed after the last map's
+    void generateMap(MapGeneratorKind kind, std::uint64_t seed, float wallDensity);  // One bulk write, one search
+    void setCellWeight(int x, int y, int weight);   // Clamped to [1, MAX_CELL_WEIGHT]
+    void setWeights(const std::vector<std::uint8_t>& weights);   // Every cell at once; regenerates once
+    void generateTerrain(std::uint64_t seed, int maxWeight);   // Noise weights from 1 to maxWeight
+    void clearWeights();
+    
+    // Edits between beginEdit() and the matching commitEdit() update the grid
+    // immediately but share one plan repair and trace reset at commit
+    void beginEdit();
+    void commitEdit();
+    bool isEditing() const { return m_editDepth > 0; }
+    
     void start();
     void pause();
     void resume();
@@ -69,12 +195,23 @@ public:
     void fastForward();
     void slowDown();
     void speedUp();
+    void seek(size_t stepIndex);
     
     void setSpeed(float delayMs);
+    void setKeyframeInterval(size_t interval);
+    void setLazyGeneration(bool lazy);
+    void setHistoryLimit(size_t steps);
+    void setOpenListKind(AStarOpenListKind kind);
+    void setSearchEngine(AStarSearchEngine engine);
+    void setNeighborhood(AStarNeighborhood neighborhood);  // JPS engines stay 4-connected
+    void setHeuristic(AStarHeuristic heuristic);
+    void setTieBreak(AStarTieBreak tieBreak);
+    void setPlannerKind(AStarPlannerKind kind);
     void setStepCallback(std::function<void(const AStarStep&)> callback);
     
     AStarState getState() const { return m_state; }
-    const std::vector<std::vector<GridCell>>& getCurrentGrid() const { return m_currentGrid; }
+    const AStarGrid& getCurrentGrid() const { return m_currentGrid; }
+    const AStarGrid& getOriginalGrid() const { return m_originalGrid; }   // Walls, start and goal only
     int getGridWidth() const { return m_gridWidth; }
     int getGridHeight() const { return m_gridHeight; }
     int getStartX() const { return m_startX; }
@@ -82,26 +219,153 @@ public:
     int getGoalX() const { return m_goalX; }
     int getGoalY() const { return m_goalY; }
     const AStarStep& getCurrentStep() const { return m_currentStep; }
+    const std::vector<std::pair<int, int>>& getCurrentPath() const;  // Final path once the trace shows it, else empty
+    std::string getCurrentDescription() const;
     float getSpeed() const { return m_stepDelay; }
     size_t getCurrentStepIndex() const { return m_currentStepIndex; }
-    size_t getTotalSteps() const { return m_steps.size(); }
+    size_t getTotalSteps() const { return m_traceBase + m_steps.size(); }  // Steps generated so far
+    bool isTraceComplete() const { return m_searchPhase == SearchPhase::DONE; }
+    bool isLazyGeneration() const { return m_lazyGeneration; }
+    size_t getHistoryLimit() const { return m_historyLimit; }
+    size_t getKeyframeInterval() const { return m_keyframeInterval; }
+    // Never below a quarter of the cells: a snapshot then costs at most about
+    // 72 bytes per step, well under the deltas of a typical expansion
+    size_t getKeyframeSpacing() const { return std::max(m_keyframeInterval, static_cast<size_t>(m_originalGrid.size()) / 4); }
+    AStarOpenListKind getOpenListKind() const { return m_openListKind; }
+    static std::string getOpenListName(AStarOpenListKind kind);
+    bool isBucketQueueActive() const { return m_bucketSearch; }   // Off when f can be fractional
+    int getCellWeight(int x, int y) const { return m_originalGrid.weights[m_originalGrid.index(x, y)]; }
+    bool hasWeights() const { return m_weightedCellCount > 0; }
+    AStarSearchEngine getSearchEngine() const { return m_searchEngine; }
+    static std::string getSearchEngineName(AStarSearchEngine engine);
+    AStarNeighborhood getNeighborhood() const { return m_neighborhood; }
+    AStarHeuristic getHeuristic() const { return m_heuristic; }
+    AStarTieBreak getTieBreak() const { return m_tieBreak; }
+    static std::string getHeuristicName(AStarHeuristic heuristic);
+    static std::string getTieBreakName(AStarTieBreak tieBreak);
+    const AStarSearchCounters& getSearchCounters() const { return m_counters; }
     int getStepCount() const;
     int getOpenListSize() const;
     int getClosedListSize() const;
+    size_t getTraceMemoryBytes() const;  // Retained steps plus the base grid of the window
+    
+    // Plan kept consistent with every edit, independent of the trace
+    const std::vector<std::pair<int, int>>& getPlannedPath() const { return m_plannedPath; }
+    const DStarLiteCounters& getPlannerCounters() const { return m_planner.getCounters(); }
+    const HierarchicalStats& getHierarchicalStats() const { return m_hierarchical.getStats(); }
+    AStarPlannerKind getPlannerKind() const { return m_plannerKind; }
+    static std::string getPlannerName(AStarPlannerKind kind);
+    
+    // Directions toward the goal from every cell, for crowds; rebuilt on first use after an edit
+    const FlowField& getFlowField();
+    MapGeneratorKind getMapKind() const { return m_mapKind; }
+    std::uint64_t getMapSeed() const { return m_mapSeed; }
+    double getMapGenerationMs() const { return m_mapGenerator.getLastMs(); }
+    const LandmarkStats& getLandmarkStats() const { return m_landmarks.getStats(); }
+    
+    // Runs every engine on a copy of the current map; the trace on screen is untouched
+    std::vector<AStarEngineResult> measureSearchEngines(int repetitions) const;
     
     void update(float deltaTime);
     
 private:
+    // The search runs as a resumable state machine: each call to advanceSearch()
+    // performs one expansion (or one path-building step) and records exactly one step.
+    enum class SearchPhase {
+        START,
+        SEED,
+        EXPAND,
+        BUILD_PATH,
+        DONE
+    };
+    
+    // Cell reachable from the expanded cell in a straight line
+    struct Successor {
+        int index;
+        float cost;
+    };
+    
+    // Jump table directions, in FourConnected order
+    enum JumpDirection {
+        JUMP_UP,
+        JUMP_DOWN,
+        JUMP_LEFT,
+        JUMP_RIGHT,
+        JUMP_DIRECTION_COUNT
+    };
+    
+    // Open-list priority: f, then the tie-break policy's secondary key
+    struct OpenKey {
+        float fCost;
+        float tie;
+        bool operator<(const OpenKey& other) const {
+            return fCost < other.fCost || (fCost == other.fCost && tie < other.tie);
+        }
+    };
+    
+    // Lazy open list entry, keyed by linear cell index
+    struct OpenNode {
+        int index;
+        OpenKey key;
+        bool operator>(const OpenNode& other) const {
+            return other.key < key;
+        }
+    };
+    
+    // One specialization of the expansion loop, chosen once per search
+    using ExpandKernel = void (AStarController::*)(int cellIndex);
+    
+    void initializeFromOriginalGrid(int startX, int startY, int goalX, int goalY);
     void generateSteps();
-    void runAStar();
-    float calculateHeuristic(int x1, int y1, int x2, int y2);
-    std::vector<std::pair<int, int>> getNeighbors(int x, int y);
+    void regenerateIfReady();
+    void repairPlan();
+    void setPlannerBlocked(int cellIndex, bool blocked);
+    void writeWeight(int cellIndex, int weight);
+    void commitChange();
+    void resetSearch();
+    bool advanceSearch();
+    void pushOpenNode(int cellIndex, OpenKey key);
+    bool popOpenNode(int& cellIndex);
+    bool isOpen(int cellIndex) const { return m_openStamp[cellIndex] == m_searchGeneration; }
+    bool isClosed(int cellIndex) const { return m_closedStamp[cellIndex] == m_searchGeneration; }
+    bool ensureStepGenerated(size_t stepIndex);
+    void trimHistory();
+    void addKeyframe(size_t stepIndex);
+    void rebuildKeyframes();
+    const AStarStep& stepAt(size_t stepIndex) const { return m_steps[stepIndex - m_traceBase]; }
+    float calculateHeuristic(int x1, int y1, int x2, int y2) const;
+    ExpandKernel selectExpandKernel() const;
+    template <typename Heuristic>
+    ExpandKernel selectExpandKernel() const;
+    template <typename Heuristic, typename TieBreak>
+    ExpandKernel selectExpandKernel() const;
+    template <typename Neighborhood, typename Heuristic, typename TieBreak>
+    void expandNeighbors(int cellIndex);
+    template <bool Precomputed, typename Heuristic, typename TieBreak>
+    void expandJumpPoints(int cellIndex);
+    template <typename Heuristic, typename TieBreak>
+    void relaxSuccessor(int fromIndex, int toIndex, float stepCost);
+    template <typename Heuristic>
+    float estimateToGoal(int cellIndex) const;
+    void collectJumpSuccessors(int cellIndex);
+    void collectJumpPlusSuccessors(int cellIndex);
+    bool isWalkable(int x, int y) const;
+    int jumpHorizontal(int x, int y, int dx) const;
+    int jumpVertical(int x, int y, int dy) const;
+    void buildJumpTables();
     std::vector<std::pair<int, int>> reconstructPath(int goalX, int goalY);
-    void addStep(const std::vector<std::vector<GridCell>>& grid, int currentX, int currentY, const std::string& desc, const std::vector<std::pair<int, int>>& path = {});
+    void updateTerminalState();
+    void recordCellChange(int cellIndex);
+    void addStep(AStarStepKind kind, int currentX, int currentY);
+    void applyStepChanges(const AStarStep& step, AStarGrid& grid, bool forward) const;
+    void moveToStep(size_t stepIndex, bool restore);
     
-    std::vector<std::vector<GridCell>> m_originalGrid;
-    std::vector<std::vector<GridCell>> m_currentGrid;
-    std::vector<AStarStep> m_steps;
+    AStarGrid m_originalGrid;
+    AStarGrid m_currentGrid;
+    AStarGrid m_baseGrid;           // Grid before m_steps.front() is applied, filled once the window first slides
+    std::deque<AStarStep> m_steps;  // Retained window of the trace
+    std::deque<AStarKeyframe> m_keyframes;   // Inside the window, after m_traceBase
+    size_t m_traceBase;             // Absolute index of m_steps.front()
     AStarStep m_currentStep;
     
     int m_gridWidth, m_gridHeight;
@@ -112,11 +376,68 @@ private:
     size_t m_currentStepIndex;
     float m_stepDelay;
     float m_timeSinceLastStep;
+    bool m_lazyGeneration;
+    size_t m_historyLimit;
+    size_t m_keyframeInterval;
+    AStarOpenListKind m_openListKind;
+    AStarSearchEngine m_searchEngine;
+    AStarNeighborhood m_neighborhood;
+    AStarHeuristic m_heuristic;
+    AStarTieBreak m_tieBreak;
+    
+    // Search state
+    SearchPhase m_searchPhase;
+    AStarGrid m_workingGrid;
+    ExpandKernel m_expandKernel;
+    IndexedHeap<OpenKey> m_openHeap;
+    std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> m_lazyOpenList;
+    BucketQueue m_openBuckets;
+    bool m_bucketSearch;   // This search's open list is m_openBuckets
+    
+    // Membership is "stamp == current generation", so starting a search is a
+    // counter bump rather than a clear of every cell
+    std::vector<std::uint32_t> m_openStamp;
+    std::vector<std::uint32_t> m_closedStamp;
+    std::uint32_t m_searchGeneration;
+    int m_openCount;
+    int m_closedCount;
+    AStarSearchCounters m_counters;
+    std::vector<Successor> m_successors;   // Jump points found by the expansion in progress
+    std::vector<std::pair<int, int>> m_finalPath;
+    std::vector<AStarCellChange> m_pendingChanges;  // Old values of cells touched since the last step
+    size_t m_pathIndex;
+    
+    // JPS+ distance to the next jump point per direction: > 0 steps to it,
+    // <= 0 the negated count of walkable cells before a wall
+    std::vector<std::int32_t> m_jumpDistance[JUMP_DIRECTION_COUNT];
+    bool m_jumpTablesDirty;
+    
+    int m_weightedCellCount;   // Cells heavier than 1; JPS needs uniform costs
+    
+    // Edit batching
+    int m_editDepth;
+    bool m_editPending;
     
     // Statistics tracking
     int m_totalSteps;
     int m_currentOpenListSize;
     int m_currentClosedListSize;
     
+    // Incremental replanning; both planners track the walls, the active one plans
+    AStarPlannerKind m_plannerKind;
+    DStarLite m_planner;
+    HierarchicalPathfinder m_hierarchical;
+    BitParallelBfs m_reachability;   // Screens out unreachable goals before HPA* searches
+    FlowField m_flowField;
+    bool m_flowFieldDirty;
+    LandmarkTable m_landmarks;   // Built on the first ALT search after an edit that invalidates it
+    
+    // Last generated map
+    MapGenerator m_mapGenerator;
+    MapGeneratorKind m_mapKind;
+    std::uint64_t m_mapSeed;
+    std::vector<std::pair<int, int>> m_plannedPath;
+    std::vector<int> m_plannedCells;
+    
     std::function<void(const AStarStep&)> m_stepCallback;
 };
\ No newline at end of file
@@ -2,7 +2,10 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <functional>
+#include <random>
 #include "AStarController.h"
+#include "CrowdSimulation.h"
+#include "CooperativePathfinder.h"
 
 class AudioManager;
 
@@ -25,7 +28,8 @@ private:
         NONE,
         PLACE_WALL,
         PLACE_START,
-        PLACE_GOAL
+        PLACE_GOAL,
+        PAINT_MUD
     };
     
     struct ControlButton {
@@ -37,11 +41,17 @@ private:
     void drawGrid(sf::RenderWindow& window);
     void drawInfo(sf::RenderWindow& window);
     void drawControls(sf::RenderWindow& window);
+    void drawScrubBar(sf::RenderWindow& window);
+    bool handleScrub(int mouseX, int mouseY);
     void drawPath(sf::RenderWindow& window, const std::vector<std::pair<int, int>>& path, sf::Color color, float thickness = 3.0f);
     void drawCurrentPath(sf::RenderWindow& window, int currentX, int currentY);
+    void drawCrowd(sf::RenderWindow& window);
+    void drawCooperativeAgents(sf::RenderWindow& window);
+    void startCooperativeAgents();
+    void advanceCooperativeAgents(float deltaTime);
     
     void onAStarStep(const AStarStep& step);
-    sf::Color getCellColor(const GridCell& cell);
+    sf::Color getCellColor(CellType type, int weight);
     void updateGridDisplay();
     
     void initializeControls();
@@ -53,6 +63,9 @@ private:
     // Grid interaction
     void handleMouseClick(int mouseX, int mouseY);
     void handleMouseMove(int mouseX, int mouseY);
+    void cycleSearchEngine();
+    void openEditBatch();
+    void flushEdits();   // Commits the edits made since the last frame
     std::pair<int, int> screenToGrid(int screenX, int screenY);
     bool isValidGridPos(int gridX, int gridY);
     
@@ -79,6 +92,8 @@ private:
     sf::Color m_pathColor;           // Bright yellow
     sf::Color m_currentColor;        // Cyan
     sf::Color m_inactiveColor;       // Dim green
+    sf::Color m_plannedColor;        // Faded amber
+    sf::Color m_terrainColor;        // Brown, blended in by cell weight
     
     // Grid rendering
     float m_gridAreaX;
@@ -88,6 +103,12 @@ private:
     float m_cellSize;
     float m_gridOffsetX;
     float m_gridOffsetY;
+    sf::VertexArray m_cellVertices;  // Reused every frame, 6 vertices per cell
+    
+    // Timeline scrub bar (click or drag to seek)
+    float m_scrubBarY;
+    float m_scrubBarHeight;
+    bool m_scrubbing;
     
     // Statistics
     int m_stepCount;
@@ -100,6 +121,23 @@ private:
     int m_hoveredGridX;
     int m_hoveredGridY;
     bool m_mousePressed;
+    bool m_editBatchOpen;   // Controller edit batch spanning the current frame
+    
+    // Crowd following the controller's flow field (F to toggle)
+    CrowdSimulation m_crowd;
+    bool m_crowdActive;
+    sf::VertexArray m_agentVertices;  // 6 vertices per agent, one draw call for the crowd
+    
+    // Agents planned around each other with WHCA* (M to toggle)
+    CooperativePathfinder m_cooperative;
+    bool m_cooperativeActive;
+    int m_cooperativeStep;           // Steps of the current window already walked
+    float m_cooperativeClock;        // Time into the current step
+    std::mt19937 m_cooperativeRng;   // New goals for agents that arrive
+    sf::VertexArray m_cooperativeVertices;
+    
+    // Last engine comparison, empty until B is pressed
+    std::vector<AStarEngineResult> m_engineResults;
     
     // Camera/view
     sf::View m_gridView;
@@ -0,0 +1,82 @@
+#pragma once
+#include "AStarController.h"
+#include "IndexedHeap.h"
+#include <vector>
+#include <cstdint>
+
+struct PathQuery {
+    int startIndex;   // Linear cell indices into the grid
+    int goalIndex;
+};
+
+// One query's answer; no trace is recorded
+struct PathQueryResult {
+    std::vector<int> path;     // Start-to-goal cell indices, empty when unreachable
+    float cost = -1.0f;        // -1 when unreachable
+    int expansions = 0;
+    int heapPushes = 0;
+    double runtimeUs = 0.0;    // This query alone, on whichever worker ran it
+};
+
+// Totals for the most recent batch
+struct BatchSolveStats {
+    int threadCount = 0;
+    size_t queryCount = 0;
+    double wallMs = 0.0;
+    double queriesPerSecond = 0.0;
+    long long expansions = 0;
+};
+
+// Plain A* over many start/goal pairs on one read-only grid, spread across
+// worker threads. Only WALL cells block. Each worker has its own open list
+// and stamped g/parent arrays that persist between batches, so the grid is
+// the only thing workers share. Separate solvers can run concurrently on the
+// same grid; one solver runs one batch at a time.
+class BatchPathSolver {
+public:
+    explicit BatchPathSolver(int threadCount = 0);   // 0 uses every hardware thread
+    
+    void setNeighborhood(AStarNeighborhood neighborhood) { m_neighborhood = neighborhood; }
+    void setHeuristic(AStarHeuristic heuristic) { m_heuristic = heuristic; }
+    
+    // Results are in query order
+    std::vector<PathQueryResult> solveBatch(const AStarGrid& grid, const std::vector<PathQuery>& queries);
+    
+    int getThreadCount() const { return m_threadCount; }
+    const BatchSolveStats& getLastStats() const { return m_lastStats; }
+    
+private:
+    // f, then nearer the goal
+    struct SearchKey {
+        float fCost;
+        float hCost;
+        bool operator<(const SearchKey& other) const {
+            return fCost < other.fCost || (fCost == other.fCost && hCost < other.hCost);
+        }
+    };
+    
+    // One worker's buffers; only ever touched by that worker
+    struct Scratch {
+        IndexedHeap<SearchKey> open;
+        std::vector<float> gCost;
+        std::vector<std::int32_t> parent;
+        std::vector<std::uint32_t> seenStamp;     // gCost and parent valid this query
+        std::vector<std::uint32_t> closedStamp;
+        std::uint32_t generation = 0;
+    };
+    
+    using QueryKernel = void (*)(const AStarGrid& grid, const PathQuery& query, Scratch& scratch, PathQueryResult& result);
+    
+    QueryKernel selectKernel() const;
+    template <typename Heuristic>
+    QueryKernel selectKernel() const;
+    template <typename Neighborhood, typename Heuristic>
+    static void solveQuery(const AStarGrid& grid, const PathQuery& query, Scratch& scratch, PathQueryResult& result);
+    static void prepareScratch(Scratch& scratch, int cellCount);
+    
+    int m_threadCount;
+    AStarNeighborhood m_neighborhood;
+    AStarHeuristic m_heuristic;
+    std::vector<Scratch> m_scratch;   // One per worker
+    BatchSolveStats m_lastStats;
+};
\ No newline at end of file
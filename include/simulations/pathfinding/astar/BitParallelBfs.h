@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Work done by the most recent wavefront
+struct BitBfsStats {
+    int waves = 0;             // Frontier expansions, the farthest distance reached
+    long long wordOps = 0;     // 64-cell words combined across all waves
+    int reachedCells = 0;
+};
+
+// Unit-cost, 4-connected BFS that advances the whole frontier per wave.
+// Each row is an array of 64-bit words (bit x % 64 of word x / 64), so one
+// shift-and-mask step moves 64 cells. Compact frontiers sweep their rows
+// densely; once the frontier is a thin ring, only words on or next to it are
+// visited, so a wave costs the ring's length rather than the grid's area.
+// Rows and words are padded with a closed border, so the inner step has no
+// bounds checks.
+class BitParallelBfs {
+public:
+    BitParallelBfs();
+    
+    // Every cell starts passable
+    void initialize(int width, int height);
+    void setBlocked(int cellIndex, bool blocked);
+    bool isBlocked(int cellIndex) const;
+    
+    // Distance from source to every cell, -1 where unreachable or blocked
+    void computeDistanceField(int sourceIndex);
+    const std::vector<int>& getDistances() const { return m_distances; }
+    int getSource() const { return m_source; }
+    
+    // Source-to-target cells down the distance field; false if unreachable
+    bool extractPath(int targetIndex, std::vector<int>& path) const;
+    
+    // Wavefront without distance writes, stopping once target is reached
+    bool isReachable(int sourceIndex, int targetIndex);
+    
+    const BitBfsStats& getStats() const { return m_stats; }
+    
+private:
+    // Moves m_frontier one wave out and lists its words in m_activeWords;
+    // returns false when nothing new was reached
+    bool advanceWave();
+    void sweepRows(int firstRow, int lastRow);
+    void visitFrontierWords();
+    bool spreadInto(size_t word);   // Fills m_next[word]; true if it gained cells
+    bool seed(int sourceIndex);
+    size_t wordIndex(int x, int paddedRow) const {
+        return static_cast<size_t>(paddedRow) * m_stride + 1 + x / 64;
+    }
+    
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    int m_stride;                        // Words per padded row: one pad word each side
+    std::vector<std::uint64_t> m_open;   // Padded rows 0 and height + 1 stay zero
+    std::vector<std::uint64_t> m_reached;
+    std::vector<std::uint64_t> m_frontier;
+    std::vector<std::uint64_t> m_next;
+    std::vector<std::uint32_t> m_wordStamp;   // Word already considered this wave
+    std::uint32_t m_waveStamp;
+    std::vector<size_t> m_activeWords;        // Nonzero frontier words
+    int m_firstRow;                           // Padded rows spanned by the frontier
+    int m_lastRow;
+    std::vector<size_t> m_nextWords;
+    std::vector<int> m_distances;
+    int m_source;
+    BitBfsStats m_stats;
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Dial's bucket queue over dense integer keys (cell indices) with small
+// non-negative integer priorities. Buckets form a ring indexed by priority,
+// so push, decrease-key and pop are O(1) plus the empty buckets pop skips.
+// Meant for monotone use, as Dijkstra or A* with a consistent heuristic: the
+// ring grows when the queued priorities span more buckets than it has.
+// Within a bucket the last key pushed leaves first.
+class BucketQueue {
+public:
+    BucketQueue() : m_current(0), m_highest(0), m_size(0) {}
+    
+    // Empties the queue and makes keys [0, keyCount) valid. Only the buckets
+    // and slots still in use are cleared, so resetting after a search is O(size).
+    void reset(int keyCount) {
+        if (m_size > 0) {
+            for (auto& bucket : m_buckets) {
+                for (std::int32_t key : bucket) {
+                    m_slots[key] = -1;
+                }
+                bucket.clear();
+            }
+        }
+        if (static_cast<int>(m_slots.size()) != keyCount) {
+            m_slots.assign(keyCount, -1);
+            m_priorities.assign(keyCount, 0);
+        }
+        if (m_buckets.empty()) m_buckets.resize(INITIAL_BUCKETS);
+        m_size = 0;
+    }
+    
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    bool contains(int key) const { return m_slots[key] >= 0; }
+    size_t getBucketCount() const { return m_buckets.size(); }
+    
+    void push(int key, int priority) {
+        if (m_size == 0) {
+            m_current = priority;
+            m_highest = priority;
+        } else if (priority < m_current) {
+            m_current = priority;   // Not monotone; still correct while the span fits
+        } else if (priority > m_highest) {
+            m_highest = priority;
+        }
+        if (m_highest - m_current >= static_cast<int>(m_buckets.size())) {
+            grow();
+        }
+        place(key, priority);
+        m_size++;
+    }
+    
+    // priority must not exceed the current one
+    void decreaseKey(int key, int priority) {
+        unlink(key);
+        if (priority < m_current) m_current = priority;
+        if (m_highest - m_current >= static_cast<int>(m_buckets.size())) {
+            grow();
+        }
+        place(key, priority);
+    }
+    
+    int getMinPriority() {
+        skipEmptyBuckets();
+        return m_current;
+    }
+    
+    int pop() {
+        skipEmptyBuckets();
+        auto& bucket = m_buckets[m_current & mask()];
+        int key = bucket.back();
+        bucket.pop_back();
+        m_slots[key] = -1;
+        m_size--;
+        return key;
+    }
+    
+private:
+    static const int INITIAL_BUCKETS = 64;   // Power of two
+    
+    int mask() const { return static_cast<int>(m_buckets.size()) - 1; }
+    
+    void skipEmptyBuckets() {
+        while (m_buckets[m_current & mask()].empty()) {
+            m_current++;
+        }
+    }
+    
+    void place(int key, int priority) {
+        auto& bucket = m_buckets[priority & mask()];
+        m_slots[key] = static_cast<std::int32_t>(bucket.size());
+        m_priorities[key] = priority;
+        bucket.push_back(key);
+    }
+    
+    // Swaps the bucket's last key into the hole
+    void unlink(int key) {
+        auto& bucket = m_buckets[m_priorities[key] & mask()];
+        std::int32_t slot = m_slots[key];
+        std::int32_t last = bucket.back();
+        bucket[slot] = last;
+        m_slots[last] = slot;
+        bucket.pop_back();
+        m_slots[key] = -1;
+    }
+    
+    // Doubles the ring until the span fits and rehomes every queued key
+    void grow() {
+        std::vector<std::vector<std::int32_t>> old;
+        old.swap(m_buckets);
+        size_t bucketCount = old.size();
+        while (static_cast<int>(bucketCount) <= m_highest - m_current) {
+            bucketCount *= 2;
+        }
+        m_buckets.resize(bucketCount);
+        for (auto& bucket : old) {
+            for (std::int32_t key : bucket) {
+                place(key, m_priorities[key]);
+            }
+        }
+    }
+    
+    std::vector<std::vector<std::int32_t>> m_buckets;   // Ring; priority p lives in p & mask()
+    std::vector<std::int32_t> m_slots;        // Position of a key within its bucket, -1 if not queued
+    std::vector<std::int32_t> m_priorities;   // Priority of each queued key
+    int m_current;    // No queued priority is lower
+    int m_highest;    // No queued priority is higher since the queue last ran empty
+    size_t m_size;
+};
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include "IndexedHeap.h"
+#include <vector>
+#include <cstdint>
+
+// Totals for the most recent planWindow()
+struct CooperativeStats {
+    int agentsPlanned = 0;
+    int blockedAgents = 0;      // Boxed in even after promotion; waits where it may collide
+    long long expansions = 0;   // Space-time states expanded over all agents
+    double wallMs = 0.0;
+    double agentsPerSecond = 0.0;
+};
+
+// Windowed cooperative A* (WHCA*) for many agents on a 4-connected grid.
+// Agents are planned one at a time in priority order. Each searches space
+// and time (cell, step) for the next window of steps, and its path is
+// written to a reservation table that later agents treat as obstacles, both
+// cells and swaps along an edge. Waiting in place is a move. An agent boxed in
+// by higher priorities is promoted and the window replanned. Only part of
+// each window is executed before every agent replans, and the priority order
+// rotates each time so no agent always yields.
+//
+// Every agent's search reuses one scratch arena: within a window an agent
+// can stray at most window cells from where it starts, so states are
+// indexed in a (2 * window + 1)^2 * (window + 1) box around the start and
+// stamped, never cleared.
+class CooperativePathfinder {
+public:
+    CooperativePathfinder();
+    
+    // Every cell starts passable; agents are removed
+    void initialize(int width, int height, int window = 16);
+    void setBlocked(int cellIndex, bool blocked);
+    bool isBlocked(int cellIndex) const { return m_blocked[cellIndex] != 0; }
+    
+    // Starts should be distinct open cells; returns the agent's id
+    int addAgent(int startIndex, int goalIndex);
+    void setGoal(int agent, int goalIndex) { m_goals[agent] = goalIndex; }   // Used from the next planWindow()
+    void clearAgents();
+    
+    // Replans every agent for the next window from where it stands now
+    void planWindow();
+    // Moves every agent steps along its plan (at most the window)
+    void advance(int steps);
+    
+    int getWindow() const { return m_window; }
+    int getAgentCount() const { return static_cast<int>(m_positions.size()); }
+    int getPosition(int agent) const { return m_positions[agent]; }
+    int getGoal(int agent) const { return m_goals[agent]; }
+    int getPlannedCell(int agent, int step) const { return m_plans[static_cast<size_t>(agent) * (m_window + 1) + step]; }
+    int getArrivedCount() const;
+    const CooperativeStats& getStats() const { return m_stats; }
+    
+private:
+    // f = steps taken + distance left, then nearer the goal
+    struct SearchKey {
+        int fCost;
+        int hCost;
+        bool operator<(const SearchKey& other) const {
+            return fCost < other.fCost || (fCost == other.fCost && hCost < other.hCost);
+        }
+    };
+    
+    bool planAgent(int agent);   // False if boxed in before the window ends
+    // Cell-major: one cell's whole window shares a cache line or two, and
+    // neighboring cells sit next to each other
+    size_t reservationIndex(int cellIndex, int step) const {
+        return static_cast<size_t>(cellIndex) * (m_window + 1) + step;
+    }
+    bool isFree(int cellIndex, int step, int agent) const {
+        std::int32_t owner = m_reservations[reservationIndex(cellIndex, step)];
+        return owner < 0 || owner == agent;
+    }
+    void reserve(int cellIndex, int step, int agent) {
+        m_reservations[reservationIndex(cellIndex, step)] = agent;
+    }
+    void releasePlans();
+    
+    int m_width;
+    int m_height;
+    int m_cellCount;
+    int m_window;
+    int m_side;             // Local box width, 2 * window + 1
+    std::vector<std::uint8_t> m_blocked;
+    
+    std::vector<std::int32_t> m_positions;
+    std::vector<std::int32_t> m_goals;
+    std::vector<std::int32_t> m_order;          // Agents by priority, highest first
+    std::vector<std::int32_t> m_plans;          // window + 1 cells per agent, step 0 being the position
+    bool m_plansReserved;
+    std::vector<std::int32_t> m_reservations;   // Agent holding (cell, step), -1 if free
+    
+    // Scratch arena shared by every agent's search
+    IndexedHeap<SearchKey> m_open;
+    std::vector<std::uint32_t> m_stateStamp;   // Reached during the current search
+    std::vector<std::int32_t> m_stateParent;
+    std::uint32_t m_searchGeneration;
+    
+    CooperativeStats m_stats;
+};
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "FlowField.h"
+#include <vector>
+#include <random>
+
+// Work done by the most recent tick
+struct CrowdTickStats {
+    double tickMs = 0.0;
+    int arrivals = 0;     // Agents that reached the goal and respawned
+    int stalled = 0;      // Agents on cells the field cannot lead out of
+};
+
+// Agents that all head for one goal by following a FlowField. State is kept
+// as structure-of-arrays, so a tick streams positions and speeds and reads
+// one direction byte per agent; there is no per-agent search. Agents walk
+// toward the center of the next cell, and the field never cuts a wall corner,
+// so the straight line there stays on open cells. Positions are in cells,
+// (0, 0) being the top-left corner of the grid.
+class CrowdSimulation {
+public:
+    CrowdSimulation();
+    
+    // Scatters agents over cells that can reach the goal
+    void spawn(const FlowField& field, int agentCount, unsigned seed);
+    void clear();
+    
+    // Arrived agents respawn, so the crowd keeps flowing
+    void update(const FlowField& field, float deltaTime);
+    
+    int getAgentCount() const { return static_cast<int>(m_x.size()); }
+    const std::vector<float>& getX() const { return m_x; }
+    const std::vector<float>& getY() const { return m_y; }
+    long long getTotalArrivals() const { return m_totalArrivals; }
+    const CrowdTickStats& getLastTick() const { return m_lastTick; }
+    
+private:
+    void respawn(const FlowField& field, size_t agent);
+    
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_speed;   // Cells per second, varied so agents spread out
+    std::mt19937 m_rng;
+    long long m_totalArrivals;
+    CrowdTickStats m_lastTick;
+};
\ No newline at end of file
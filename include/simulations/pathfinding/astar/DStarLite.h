@@ -0,0 +1,79 @@
+#pragma once
+#include "IndexedHeap.h"
+#include <vector>
+#include <cstdint>
+
+// Fixed-point path cost: a straight step is 2^20 and a diagonal sqrt 2 rounded
+// to the same scale. Sums are exact, so routes of equal length tie exactly and
+// the key comparisons never disagree with each other
+using DStarCost = std::int64_t;
+
+// Lexicographic D* Lite priority: [min(g, rhs) + h + km, min(g, rhs)]
+struct DStarKey {
+    DStarCost primary;
+    DStarCost secondary;
+    bool operator<(const DStarKey& other) const {
+        return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+    }
+};
+
+// Work done by the most recent repair, and since initialize()
+struct DStarLiteCounters {
+    long long lastExpansions = 0;
+    long long lastVertexUpdates = 0;
+    long long totalExpansions = 0;
+    long long totalVertexUpdates = 0;
+};
+
+// D* Lite on a 4- or 8-connected grid (diagonals cost sqrt 2 and may not cut
+// wall corners). Entering a cell costs the move times the cell's weight, as in
+// the A* trace. The search runs backwards from the
+// goal, so g/rhs survive wall edits and start moves: a repair only touches
+// cells whose distance to the goal actually changed. Moving the goal re-roots
+// the tree and falls back to a full search.
+class DStarLite {
+public:
+    DStarLite();
+    
+    // Every cell starts passable; call computeShortestPath() afterwards
+    void initialize(int width, int height, int startIndex, int goalIndex, bool diagonal = false);
+    void setBlocked(int cellIndex, bool blocked);
+    void setWeight(int cellIndex, int weight);   // 1 and up
+    void setStart(int cellIndex);
+    void setGoal(int cellIndex);
+    
+    // Processes queued inconsistencies until the start is settled
+    void computeShortestPath();
+    
+    // Start-to-goal cell indices by descending g; empty when unreachable
+    void extractPath(std::vector<int>& path) const;
+    
+    bool hasPath() const;
+    float getPathCost() const;   // In straight steps, weights included; infinity when unreachable
+    bool isBlocked(int cellIndex) const { return m_blocked[cellIndex] != 0; }
+    const DStarLiteCounters& getCounters() const { return m_counters; }
+    
+private:
+    DStarCost heuristic(int fromIndex, int toIndex) const;
+    DStarKey calculateKey(int cellIndex) const;
+    void updateVertex(int cellIndex);
+    // Passable neighbors and edge costs; up to 8 with diagonals
+    int getNeighbors(int cellIndex, int neighbors[8], DStarCost costs[8]) const;
+    // Every cell whose edges depend on this one, passable or not
+    int getAdjacent(int cellIndex, int adjacent[8]) const;
+    
+    int m_width;
+    int m_height;
+    bool m_diagonal;
+    int m_start;
+    int m_goal;
+    int m_lastStart;   // Start the current keys were computed against
+    DStarCost m_km;    // Accumulated heuristic drift from start moves
+    
+    std::vector<DStarCost> m_g;
+    std::vector<DStarCost> m_rhs;            // One-step lookahead: min over neighbors of cost + g
+    std::vector<std::uint8_t> m_blocked;
+    std::vector<std::uint8_t> m_weights;
+    IndexedHeap<DStarKey> m_queue;        // Locally inconsistent cells (g != rhs)
+    DStarLiteCounters m_counters;
+};
\ No newline at end of file
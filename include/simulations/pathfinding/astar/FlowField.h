@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// Direction codes index these offsets: straight moves first (up, down,
+// left, right), then diagonals, the same order as the A* neighborhoods
+static const int FLOW_DX[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+static const int FLOW_DY[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+static const std::uint8_t FLOW_GOAL = 254;   // Standing on the goal
+static const std::uint8_t FLOW_NONE = 255;   // Blocked or cut off from the goal
+
+// Work done by the most recent build
+struct FlowFieldStats {
+    double buildMs = 0.0;
+    int reachedCells = 0;
+    long long bucketPops = 0;
+};
+
+// Distance-to-goal field for every cell at once, so any number of agents can
+// follow it with one lookup each instead of one search each. Costs are
+// integers (10 straight, 14 diagonal) and the search is Dijkstra over a
+// circular bucket queue (Dial's algorithm), so no heap is involved. Each
+// cell's direction is the move that settled it, pointing down the field.
+class FlowField {
+public:
+    static constexpr int STRAIGHT_COST = 10;
+    static constexpr int DIAGONAL_COST = 14;
+    
+    FlowField();
+    
+    // Every cell starts passable; call build() afterwards
+    void initialize(int width, int height, bool diagonal = false);
+    void setBlocked(int cellIndex, bool blocked);
+    bool isBlocked(int cellIndex) const { return m_blocked[cellIndex] != 0; }
+    
+    void build(int goalIndex);
+    
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getGoal() const { return m_goal; }
+    std::uint8_t getDirection(int cellIndex) const { return m_directions[cellIndex]; }
+    const std::vector<std::uint8_t>& getDirections() const { return m_directions; }
+    const std::vector<std::int32_t>& getCosts() const { return m_costs; }   // -1 where unreachable
+    // Cells that can reach the goal, nearest first; the goal is element 0
+    const std::vector<std::int32_t>& getReachableCells() const { return m_reachable; }
+    const FlowFieldStats& getStats() const { return m_stats; }
+    
+private:
+    int m_width;
+    int m_height;
+    bool m_diagonal;
+    int m_goal;
+    std::vector<std::uint8_t> m_blocked;
+    std::vector<std::int32_t> m_costs;          // Integration field
+    std::vector<std::uint8_t> m_directions;     // Flow field
+    std::vector<std::int32_t> m_reachable;
+    std::vector<std::vector<std::int32_t>> m_buckets;   // Indexed by cost modulo the bucket count
+    FlowFieldStats m_stats;
+};
\ No newline at end of file
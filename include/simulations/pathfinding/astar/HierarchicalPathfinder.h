@@ -0,0 +1,127 @@
+#pragma once
+#include "IndexedHeap.h"
+#include <vector>
+#include <cstdint>
+
+// Work done by the most recent query
+struct HierarchicalStats {
+    int sectorsRebuilt = 0;           // Dirty sectors refreshed before the query
+    int abstractNodes = 0;            // Entrance nodes in the whole graph
+    long long abstractExpansions = 0;
+    long long refineExpansions = 0;   // Cells visited while refining the corridor
+    double rebuildMs = 0.0;
+    double queryMs = 0.0;             // Abstract search plus refinement
+};
+
+// HPA* on a 4-connected unit-cost grid. The grid is cut into square sectors;
+// free cell pairs across sector borders become entrance nodes, and each
+// sector stores the path lengths between its own entrances. A query searches
+// that small graph and then refines only the sectors on the chosen corridor.
+// Paths are near-optimal, not optimal: they always pass through entrances.
+class HierarchicalPathfinder {
+public:
+    HierarchicalPathfinder();
+    
+    // Every cell starts passable; sectors are at most 64 cells wide
+    void initialize(int width, int height, int sectorSize = 32);
+    
+    // Marks the sector (and the neighbor across a border cell) for rebuild
+    void setBlocked(int cellIndex, bool blocked);
+    bool isBlocked(int cellIndex) const { return m_blocked[cellIndex] != 0; }
+    
+    // Refreshes dirty sectors; findPath() calls it first
+    void rebuildDirtySectors();
+    
+    // Start-to-goal cell indices; false and empty when unreachable
+    bool findPath(int startIndex, int goalIndex, std::vector<int>& path);
+    
+    int getSectorSize() const { return m_sectorSize; }
+    const HierarchicalStats& getStats() const { return m_stats; }
+    
+private:
+    // Abstract open-list priority: f, then nearer the goal. Manhattan ties
+    // are everywhere on open maps, and diving in skips most of them.
+    struct AbstractKey {
+        float fCost;
+        float hCost;
+        bool operator<(const AbstractKey& other) const {
+            return fCost < other.fCost || (fCost == other.fCost && hCost < other.hCost);
+        }
+    };
+    
+    struct PendingTarget {
+        int row;
+        std::uint64_t bit;
+        int index;
+    };
+    
+    struct Sector {
+        std::vector<int> nodeCells;    // Entrance cells inside this sector, sorted
+        std::vector<float> distances;  // nodeCount x nodeCount path lengths inside the sector
+        bool dirty = true;
+    };
+    
+    int sectorOf(int x, int y) const { return (y / m_sectorSize) * m_sectorsX + x / m_sectorSize; }
+    void buildSector(int sectorIndex);
+    void addBorderEntrances(bool vertical, int line, int from, int to, int outward, std::vector<int>& cells) const;
+    int findNode(int sectorIndex, int cellIndex) const;  // Global node id or -1
+    
+    // Copies one sector into the padded local grid the searches below run on
+    void loadSector(int sectorIndex);
+    int toLocal(int cellIndex) const;
+    int toGlobal(int localIndex) const;
+    
+    // Step counts from source to each target inside the loaded sector, -1
+    // when unreachable. Expands a whole wavefront per row with bit masks,
+    // which beats a queue on cluttered sectors. Returns the wavefront count.
+    int measureDistances(int source, const int* targets, int targetCount, std::vector<int>& distances);
+    
+    // Breadth-first search inside the loaded sector; appends the route after
+    // source to path. Returns the number of cells dequeued.
+    int searchSector(int source, int target, std::vector<int>& path);
+    float heuristic(int fromIndex, int toIndex) const;
+    
+    int m_width;
+    int m_height;
+    int m_sectorSize;
+    int m_sectorsX;
+    int m_sectorsY;
+    std::vector<std::uint8_t> m_blocked;
+    std::vector<Sector> m_sectors;
+    std::vector<int> m_dirtySectors;
+    std::vector<int> m_nodeOffsets;    // Global id of each sector's first node, plus a total
+    std::vector<int> m_nodeCell;       // Flattened nodeCells, by global id
+    std::vector<int> m_nodeSector;
+    
+    // Loaded sector with a one-cell blocked rim, so the inner loop needs no
+    // bounds checks; BFS scratch is stamped instead of cleared
+    int m_loadedSector;
+    int m_localPitch;
+    int m_localX0;
+    int m_localY0;
+    std::vector<std::uint8_t> m_localOpen;
+    std::vector<std::uint64_t> m_rowOpen;     // Bit x of row y: local cell open
+    std::vector<std::uint64_t> m_rowReached;
+    std::vector<std::uint64_t> m_rowFrontier;
+    std::vector<std::uint64_t> m_rowNext;
+    std::vector<int> m_measured;
+    std::vector<PendingTarget> m_pendingTargets;
+    std::vector<int> m_localParent;
+    std::vector<std::uint32_t> m_localStamp;
+    std::uint32_t m_localGeneration;
+    std::vector<int> m_localQueue;
+    std::vector<int> m_localRoute;
+    
+    // Abstract search scratch, indexed by global node id plus start and goal;
+    // entries are only valid where m_nodeStamp matches the query generation
+    IndexedHeap<AbstractKey> m_open;
+    std::vector<float> m_g;
+    std::vector<int> m_parent;
+    std::vector<std::uint8_t> m_closed;
+    std::vector<std::uint32_t> m_nodeStamp;
+    std::uint32_t m_queryGeneration;
+    std::vector<float> m_startDistances;   // From the start to each node of its sector
+    std::vector<float> m_goalDistances;    // From each node of the goal's sector to the goal
+    
+    HierarchicalStats m_stats;
+};
\ No newline at end of file
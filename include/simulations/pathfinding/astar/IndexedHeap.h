@@ -0,0 +1,122 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 4-ary min-heap over dense integer keys (cell indices) with decrease-key.
+// Each key is in the heap at most once; m_positions maps a key to its slot,
+// so membership and priority updates need no hashing and no stale entries.
+// Priority only needs operator<, so planners can use lexicographic keys.
+template <typename Priority>
+class IndexedHeap {
+public:
+    IndexedHeap() = default;
+    
+    // Empties the heap and makes keys [0, keyCount) valid. Only the slots of
+    // keys still queued are cleared, so resetting after a search is O(size).
+    void reset(int keyCount) {
+        if (static_cast<int>(m_positions.size()) != keyCount) {
+            m_positions.assign(keyCount, -1);
+        } else {
+            for (const auto& entry : m_entries) {
+                m_positions[entry.key] = -1;
+            }
+        }
+        m_entries.clear();
+    }
+    
+    bool empty() const { return m_entries.empty(); }
+    size_t size() const { return m_entries.size(); }
+    bool contains(int key) const { return m_positions[key] >= 0; }
+    
+    void push(int key, const Priority& priority) {
+        m_entries.push_back({priority, key});
+        m_positions[key] = static_cast<std::int32_t>(m_entries.size() - 1);
+        siftUp(m_entries.size() - 1);
+    }
+    
+    // priority must not exceed the current one
+    void decreaseKey(int key, const Priority& priority) {
+        size_t position = static_cast<size_t>(m_positions[key]);
+        m_entries[position].priority = priority;
+        siftUp(position);
+    }
+    
+    // Any direction; used by planners whose keys can grow
+    void update(int key, const Priority& priority) {
+        size_t position = static_cast<size_t>(m_positions[key]);
+        m_entries[position].priority = priority;
+        siftUp(position);
+        siftDown(static_cast<size_t>(m_positions[key]));
+    }
+    
+    void remove(int key) {
+        size_t position = static_cast<size_t>(m_positions[key]);
+        m_positions[key] = -1;
+        
+        Entry last = m_entries.back();
+        m_entries.pop_back();
+        if (position < m_entries.size()) {
+            place(position, last);
+            siftUp(position);
+            siftDown(static_cast<size_t>(m_positions[last.key]));
+        }
+    }
+    
+    int top() const { return m_entries.front().key; }
+    const Priority& topPriority() const { return m_entries.front().priority; }
+    
+    int pop() {
+        int key = m_entries.front().key;
+        remove(key);
+        return key;
+    }
+    
+private:
+    struct Entry {
+        Priority priority;
+        int key;
+    };
+    
+    static constexpr size_t ARITY = 4;  // Shallower than binary; the 4 children share a cache line
+    
+    void siftUp(size_t position) {
+        // Move the hole up instead of swapping at every level
+        Entry entry = m_entries[position];
+        while (position > 0) {
+            size_t parent = (position - 1) / ARITY;
+            if (!(entry.priority < m_entries[parent].priority)) break;
+            place(position, m_entries[parent]);
+            position = parent;
+        }
+        place(position, entry);
+    }
+    
+    void siftDown(size_t position) {
+        Entry entry = m_entries[position];
+        size_t count = m_entries.size();
+        while (true) {
+            size_t firstChild = position * ARITY + 1;
+            if (firstChild >= count) break;
+            
+            size_t lastChild = firstChild + ARITY < count ? firstChild + ARITY : count;
+            size_t best = firstChild;
+            for (size_t child = firstChild + 1; child < lastChild; child++) {
+                if (m_entries[child].priority < m_entries[best].priority) best = child;
+            }
+            if (!(m_entries[best].priority < entry.priority)) break;
+            
+            place(position, m_entries[best]);
+            position = best;
+        }
+        place(position, entry);
+    }
+    
+    void place(size_t position, const Entry& entry) {
+        m_entries[position] = entry;
+        m_positions[entry.key] = static_cast<std::int32_t>(position);
+    }
+    
+    std::vector<Entry> m_entries;
+    std::vector<std::int32_t> m_positions;  // Slot in m_entries per key, -1 if absent
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// Work done by the most recent update() that rebuilt anything
+struct LandmarkStats {
+    int tablesRebuilt = 0;
+    int threadCount = 0;
+    double buildMs = 0.0;
+    long long editsAbsorbed = 0;   // Wall edits since initialize() that left every table valid
+};
+
+// Exact distances from a few landmark cells, for the ALT heuristic: for any
+// landmark L, |d(L, goal) - d(L, n)| <= d(n, goal) by the triangle
+// inequality. Distances are integers (10 straight, 14 diagonal) from one Dial
+// search per landmark, run in parallel. They are stored cell-major, the
+// LANDMARK_COUNT values of one cell side by side, so an estimate is one
+// contiguous load per cell and a max over the lanes, which the compiler
+// vectorizes. Diagonals costing 1.4 instead of sqrt 2 keep the bound
+// admissible. A wall edit only invalidates the tables whose shortest paths it
+// can change; that is decided from the cell's neighbors, and every other table
+// is patched in place.
+class LandmarkTable {
+public:
+    static constexpr int LANDMARK_COUNT = 8;
+    static constexpr int STRAIGHT_COST = 10;
+    static constexpr int DIAGONAL_COST = 14;
+    
+    LandmarkTable();
+    
+    // Every cell starts passable and every table stale; nothing is built yet
+    void initialize(int width, int height, bool diagonal = false);
+    void setBlocked(int cellIndex, bool blocked);
+    bool isBlocked(int cellIndex) const { return m_blocked[cellIndex] != 0; }
+    
+    // Moves landmarks off walls and rebuilds stale tables, one thread per table
+    void update();
+    bool isStale() const;
+    
+    // Estimates toward the target read its row once, here
+    void setTarget(int targetIndex);
+    float estimate(int cellIndex) const;
+    float estimate(int fromIndex, int toIndex) const;
+    
+    const std::vector<int>& getLandmarks() const { return m_landmarks; }
+    const LandmarkStats& getStats() const { return m_stats; }
+    
+private:
+    void selectLandmark(int landmark);
+    void buildTable(int landmark, std::vector<std::vector<std::int32_t>>& buckets);
+    bool isEdgeOpen(int fromIndex, int direction) const;
+    // Whether the edit at cellIndex changes distances beyond the cell itself;
+    // if not, the cell's own entry is patched
+    bool absorbEdit(int landmark, int cellIndex, bool blocked);
+    float geometricEstimate(int fromIndex, int toIndex) const;
+    
+    int m_width;
+    int m_height;
+    bool m_diagonal;
+    std::vector<std::uint8_t> m_blocked;
+    std::vector<int> m_landmarks;                        // Cell per landmark
+    std::vector<std::uint8_t> m_stale;                   // Per landmark
+    std::vector<std::vector<std::int32_t>> m_columns;    // Landmark-major build output, -1 if unreachable
+    std::vector<std::int32_t> m_table;                   // Cell-major copy the estimates read
+    std::int32_t m_target[LANDMARK_COUNT];
+    int m_targetIndex;
+    LandmarkStats m_stats;
+};
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// xoshiro256** seeded through splitmix64: a few shifts and rotates per number
+// and the same stream for the same seed on every platform. Satisfies
+// UniformRandomBitGenerator, so it also drives the standard algorithms.
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+    
+    explicit Xoshiro256(std::uint64_t seed = 1) { seedWith(seed); }
+    
+    void seedWith(std::uint64_t seed);
+    std::uint64_t operator()() {
+        std::uint64_t result = rotateLeft(m_state[1] * 5, 7) * 9;
+        std::uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotateLeft(m_state[3], 45);
+        return result;
+    }
+    // Multiply-shift instead of a modulo; bound must fit in 32 bits
+    std::uint32_t nextBelow(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+    float nextFloat() { return ((*this)() >> 40) * (1.0f / 16777216.0f); }   // [0, 1), 24 bits
+    
+    static constexpr std::uint64_t min() { return 0; }
+    static constexpr std::uint64_t max() { return UINT64_MAX; }
+    
+private:
+    static std::uint64_t rotateLeft(std::uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+    
+    std::uint64_t m_state[4];
+};
+
+enum class MapGeneratorKind {
+    RANDOM_FILL,    // Independent cells at the wall density
+    BACKTRACKER,    // Perfect maze by depth-first carving: long winding corridors
+    PRIM,           // Perfect maze grown from a random frontier: short dead ends
+    KRUSKAL,        // Perfect maze joining shuffled edges with union-find
+    CAVES,          // Random fill smoothed by a cellular automaton into open caverns
+    VALUE_NOISE     // Smooth multi-octave noise thresholded at the density, rows spread over threads
+};
+
+// Deterministic map generators writing a whole wall mask at once. The same
+// kind, size, density and seed always produce the same map, whatever the
+// thread count. Mazes carve corridors between the odd coordinates; the cells
+// passed as keepOpen are left open and, in mazes, joined to the nearest
+// corridor, so a start and goal placed anywhere stay connected.
+class MapGenerator {
+public:
+    MapGenerator();
+    
+    // walls gets width * height entries, 1 for a wall
+    void generate(MapGeneratorKind kind, int width, int height, std::uint64_t seed, float wallDensity,
+                  const std::vector<int>& keepOpen, std::vector<std::uint8_t>& walls);
+    
+    // weights gets width * height entries from 1 to maxWeight: value noise
+    // left as road (1) over about half the map, rising into heavy mud
+    void generateTerrain(int width, int height, std::uint64_t seed, int maxWeight, std::vector<std::uint8_t>& weights);
+    
+    static std::string getKindName(MapGeneratorKind kind);
+    static float getDefaultDensity(MapGeneratorKind kind);   // Ignored by the mazes
+    double getLastMs() const { return m_lastMs; }
+    
+private:
+    void fillRandom(float wallDensity);
+    void carveBacktracker();
+    void carvePrim();
+    void carveKruskal();
+    void growCaves(float wallDensity);
+    void fillValueNoise(std::uint64_t seed, float wallDensity);
+    void sampleValueNoise(std::uint64_t seed, const std::function<void(int, const float*)>& writeRow);   // Rows in any order
+    void joinToMaze(int cellIndex);
+    void openMazeCell(int mazeX, int mazeY) { m_walls[(2 * mazeY + 1) * m_width + 2 * mazeX + 1] = 0; }
+    void openMazePassage(int mazeX, int mazeY, int nextX, int nextY) {
+        m_walls[(mazeY + nextY + 1) * m_width + mazeX + nextX + 1] = 0;
+    }
+    
+    int m_width;
+    int m_height;
+    int m_mazeWidth;    // Maze cells per row, at the odd columns
+    int m_mazeHeight;
+    std::uint8_t* m_walls;
+    Xoshiro256 m_rng;
+    std::vector<std::int32_t> m_scratch;   // Backtracker stack, Prim frontier or Kruskal edge list
+    std::vector<std::int32_t> m_sets;      // Kruskal union-find parents
+    std::vector<std::uint8_t> m_visited;
+    double m_lastMs;
+};
\ No newline at end of file
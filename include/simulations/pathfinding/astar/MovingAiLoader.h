@@ -0,0 +1,37 @@
+#pragma once
+#include "AStarController.h"
+#include <istream>
+#include <string>
+#include <vector>
+
+// One line of a .scen file
+struct MovingAiScenario {
+    int bucket;
+    int startIndex;          // Linear cell indices into the loaded map
+    int goalIndex;
+    double optimalLength;    // Reference optimum: 8-connected, diagonals sqrt 2, no corner cutting
+};
+
+// Reader for the Moving AI grid benchmark format: a .map file holding a
+// "type / height / width / map" header and one text row per grid row, and a
+// .scen file listing start/goal pairs with their optimal length. The map is
+// streamed row by row straight into the grid's cell types, so a map is never
+// held as text. '.', 'G' and 'S' are passable; every other terrain ('@', 'O',
+// 'T', 'W') is a wall. On failure the load returns false and getError() says
+// where the input went wrong.
+class MovingAiLoader {
+public:
+    bool loadMap(std::istream& input, AStarGrid& grid);
+    bool loadMap(const std::string& path, AStarGrid& grid);
+    
+    // Rejects scenarios made for another map size or placed on a wall
+    bool loadScenarios(std::istream& input, const AStarGrid& grid, std::vector<MovingAiScenario>& scenarios);
+    bool loadScenarios(const std::string& path, const AStarGrid& grid, std::vector<MovingAiScenario>& scenarios);
+    
+    const std::string& getError() const { return m_error; }
+    
+private:
+    bool fail(const std::string& message);
+    
+    std::string m_error;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+// Compile-time policies for the A* expansion kernel. Each combination is
+// instantiated once, so the neighbor loop, edge costs, heuristic and
+// tie-break all inline into a single loop with no per-node dispatch.
+
+// Neighborhoods list straight moves first, in the order the trace has always
+// expanded them (up, down, left, right)
+struct FourConnected {
+    static constexpr int COUNT = 4;
+    static constexpr int DX[COUNT] = {0, 0, -1, 1};
+    static constexpr int DY[COUNT] = {-1, 1, 0, 0};
+    static constexpr bool isDiagonal(int) { return false; }
+    static constexpr float cost(int) { return 1.0f; }
+};
+
+struct EightConnected {
+    static constexpr int COUNT = 8;
+    static constexpr int DX[COUNT] = {0, 0, -1, 1, -1, 1, -1, 1};
+    static constexpr int DY[COUNT] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static constexpr bool isDiagonal(int direction) { return direction >= 4; }
+    static constexpr float cost(int direction) { return direction >= 4 ? 1.41421356f : 1.0f; }
+};
+
+// Heuristics take absolute axis distances
+struct ManhattanHeuristic {
+    static float estimate(int dx, int dy) { return static_cast<float>(dx + dy); }
+};
+
+struct OctileHeuristic {
+    static float estimate(int dx, int dy) {
+        return static_cast<float>(std::max(dx, dy)) + 0.41421356f * std::min(dx, dy);
+    }
+};
+
+struct EuclideanHeuristic {
+    static float estimate(int dx, int dy) { return std::sqrt(static_cast<float>(dx * dx + dy * dy)); }
+};
+
+struct ChebyshevHeuristic {
+    static float estimate(int dx, int dy) { return static_cast<float>(std::max(dx, dy)); }
+};
+
+struct ZeroHeuristic {
+    static float estimate(int, int) { return 0.0f; }
+};
+
+// Tag only: ALT reads the controller's landmark tables, by cell rather than by
+// axis distances, so the controller specializes its estimate for it
+struct LandmarkHeuristic {};
+
+// Secondary open-list key, compared only when f is equal
+struct HeapOrderTieBreak {
+    static float tie(float, float) { return 0.0f; }
+};
+
+struct LowHTieBreak {
+    static float tie(float, float h) { return h; }
+};
+
+struct LowGTieBreak {
+    static float tie(float g, float) { return g; }
+};
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include "QuicksortController.h"
+#include "PartitionKernels.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+// One traced action of a parallel run. Workers record into private buffers;
+// the global sequence number gives a merge order that respects every fork.
+struct ParallelTraceEvent {
+    std::uint64_t sequence;
+    QuicksortStepKind kind;
+    int workerId;
+    int pivotIndex;
+    int lowIndex;
+    int highIndex;
+    int swapFirst;    // -1 if the event moved nothing
+    int swapSecond;
+    int comparisons;  // Made by this worker since its previous event
+};
+
+struct ParallelScalingResult {
+    int threadCount;      // 0 for the serial baseline
+    double milliseconds;
+    double speedup;       // Relative to the serial baseline
+};
+
+// Task-based quicksort. Ranges above the fork cutoff are partitioned (median-of-three
+// Hoare) and one side is pushed onto the worker's deque for idle workers to steal;
+// ranges at or below it are finished by the worker that holds them.
+class ParallelQuicksort {
+public:
+    ParallelQuicksort(int workerCount, int forkCutoff);
+    
+    void sort(std::vector<int>& data);
+    // Same partitions and leaf sorts on the calling thread, with no worker pool
+    void sortSerial(std::vector<int>& data);
+    std::vector<ParallelTraceEvent> sortWithTrace(std::vector<int>& data);
+    
+    // Untraced sorts only; traced runs keep the scalar Hoare loop so each swap is recorded
+    void setPartitionKernel(PartitionKernel kernel) { m_kernel = kernel; }
+    
+    int getWorkerCount() const { return m_workerCount; }
+    PartitionKernel getPartitionKernel() const { return m_kernel; }
+    
+    // Times the untraced serial sort, then the pool at each thread count, on the same random input.
+    // The serial row comes first.
+    static std::vector<ParallelScalingResult> measureScaling(size_t elementCount, const std::vector<int>& threadCounts, unsigned int seed,
+                                                             PartitionKernel kernel = PartitionKernel::HOARE);
+    
+private:
+    struct Task {
+        int low;
+        int high;
+    };
+    
+    // Owner pushes and pops at the back, thieves take the oldest (largest) task from the front
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    template <bool Trace> void run(std::vector<int>& data);
+    template <bool Trace> void workerLoop(int workerId);
+    template <bool Trace> void processTask(Task task, int workerId);
+    template <bool Trace> void sortSequential(int low, int high, int workerId);
+    template <bool Trace> int partition(int low, int high, int workerId);
+    // After a lopsided untraced partition, moves copies of the pivot from the larger
+    // side next to it and narrows the sides to exclude them
+    void gatherPivotCopies(int low, int high, int pivot, int& leftHigh, int& rightLow);
+    
+    void pushTask(int workerId, Task task);
+    bool popTask(int workerId, Task& task);
+    bool stealTask(int workerId, unsigned int& victimSeed, Task& task);
+    void record(int workerId, QuicksortStepKind kind, int pivot, int low, int high, int swapFirst, int swapSecond, int& comparisons);
+    
+    int m_workerCount;
+    int m_forkCutoff;
+    PartitionKernel m_kernel;
+    std::vector<int>* m_data;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::atomic<int> m_pendingTasks;          // Pushed but not yet finished; workers stop at zero
+    std::atomic<std::uint64_t> m_sequence;
+    std::vector<std::vector<ParallelTraceEvent>> m_events;  // One buffer per worker
+};
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Native partition kernels for the untraced engines. Every kernel takes the
+// pivot from data[low], partitions data[low..high] in place and returns the
+// pivot's final index: everything left of it is <= pivot, everything right >= pivot.
+// All but HOARE put every copy of the pivot on one side, which leaves duplicate-heavy
+// ranges lopsided; ParallelQuicksort gathers those copies next to the pivot.
+enum class PartitionKernel {
+    HOARE,             // Same two-pointer scheme the visual trace steps through
+    LOMUTO,            // Single forward scan; copies of the pivot go right
+    BRANCHLESS_BLOCK,  // BlockQuicksort: buffer misplaced offsets, then swap without branches
+    AVX2               // 8-wide compare + compress via permutation table
+};
+
+struct PartitionKernelResult {
+    PartitionKernel kernel;
+    bool supported;            // AVX2 is skipped on CPUs without it
+    double elementsPerSecond;
+    long long branchMisses;    // Per run, -1 when hardware counters are unavailable
+};
+
+int partitionRange(PartitionKernel kernel, int* data, int low, int high);
+
+// Runtime CPUID/XGETBV check; false on non-x86 builds
+bool isPartitionKernelSupported(PartitionKernel kernel);
+std::string getPartitionKernelName(PartitionKernel kernel);
+
+// Partitions the same random input with each kernel and reports the best of
+// `repetitions` runs
+std::vector<PartitionKernelResult> measurePartitionKernels(size_t elementCount, int repetitions, unsigned int seed);
\ No newline at end of file
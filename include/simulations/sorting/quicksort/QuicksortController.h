@@ -1,7 +1,13 @@
 #pragma once
+#include "PartitionKernels.h"
+#include <algorithm>
 #include <vector>
+#include <deque>
 #include <functional>
 #include <string>
+#include <utility>
+#include <cstdint>
+#include <random>
 
 enum class QuicksortState {
     READY,
@@ -10,17 +16,94 @@ enum class QuicksortState {
     COMPLETED
 };
 
+// What a step shows. Drives bar colors and audio directly; the human-readable
+// description is only formatted when the HUD asks for it.
+enum class QuicksortStepKind : std::uint8_t {
+    START,
+    PROCESS_SUBARRAY,
+    PIVOT_SELECTED,      // low/high hold the left/right pointers
+    LEFT_SCAN,
+    RIGHT_SCAN,
+    SWAP_PENDING,
+    SWAPPED,
+    MOVE_POINTERS,
+    PIVOT_MOVE_PENDING,
+    PIVOT_PLACED,        // low/high hold the partitioned range
+    PIVOT_IN_PLACE,      // low/high hold the partitioned range
+    PIVOT_FINAL,
+    SORT_COMPLETE,
+    FINALE,
+    FINISHED,
+    
+    // Configurable engine. Pivot choices swap the chosen element into the
+    // pivot slot: pivotIndex is the slot, low/high the swapped pair.
+    PIVOT_MEDIAN_OF_THREE,
+    PIVOT_NINTHER,
+    PIVOT_RANDOM,
+    THREE_WAY_LESS,      // pivotIndex marks the start of the equal run
+    THREE_WAY_GREATER,
+    THREE_WAY_EQUAL,
+    THREE_WAY_DONE,      // low/high hold the equal run, already in final position
+    DUAL_PIVOTS_SELECTED,
+    DUAL_LESS,
+    DUAL_GREATER,
+    DUAL_MIDDLE,
+    DUAL_PIVOT_PLACED,
+    HEAPSORT_FALLBACK,   // low/high hold the range handed to heapsort
+    HEAP_SIFT,
+    HEAP_EXTRACT
+};
+
+enum class QuicksortPivotStrategy {
+    FIRST,               // arr[low], the classic OpenDSA choice
+    MEDIAN_OF_THREE,
+    NINTHER,             // Tukey's median of medians for large ranges
+    RANDOM
+};
+
+enum class QuicksortPartitionScheme {
+    HOARE,
+    THREE_WAY,           // Dijkstra <, ==, > partition for duplicate-heavy input
+    DUAL_PIVOT
+};
+
+// Engine configuration. Changes apply the next time the trace is generated,
+// so the same input can be re-run and the step counts compared.
+struct QuicksortEngineSettings {
+    QuicksortPivotStrategy pivotStrategy = QuicksortPivotStrategy::FIRST;
+    QuicksortPartitionScheme partitionScheme = QuicksortPartitionScheme::HOARE;
+    bool introsortFallback = false;  // Heapsort a range after log2(n) badly unbalanced partitions
+    unsigned int randomSeed = 1;     // Random pivots must replay identically on regeneration
+    int workerCount = 0;             // >0 runs the parallel engine (median-of-three Hoare) instead
+    int forkCutoff = 8;              // Parallel engine: ranges larger than this are forked
+    PartitionKernel partitionKernel = PartitionKernel::HOARE;  // Untraced native sorts; traces keep the scalar Hoare loop
+};
+
+// Steps are delta-encoded: instead of a full array snapshot each step records
+// the swap (if any) that produced it, so the controller can replay or undo it
+// against m_currentArray in O(1).
 struct QuicksortStep {
-    std::vector<int> array;
+    QuicksortStepKind kind;
     int pivotIndex;
     int lowIndex;
     int highIndex;
-    std::string description;
+    int swapFirst;   // Indices swapped when entering this step, -1 if the array is unchanged
+    int swapSecond;
+    int secondPivotIndex;  // Dual-pivot mode only, -1 otherwise
+    int workerId;          // Parallel engine worker that produced the step, -1 for the serial engine
     int operationCount;
     int comparisonCount;
     int swapCount;
 };
 
+// Full array snapshot taken every getKeyframeSpacing() steps so seek() only
+// has to replay a bounded number of deltas
+struct QuicksortKeyframe {
+    size_t stepIndex;
+    std::vector<int> array;
+    std::vector<int> owners;  // Parallel traces only
+};
+
 class QuicksortController {
 public:
     QuicksortController();
@@ -36,38 +119,137 @@ public:
     void fastForward();
     void slowDown();
     void speedUp();
+    void seek(size_t stepIndex);
     
     void setSpeed(float delayMs);
+    void setKeyframeInterval(size_t interval);
+    void setLazyGeneration(bool lazy);
+    void setHistoryLimit(size_t steps);
+    void setEngineSettings(const QuicksortEngineSettings& settings);
     void setStepCallback(std::function<void(const QuicksortStep&)> callback);
     
     QuicksortState getState() const { return m_state; }
     const std::vector<int>& getCurrentArray() const { return m_currentArray; }
+    const std::vector<int>& getBarOwners() const { return m_barOwners; }  // Worker per index, empty for serial traces
     const QuicksortStep& getCurrentStep() const { return m_currentStep; }
+    std::string getCurrentDescription() const;
     float getSpeed() const { return m_stepDelay; }
     size_t getCurrentStepIndex() const { return m_currentStepIndex; }
-    size_t getTotalSteps() const { return m_steps.size(); }
+    size_t getTotalSteps() const { return m_traceBase + m_steps.size(); }  // Steps generated so far
+    bool isTraceComplete() const { return m_generatorPhase == GeneratorPhase::DONE; }
+    bool isLazyGeneration() const { return m_lazyGeneration && !m_parallelTrace; }
+    bool isParallelTrace() const { return m_parallelTrace; }
+    size_t getKeyframeInterval() const { return m_keyframeInterval; }
+    // Never below the array size: a snapshot then costs about one int per
+    // step, so keyframes stay small next to the deltas however large n is
+    size_t getKeyframeSpacing() const { return std::max(m_keyframeInterval, m_originalArray.size()); }
+    size_t getHistoryLimit() const { return m_historyLimit; }
+    const QuicksortEngineSettings& getEngineSettings() const { return m_engineSettings; }
+    std::string getEngineDescription() const;
     int getOperationCount() const;
     int getComparisonCount() const;
     int getSwapCount() const;
+    size_t getTraceMemoryBytes() const;  // Retained steps plus keyframes
     
     void update(float deltaTime);
     
 private:
+    // Explicit state machine over the partition loop. Each transition emits at
+    // most one step, so the trace can be produced on demand.
+    enum class GeneratorPhase {
+        START,
+        NEXT_RANGE,
+        SELECT_PIVOT,
+        SELECT_SECOND_PIVOT,
+        PARTITION_BEGIN,
+        SCAN_LEFT,
+        SCAN_RIGHT,
+        CHECK_SWAP,
+        SWAP,
+        MOVE_POINTERS,
+        PLACE_PIVOT,
+        MOVE_PIVOT,
+        PARTITION_DONE,
+        THREE_WAY_BEGIN,
+        THREE_WAY_SCAN,
+        DUAL_BEGIN,
+        DUAL_SCAN,
+        DUAL_PLACE_LOW,
+        DUAL_PLACE_HIGH,
+        HEAP_BUILD,
+        HEAP_SIFT,
+        HEAP_EXTRACT,
+        SORT_COMPLETE,
+        FINALE,
+        DONE
+    };
+    
+    // Pending subarray; the budget counts how many more unbalanced partitions
+    // it may take before the introsort fallback switches to heapsort
+    struct PendingRange {
+        int low;
+        int high;
+        int badPartitionBudget;
+    };
+    
     void generateSteps();
-    void quicksortRecursive(std::vector<int>& arr, int low, int high, std::vector<QuicksortStep>& steps);
-    int partition(std::vector<int>& arr, int low, int high, std::vector<QuicksortStep>& steps);
-    void addStep(std::vector<QuicksortStep>& steps, const std::vector<int>& arr, int pivot, int low, int high, const std::string& desc, bool isComparison = false, bool isSwap = false);
-    void addFinaleSequence(std::vector<QuicksortStep>& steps, const std::vector<int>& arr);
+    void resetGenerator();
+    bool advanceGenerator();
+    bool ensureStepGenerated(size_t stepIndex);
+    void trimHistory();
+    const QuicksortStep& stepAt(size_t stepIndex) const { return m_steps[stepIndex - m_traceBase]; }
+    void swapElements(int first, int second);
+    int choosePivotIndex(int low, int high, QuicksortStepKind& kind);
+    int medianOfThree(int a, int b, int c);
+    void scheduleRanges(std::initializer_list<std::pair<int, int>> ranges);
+    void addStep(QuicksortStepKind kind, int pivot, int low, int high, bool isComparison = false, bool isSwap = false, int secondPivot = -1);
+    void applyStepDelta(const QuicksortStep& step);
+    void applyOwnerClaim(const QuicksortStep& step, std::vector<int>& owners) const;
+    void recordParallelTrace();
+    void rebuildKeyframes();
     
     std::vector<int> m_originalArray;
     std::vector<int> m_currentArray;
-    std::vector<QuicksortStep> m_steps;
+    std::vector<int> m_barOwners;
+    std::deque<QuicksortStep> m_steps;       // Retained window of the trace
+    std::deque<QuicksortKeyframe> m_keyframes;
+    size_t m_traceBase;                      // Absolute index of m_steps.front(), always a keyframe
     QuicksortStep m_currentStep;
     
     QuicksortState m_state;
     size_t m_currentStepIndex;
     float m_stepDelay;
     float m_timeSinceLastStep;
+    size_t m_keyframeInterval;
+    bool m_lazyGeneration;
+    size_t m_historyLimit;
+    QuicksortEngineSettings m_engineSettings;
+    
+    // Generator state
+    GeneratorPhase m_generatorPhase;
+    bool m_parallelTrace;    // Trace came from the parallel engine; always generated eagerly
+    std::vector<int> m_workingArray;
+    std::vector<int> m_workingOwners;
+    std::vector<PendingRange> m_rangeStack;  // Larger ranges pushed first under introsort, so depth is O(log n)
+    int m_rangeLow;
+    int m_rangeHigh;
+    int m_rangeBudget;
+    int m_pivotValue;
+    int m_pivotIndex;
+    int m_leftPointer;
+    int m_rightPointer;
+    int m_scanIndex;         // Three-way / dual-pivot scanner
+    int m_heapSize;
+    int m_heapBuildIndex;
+    int m_siftNode;
+    bool m_siftForBuild;     // Whether HEAP_SIFT returns to HEAP_BUILD or HEAP_EXTRACT
+    std::mt19937 m_pivotRng;
+    size_t m_finaleIndex;
+    
+    // Swap performed since the last recorded step, attached to the next addStep
+    int m_pendingSwapFirst;
+    int m_pendingSwapSecond;
+    int m_stepWorkerId;      // Worker id attached by addStep
     
     // Statistics tracking
     int m_totalOperations;
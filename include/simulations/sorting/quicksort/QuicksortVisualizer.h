@@ -1,12 +1,14 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "QuicksortController.h"
+#include "ParallelQuicksort.h"
 #include "core/AudioManager.h"
 #include "core/AnimationSystem.h"
 #include <vector>
 #include <string>
 #include <functional>
 #include <map>
+#include <future>
 
 struct ControlButton {
     std::string text;
@@ -30,15 +32,23 @@ private:
     void drawArray(sf::RenderWindow& window);
     void drawControls(sf::RenderWindow& window);
     void drawInfo(sf::RenderWindow& window);
+    void drawScrubBar(sf::RenderWindow& window);
+    bool handleScrub(int mouseX, int mouseY);
     void onQuicksortStep(const QuicksortStep& step);
     
     void initializeControls();
     void navigateControlsLeft();
     void navigateControlsRight();
     void selectControl();
+    void applyEngineSettings(const QuicksortEngineSettings& settings);
+    void startScalingBenchmark();
+    void pollScalingBenchmark();
+    void startKernelBenchmark();
+    void pollKernelBenchmark();
     void renderControlButton(sf::RenderWindow& window, const ControlButton& button, float x, float y, bool selected);
     
     sf::Color getBarColor(int index, const QuicksortStep& step);
+    sf::Color getWorkerColor(int workerId) const;
     void updateBarPositions();
     
     QuicksortController* m_controller;
@@ -70,6 +80,11 @@ private:
     float m_barWidth;
     float m_barSpacing;
     
+    // Timeline scrub bar (click or drag to seek)
+    float m_scrubBarY;
+    float m_scrubBarHeight;
+    bool m_scrubbing;
+    
     // Animation system for smooth easing transitions
     AnimationSystem m_animationSystem;
     std::map<int, int> m_barAnimationIds;  // Map bar index to animation ID
@@ -89,4 +104,10 @@ private:
     int m_comparisonCount;
     int m_swapCount;
     float m_currentSpeed;
+    std::string m_previousEngineRun;  // Step count of the engine before the last switch
+    
+    // Native benchmarks, run off the render thread; the HUD shows the latest result
+    std::future<std::vector<ParallelScalingResult>> m_scalingFuture;
+    std::future<std::vector<PartitionKernelResult>> m_kernelFuture;
+    std::string m_benchmarkSummary;
 };
\ No newline at end of file
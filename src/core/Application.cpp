@@ -205,6 +205,8 @@ void Application::initializeQuicksortDemo() {
     std::shuffle(demoArray.begin(), demoArray.end(), gen);
     
     // Initialize controller with demo data and configuration
+    m_quicksortController->setLazyGeneration(simSettings.lazyStepGeneration);
+    m_quicksortController->setHistoryLimit(static_cast<size_t>(simSettings.stepHistoryLimit));
     m_quicksortController->initialize(demoArray);
     
     // Apply speed setting from configuration
@@ -240,9 +242,13 @@ void Application::initializeAStarDemo() {
     int startX = 2, startY = 2;
     int goalX = 27, goalY = 17;
     
+    const auto& simSettings = m_configManager->getSimulationSettings();
+    m_astarController->setLazyGeneration(simSettings.lazyStepGeneration);
+    m_astarController->setHistoryLimit(static_cast<size_t>(simSettings.stepHistoryLimit));
     m_astarController->initialize(gridWidth, gridHeight, startX, startY, goalX, goalY);
     
-    // Add some walls to make it interesting
+    // Add some walls to make it interesting; one batch so the plan is repaired once
+    m_astarController->beginEdit();
     // Vertical wall
     for (int y = 3; y < 16; ++y) {
         m_astarController->setWall(12, y);
@@ -264,6 +270,7 @@ void Application::initializeAStarDemo() {
     m_astarController->setWall(22, 5);
     m_astarController->setWall(5, 15);
     m_astarController->setWall(6, 15);
+    m_astarController->commitEdit();
     
     std::cout << "A* demo initialized with " << gridWidth << "x" << gridHeight << " grid\n";
 }
@@ -52,7 +52,9 @@ bool ConfigManager::saveConfig(const std::string& filename) {
     file << "        \"default_speed\": " << m_simulationSettings.defaultSpeed << ",\n";
     file << "        \"default_array_size\": " << m_simulationSettings.defaultArraySize << ",\n";
     file << "        \"min_array_size\": " << m_simulationSettings.minArraySize << ",\n";
-    file << "        \"max_array_size\": " << m_simulationSettings.maxArraySize << "\n";
+    file << "        \"max_array_size\": " << m_simulationSettings.maxArraySize << ",\n";
+    file << "        \"lazy_step_generation\": " << (m_simulationSettings.lazyStepGeneration ? "true" : "false") << ",\n";
+    file << "        \"step_history_limit\": " << m_simulationSettings.stepHistoryLimit << "\n";
     file << "    }\n";
     file << "}\n";
     
@@ -85,6 +87,7 @@ void ConfigManager::parseJsonConfig(const std::string& jsonContent) {
         else if (key == "default_array_size") m_simulationSettings.defaultArraySize = value;
         else if (key == "min_array_size") m_simulationSettings.minArraySize = value;
         else if (key == "max_array_size") m_simulationSettings.maxArraySize = value;
+        else if (key == "step_history_limit") m_simulationSettings.stepHistoryLimit = value;
         
         // Also store in legacy map
         m_settings[key] = match[2].str();
@@ -102,6 +105,7 @@ void ConfigManager::parseJsonConfig(const std::string& jsonContent) {
         if (key == "fullscreen") m_displaySettings.fullscreen = value;
         else if (key == "vsync") m_displaySettings.vsync = value;
         else if (key == "enabled") m_audioSettings.enabled = value;
+        else if (key == "lazy_step_generation") m_simulationSettings.lazyStepGeneration = value;
         
         // Also store in legacy map
         m_settings[key] = match[2].str();
@@ -0,0 +1,92 @@
+#include "core/TraceLogger.h"
+#include <fstream>
+
+static_assert((TraceLogger::CAPACITY & (TraceLogger::CAPACITY - 1)) == 0, "Trace capacity must be a power of two");
+
+TraceLogger& TraceLogger::instance() {
+    static TraceLogger logger;
+    return logger;
+}
+
+void TraceLogger::log(TraceLevel level, const char* format) {
+    write(level, format, nullptr, 0);
+}
+
+void TraceLogger::write(TraceLevel level, const char* format, const std::int64_t* args, size_t argCount) {
+    std::uint64_t index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Entry& entry = m_entries[index & (CAPACITY - 1)];
+    
+    // Per-slot seqlock: readers discard the slot unless the sequence is even
+    // and unchanged across their copy
+    entry.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    entry.format.store(format, std::memory_order_relaxed);
+    entry.level.store(level, std::memory_order_relaxed);
+    entry.argCount.store(static_cast<std::uint8_t>(argCount), std::memory_order_relaxed);
+    for (size_t i = 0; i < argCount; i++) {
+        entry.args[i].store(args[i], std::memory_order_relaxed);
+    }
+    
+    entry.sequence.store(2 * (index + 1), std::memory_order_release);
+}
+
+bool TraceLogger::dumpTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    static const char* levelNames[] = { "DEBUG", "INFO", "WARN" };
+    
+    std::uint64_t end = m_writeIndex.load(std::memory_order_acquire);
+    std::uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    
+    for (std::uint64_t index = begin; index < end; index++) {
+        const Entry& entry = m_entries[index & (CAPACITY - 1)];
+        
+        std::uint64_t sequence = entry.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * (index + 1)) continue;  // Still being written or already overwritten
+        
+        const char* format = entry.format.load(std::memory_order_relaxed);
+        TraceLevel level = entry.level.load(std::memory_order_relaxed);
+        size_t argCount = entry.argCount.load(std::memory_order_relaxed);
+        std::int64_t args[MAX_ARGS];
+        for (size_t i = 0; i < argCount && i < MAX_ARGS; i++) {
+            args[i] = entry.args[i].load(std::memory_order_relaxed);
+        }
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.sequence.load(std::memory_order_relaxed) != sequence || !format) continue;
+        
+        // Substitute "{}" placeholders in order
+        std::string line;
+        size_t nextArg = 0;
+        for (const char* c = format; *c; c++) {
+            if (c[0] == '{' && c[1] == '}' && nextArg < argCount) {
+                line += std::to_string(args[nextArg++]);
+                c++;
+            } else {
+                line += *c;
+            }
+        }
+        
+        file << "[" << index << "] " << levelNames[static_cast<int>(level)] << ": " << line << "\n";
+    }
+    
+    return file.good();
+}
+
+void TraceLogger::clear() {
+    // Entries are only ever read through the write index, so rewinding it is enough
+    // as long as no writer is active
+    m_writeIndex.store(0, std::memory_order_release);
+    for (Entry& entry : m_entries) {
+        entry.sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t TraceLogger::getEntryCount() const {
+    std::uint64_t written = m_writeIndex.load(std::memory_order_relaxed);
+    return static_cast<size_t>(written < CAPACITY ? written : CAPACITY);
+}
\ No newline at end of file
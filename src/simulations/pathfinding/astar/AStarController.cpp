@@ -1,27 +1,73 @@
 #include "simulations/pathfinding/astar/AStarController.h"
+#include "simulations/pathfinding/astar/SearchPolicies.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
-#include <ctime>
 #include <cstdlib>
-#include <unordered_map>
 #include <limits>
 #include <queue>
 
+// HPA* sector edge; the 30x20 demo grid splits into 3x2 sectors
+static const int PLANNER_SECTOR_SIZE = 10;
+
+void AStarGrid::resize(int gridWidth, int gridHeight) {
+    width = gridWidth;
+    height = gridHeight;
+    size_t cellCount = static_cast<size_t>(gridWidth) * gridHeight;
+    // Cells start unvisited, which is exactly the state a search begins from
+    types.assign(cellCount, CellType::EMPTY);
+    weights.assign(cellCount, 1);
+    gCost.assign(cellCount, std::numeric_limits<float>::infinity());
+    hCost.assign(cellCount, 0.0f);
+    fCost.assign(cellCount, std::numeric_limits<float>::infinity());
+    parent.assign(cellCount, -1);
+}
+
+size_t AStarGrid::getMemoryBytes() const {
+    return sizeof(AStarGrid) + types.capacity() * sizeof(CellType) + weights.capacity() +
+           (gCost.capacity() + hCost.capacity() + fCost.capacity()) * sizeof(float) +
+           parent.capacity() * sizeof(std::int32_t);
+}
+
 AStarController::AStarController() 
-    : m_state(AStarState::READY)
-    , m_currentStepIndex(0)
-    , m_stepDelay(1000.0f)  // 1 second per step initially
-    , m_timeSinceLastStep(0.0f)
+    : m_traceBase(0)
     , m_gridWidth(0)
     , m_gridHeight(0)
     , m_startX(0)
     , m_startY(0)
     , m_goalX(0)
     , m_goalY(0)
+    , m_state(AStarState::READY)
+    , m_currentStepIndex(0)
+    , m_stepDelay(1000.0f)  // 1 second per step initially
+    , m_timeSinceLastStep(0.0f)
+    , m_lazyGeneration(false)
+    , m_historyLimit(65536)
+    , m_keyframeInterval(1024)
+    , m_openListKind(AStarOpenListKind::INDEXED_HEAP)
+    , m_searchEngine(AStarSearchEngine::ASTAR)
+    , m_neighborhood(AStarNeighborhood::FOUR)
+    , m_heuristic(AStarHeuristic::MANHATTAN)
+    , m_tieBreak(AStarTieBreak::HEAP_ORDER)
+    , m_searchPhase(SearchPhase::DONE)
+    , m_expandKernel(nullptr)
+    , m_bucketSearch(false)
+    , m_searchGeneration(0)
+    , m_openCount(0)
+    , m_closedCount(0)
+    , m_pathIndex(0)
+    , m_jumpTablesDirty(true)
+    , m_weightedCellCount(0)
+    , m_editDepth(0)
+    , m_editPending(false)
     , m_totalSteps(0)
     , m_currentOpenListSize(0)
     , m_currentClosedListSize(0)
+    , m_plannerKind(AStarPlannerKind::INCREMENTAL)
+    , m_flowFieldDirty(true)
+    , m_mapKind(MapGeneratorKind::RANDOM_FILL)
+    , m_mapSeed(0)
 {
 }
 
@@ -29,6 +75,25 @@ AStarController::~AStarController() {
 }
 
 void AStarController::initialize(int gridWidth, int gridHeight, int startX, int startY, int goalX, int goalY) {
+    m_originalGrid.resize(gridWidth, gridHeight);
+    initializeFromOriginalGrid(startX, startY, goalX, goalY);
+}
+
+void AStarController::initialize(const AStarGrid& walls, int startX, int startY, int goalX, int goalY) {
+    // Only the walls and weights are taken; costs and parents start unvisited
+    m_originalGrid.resize(walls.width, walls.height);
+    for (int i = 0; i < walls.size(); i++) {
+        if (walls.types[i] == CellType::WALL) m_originalGrid.types[i] = CellType::WALL;
+    }
+    if (walls.weights.size() == m_originalGrid.weights.size()) {
+        m_originalGrid.weights = walls.weights;
+    }
+    initializeFromOriginalGrid(startX, startY, goalX, goalY);
+}
+
+void AStarController::initializeFromOriginalGrid(int startX, int startY, int goalX, int goalY) {
+    int gridWidth = m_originalGrid.width;
+    int gridHeight = m_originalGrid.height;
     m_gridWidth = gridWidth;
     m_gridHeight = gridHeight;
     m_startX = startX;
@@ -36,19 +101,9 @@ void AStarController::initialize(int gridWidth, int gridHeight, int startX, int
     m_goalX = goalX;
     m_goalY = goalY;
     
-    // Initialize grid
-    m_originalGrid.clear();
-    m_originalGrid.resize(gridHeight);
-    for (int y = 0; y < gridHeight; ++y) {
-        m_originalGrid[y].resize(gridWidth);
-        for (int x = 0; x < gridWidth; ++x) {
-            m_originalGrid[y][x] = GridCell(x, y);
-        }
-    }
-    
     // Set start and goal
-    m_originalGrid[startY][startX].type = CellType::START;
-    m_originalGrid[goalY][goalX].type = CellType::GOAL;
+    m_originalGrid.types[m_originalGrid.index(startX, startY)] = CellType::START;
+    m_originalGrid.types[m_originalGrid.index(goalX, goalY)] = CellType::GOAL;
     
     m_currentGrid = m_originalGrid;
     m_state = AStarState::READY;
@@ -56,10 +111,25 @@ void AStarController::initialize(int gridWidth, int gridHeight, int startX, int
     m_timeSinceLastStep = 0.0f;
     m_totalSteps = 0;
     
+    m_weightedCellCount = static_cast<int>(
+        std::count_if(m_originalGrid.weights.begin(), m_originalGrid.weights.end(), [](std::uint8_t w) { return w > 1; }));
+    m_jumpTablesDirty = true;
+    m_planner.initialize(gridWidth, gridHeight, m_originalGrid.index(startX, startY), m_originalGrid.index(goalX, goalY),
+                         m_neighborhood == AStarNeighborhood::EIGHT);
+    m_hierarchical.initialize(gridWidth, gridHeight, PLANNER_SECTOR_SIZE);
+    m_reachability.initialize(gridWidth, gridHeight);
+    m_flowField.initialize(gridWidth, gridHeight, m_neighborhood == AStarNeighborhood::EIGHT);
+    m_flowFieldDirty = true;
+    m_landmarks.initialize(gridWidth, gridHeight, m_neighborhood == AStarNeighborhood::EIGHT);
+    for (int i = 0; i < m_originalGrid.size(); i++) {
+        if (m_originalGrid.weights[i] > 1) m_planner.setWeight(i, m_originalGrid.weights[i]);
+        if (m_originalGrid.types[i] == CellType::WALL) setPlannerBlocked(i, true);
+    }
+    repairPlan();
     generateSteps();
     
-    if (!m_steps.empty()) {
-        m_currentStep = m_steps[0];
+    if (getTotalSteps() > 0) {
+        m_currentStep = stepAt(0);
         if (m_stepCallback) {
             m_stepCallback(m_currentStep);
         }
@@ -68,44 +138,30 @@ void AStarController::initialize(int gridWidth, int gridHeight, int startX, int
 
 void AStarController::setWall(int x, int y) {
     if (x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight &&
-        !(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY)) {
-        m_originalGrid[y][x].type = CellType::WALL;
-        m_currentGrid[y][x].type = CellType::WALL;
-        // Regenerate steps if we're in ready state
-        if (m_state == AStarState::READY) {
-            generateSteps();
-            if (!m_steps.empty()) {
-                m_currentStep = m_steps[0];
-                if (m_stepCallback) {
-                    m_stepCallback(m_currentStep);
-                }
-            }
-        }
+        !(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY) &&
+        m_originalGrid.types[m_originalGrid.index(x, y)] != CellType::WALL) {
+        m_originalGrid.types[m_originalGrid.index(x, y)] = CellType::WALL;
+        m_currentGrid.types[m_currentGrid.index(x, y)] = CellType::WALL;
+        setPlannerBlocked(m_originalGrid.index(x, y), true);
+        commitChange();
     }
 }
 
 void AStarController::clearWall(int x, int y) {
     if (x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight &&
-        !(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY)) {
-        m_originalGrid[y][x].type = CellType::EMPTY;
-        m_currentGrid[y][x].type = CellType::EMPTY;
-        // Regenerate steps if we're in ready state
-        if (m_state == AStarState::READY) {
-            generateSteps();
-            if (!m_steps.empty()) {
-                m_currentStep = m_steps[0];
-                if (m_stepCallback) {
-                    m_stepCallback(m_currentStep);
-                }
-            }
-        }
+        !(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY) &&
+        m_originalGrid.types[m_originalGrid.index(x, y)] == CellType::WALL) {
+        m_originalGrid.types[m_originalGrid.index(x, y)] = CellType::EMPTY;
+        m_currentGrid.types[m_currentGrid.index(x, y)] = CellType::EMPTY;
+        setPlannerBlocked(m_originalGrid.index(x, y), false);
+        commitChange();
     }
 }
 
 void AStarController::toggleWall(int x, int y) {
     if (x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight &&
         !(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY)) {
-        if (m_originalGrid[y][x].type == CellType::WALL) {
+        if (m_originalGrid.types[m_originalGrid.index(x, y)] == CellType::WALL) {
             clearWall(x, y);
         } else {
             setWall(x, y);
@@ -113,101 +169,157 @@ void AStarController::toggleWall(int x, int y) {
     }
 }
 
+void AStarController::setWalls(const std::vector<std::pair<int, int>>& cells) {
+    for (const auto& cell : cells) {
+        int x = cell.first;
+        int y = cell.second;
+        if (x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight &&
+            !(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY)) {
+            m_originalGrid.types[m_originalGrid.index(x, y)] = CellType::WALL;
+            m_currentGrid.types[m_currentGrid.index(x, y)] = CellType::WALL;
+            setPlannerBlocked(m_originalGrid.index(x, y), true);
+        }
+    }
+    commitChange();
+}
+
 void AStarController::setStart(int x, int y) {
     if (x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight &&
-        m_originalGrid[y][x].type != CellType::WALL && !(x == m_goalX && y == m_goalY)) {
+        m_originalGrid.types[m_originalGrid.index(x, y)] != CellType::WALL && !(x == m_goalX && y == m_goalY)) {
         // Clear old start
-        m_originalGrid[m_startY][m_startX].type = CellType::EMPTY;
-        m_currentGrid[m_startY][m_startX].type = CellType::EMPTY;
+        m_originalGrid.types[m_originalGrid.index(m_startX, m_startY)] = CellType::EMPTY;
+        m_currentGrid.types[m_currentGrid.index(m_startX, m_startY)] = CellType::EMPTY;
         // Set new start
         m_startX = x;
         m_startY = y;
-        m_originalGrid[y][x].type = CellType::START;
-        m_currentGrid[y][x].type = CellType::START;
-        // Regenerate steps
-        if (m_state == AStarState::READY) {
-            generateSteps();
-            if (!m_steps.empty()) {
-                m_currentStep = m_steps[0];
-                if (m_stepCallback) {
-                    m_stepCallback(m_currentStep);
-                }
-            }
-        }
+        m_originalGrid.types[m_originalGrid.index(x, y)] = CellType::START;
+        m_currentGrid.types[m_currentGrid.index(x, y)] = CellType::START;
+        m_planner.setStart(m_originalGrid.index(x, y));
+        commitChange();
     }
 }
 
 void AStarController::setGoal(int x, int y) {
     if (x >= 0 && x < m_gridWidth && y >= 0 && y < m_gridHeight &&
-        m_originalGrid[y][x].type != CellType::WALL && !(x == m_startX && y == m_startY)) {
+        m_originalGrid.types[m_originalGrid.index(x, y)] != CellType::WALL && !(x == m_startX && y == m_startY)) {
         // Clear old goal
-        m_originalGrid[m_goalY][m_goalX].type = CellType::EMPTY;
-        m_currentGrid[m_goalY][m_goalX].type = CellType::EMPTY;
+        m_originalGrid.types[m_originalGrid.index(m_goalX, m_goalY)] = CellType::EMPTY;
+        m_currentGrid.types[m_currentGrid.index(m_goalX, m_goalY)] = CellType::EMPTY;
         // Set new goal
         m_goalX = x;
         m_goalY = y;
-        m_originalGrid[y][x].type = CellType::GOAL;
-        m_currentGrid[y][x].type = CellType::GOAL;
-        // Regenerate steps
-        if (m_state == AStarState::READY) {
-            generateSteps();
-            if (!m_steps.empty()) {
-                m_currentStep = m_steps[0];
-                if (m_stepCallback) {
-                    m_stepCallback(m_currentStep);
-                }
-            }
-        }
+        m_originalGrid.types[m_originalGrid.index(x, y)] = CellType::GOAL;
+        m_currentGrid.types[m_currentGrid.index(x, y)] = CellType::GOAL;
+        m_planner.setGoal(m_originalGrid.index(x, y));
+        commitChange();
+    }
+}
+
+void AStarController::beginEdit() {
+    m_editDepth++;
+}
+
+void AStarController::commitEdit() {
+    if (m_editDepth == 0) return;
+    if (--m_editDepth == 0 && m_editPending) {
+        m_editPending = false;
+        repairPlan();
+        regenerateIfReady();
+    }
+}
+
+void AStarController::commitChange() {
+    m_jumpTablesDirty = true;
+    m_flowFieldDirty = true;
+    
+    // Inside a batch the repair and trace reset wait for the outermost commit
+    if (m_editDepth > 0) {
+        m_editPending = true;
+        return;
     }
+    repairPlan();
+    regenerateIfReady();
 }
 
 void AStarController::clearGrid() {
     for (int y = 0; y < m_gridHeight; ++y) {
         for (int x = 0; x < m_gridWidth; ++x) {
             if (!(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY)) {
-                m_originalGrid[y][x].type = CellType::EMPTY;
-                m_currentGrid[y][x].type = CellType::EMPTY;
-            }
-        }
-    }
-    if (m_state == AStarState::READY) {
-        generateSteps();
-        if (!m_steps.empty()) {
-            m_currentStep = m_steps[0];
-            if (m_stepCallback) {
-                m_stepCallback(m_currentStep);
+                m_originalGrid.types[m_originalGrid.index(x, y)] = CellType::EMPTY;
+                m_currentGrid.types[m_currentGrid.index(x, y)] = CellType::EMPTY;
+                setPlannerBlocked(m_originalGrid.index(x, y), false);
             }
         }
     }
+    commitChange();
 }
 
 void AStarController::generateRandomMaze(float wallDensity) {
-    clearGrid();
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    generateMap(MapGeneratorKind::RANDOM_FILL, m_mapSeed + 1, wallDensity);
+}
+
+void AStarController::generateMap(MapGeneratorKind kind, std::uint64_t seed, float wallDensity) {
+    m_mapKind = kind;
+    m_mapSeed = seed;
+    std::vector<std::uint8_t> walls;
+    std::vector<int> keepOpen = {m_originalGrid.index(m_startX, m_startY), m_originalGrid.index(m_goalX, m_goalY)};
+    m_mapGenerator.generate(kind, m_gridWidth, m_gridHeight, seed, wallDensity, keepOpen, walls);
     
-    for (int y = 0; y < m_gridHeight; ++y) {
-        for (int x = 0; x < m_gridWidth; ++x) {
-            if (!(x == m_startX && y == m_startY) && !(x == m_goalX && y == m_goalY)) {
-                if (static_cast<float>(std::rand()) / RAND_MAX < wallDensity) {
-                    m_originalGrid[y][x].type = CellType::WALL;
-                    m_currentGrid[y][x].type = CellType::WALL;
-                }
-            }
-        }
+    // The planners hear only about cells that changed; the repair and trace run once, at the commit
+    for (int i = 0; i < m_originalGrid.size(); i++) {
+        CellType type = m_originalGrid.types[i];
+        bool wall = walls[i] != 0;
+        if (type == CellType::START || type == CellType::GOAL || (type == CellType::WALL) == wall) continue;
+        m_originalGrid.types[i] = wall ? CellType::WALL : CellType::EMPTY;
+        m_currentGrid.types[i] = m_originalGrid.types[i];
+        setPlannerBlocked(i, wall);
     }
-    
-    if (m_state == AStarState::READY) {
-        generateSteps();
-        if (!m_steps.empty()) {
-            m_currentStep = m_steps[0];
-            if (m_stepCallback) {
-                m_stepCallback(m_currentStep);
-            }
-        }
+    commitChange();
+}
+
+void AStarController::setCellWeight(int x, int y, int weight) {
+    if (!m_originalGrid.inBounds(x, y)) return;
+    int cellIndex = m_originalGrid.index(x, y);
+    weight = std::max(1, std::min(MAX_CELL_WEIGHT, weight));
+    if (m_originalGrid.weights[cellIndex] != weight) {
+        writeWeight(cellIndex, weight);
+        commitChange();
     }
 }
 
+void AStarController::setWeights(const std::vector<std::uint8_t>& weights) {
+    if (weights.size() != m_originalGrid.weights.size()) return;
+    for (int i = 0; i < m_originalGrid.size(); i++) {
+        writeWeight(i, std::max(1, std::min(MAX_CELL_WEIGHT, static_cast<int>(weights[i]))));
+    }
+    commitChange();
+}
+
+void AStarController::generateTerrain(std::uint64_t seed, int maxWeight) {
+    std::vector<std::uint8_t> weights;
+    m_mapGenerator.generateTerrain(m_gridWidth, m_gridHeight, seed, std::min(MAX_CELL_WEIGHT, maxWeight), weights);
+    setWeights(weights);
+}
+
+void AStarController::clearWeights() {
+    setWeights(std::vector<std::uint8_t>(m_originalGrid.weights.size(), 1));
+}
+
+void AStarController::writeWeight(int cellIndex, int weight) {
+    int oldWeight = m_originalGrid.weights[cellIndex];
+    if (oldWeight == weight) return;
+    m_weightedCellCount += (weight > 1) - (oldWeight > 1);
+    m_originalGrid.weights[cellIndex] = static_cast<std::uint8_t>(weight);
+    m_currentGrid.weights[cellIndex] = static_cast<std::uint8_t>(weight);
+    m_planner.setWeight(cellIndex, weight);   // HPA* plans on walls alone
+}
+
 void AStarController::start() {
+    if (m_state == AStarState::READY && !m_lazyGeneration) {
+        // Edits defer the trace; eager mode still has all of it once playback begins
+        while (advanceSearch()) {
+        }
+    }
     if (m_state == AStarState::READY || m_state == AStarState::PAUSED) {
         m_state = AStarState::SEARCHING;
     }
@@ -233,8 +345,8 @@ void AStarController::reset() {
     
     generateSteps();
     
-    if (!m_steps.empty()) {
-        m_currentStep = m_steps[0];
+    if (getTotalSteps() > 0) {
+        m_currentStep = stepAt(0);
         if (m_stepCallback) {
             m_stepCallback(m_currentStep);
         }
@@ -242,52 +354,85 @@ void AStarController::reset() {
 }
 
 void AStarController::step() {
-    if (m_currentStepIndex < m_steps.size() - 1) {
+    if (!ensureStepGenerated(m_currentStepIndex + 1)) return;
+    
+    if (m_currentStepIndex < m_traceBase) {
+        // Generating ahead evicted the step on screen; rebuild from the window base
+        moveToStep(m_currentStepIndex + 1, true);
+    } else {
         m_currentStepIndex++;
-        m_currentStep = m_steps[m_currentStepIndex];
-        m_currentGrid = m_currentStep.grid;
-        
-        if (m_stepCallback) {
-            m_stepCallback(m_currentStep);
-        }
-        
-        if (m_currentStepIndex >= m_steps.size() - 1) {
-            if (m_currentStep.description.find("Path found!") != std::string::npos) {
-                m_state = AStarState::PATH_FOUND;
-            } else {
-                m_state = AStarState::NO_PATH_EXISTS;
-            }
-        }
+        applyStepChanges(stepAt(m_currentStepIndex), m_currentGrid, true);
+    }
+    m_currentStep = stepAt(m_currentStepIndex);
+    
+    if (m_stepCallback) {
+        m_stepCallback(m_currentStep);
+    }
+    
+    if (isTraceComplete() && m_currentStepIndex >= getTotalSteps() - 1) {
+        updateTerminalState();
     }
 }
 
 void AStarController::stepBack() {
-    if (m_currentStepIndex > 0) {
-        m_currentStepIndex--;
-        m_currentStep = m_steps[m_currentStepIndex];
-        m_currentGrid = m_currentStep.grid;
-        
-        if (m_stepCallback) {
-            m_stepCallback(m_currentStep);
-        }
+    if (m_currentStepIndex == 0) return;
+    
+    if (m_currentStepIndex - 1 < m_traceBase) {
+        // Previous step was evicted from the history window
+        seek(m_currentStepIndex - 1);
+        return;
+    }
+    
+    applyStepChanges(stepAt(m_currentStepIndex), m_currentGrid, false);
+    m_currentStepIndex--;
+    m_currentStep = stepAt(m_currentStepIndex);
+    
+    if (m_stepCallback) {
+        m_stepCallback(m_currentStep);
     }
 }
 
 void AStarController::fastForward() {
-    if (!m_steps.empty()) {
-        m_currentStepIndex = m_steps.size() - 1;
-        m_currentStep = m_steps[m_currentStepIndex];
-        m_currentGrid = m_currentStep.grid;
-        
-        if (m_currentStep.description.find("Path found!") != std::string::npos) {
-            m_state = AStarState::PATH_FOUND;
-        } else {
-            m_state = AStarState::NO_PATH_EXISTS;
-        }
-        
-        if (m_stepCallback) {
-            m_stepCallback(m_currentStep);
-        }
+    while (advanceSearch()) {
+    }
+    if (getTotalSteps() > 0) {
+        seek(getTotalSteps() - 1);
+    }
+}
+
+void AStarController::seek(size_t stepIndex) {
+    if (getTotalSteps() == 0) return;
+    
+    ensureStepGenerated(stepIndex);
+    size_t target = std::min(stepIndex, getTotalSteps() - 1);
+    bool restore = m_currentStepIndex < m_traceBase;
+    
+    if (target < m_traceBase) {
+        // History before the retained window was discarded; regenerate from the start
+        generateSteps();
+        ensureStepGenerated(target);
+        restore = true;
+    }
+    
+    moveToStep(target, restore);
+    m_currentStep = stepAt(m_currentStepIndex);
+    
+    if (isTraceComplete() && m_currentStepIndex >= getTotalSteps() - 1) {
+        updateTerminalState();
+    } else if (m_state == AStarState::PATH_FOUND || m_state == AStarState::NO_PATH_EXISTS) {
+        m_state = AStarState::PAUSED;
+    }
+    
+    if (m_stepCallback) {
+        m_stepCallback(m_currentStep);
+    }
+}
+
+void AStarController::updateTerminalState() {
+    if (m_currentStep.kind == AStarStepKind::PATH_FOUND) {
+        m_state = AStarState::PATH_FOUND;
+    } else {
+        m_state = AStarState::NO_PATH_EXISTS;
     }
 }
 
@@ -295,6 +440,161 @@ void AStarController::setSpeed(float delayMs) {
     m_stepDelay = delayMs;
 }
 
+void AStarController::setKeyframeInterval(size_t interval) {
+    m_keyframeInterval = std::max<size_t>(1, interval);
+    rebuildKeyframes();
+}
+
+void AStarController::setLazyGeneration(bool lazy) {
+    // Takes effect the next time the trace is generated
+    m_lazyGeneration = lazy;
+}
+
+void AStarController::setHistoryLimit(size_t steps) {
+    // 0 keeps the whole trace; only applies in lazy mode
+    m_historyLimit = steps;
+    trimHistory();
+}
+
+void AStarController::setOpenListKind(AStarOpenListKind kind) {
+    // Takes effect the next time the trace is generated
+    m_openListKind = kind;
+}
+
+void AStarController::setSearchEngine(AStarSearchEngine engine) {
+    // Takes effect the next time the trace is generated
+    m_searchEngine = engine;
+}
+
+void AStarController::setNeighborhood(AStarNeighborhood neighborhood) {
+    // The trace picks it up next time it is generated; the planner replans now
+    if (neighborhood == m_neighborhood) return;
+    m_neighborhood = neighborhood;
+    if (m_originalGrid.empty()) return;
+    
+    m_planner.initialize(m_gridWidth, m_gridHeight, m_originalGrid.index(m_startX, m_startY),
+                         m_originalGrid.index(m_goalX, m_goalY), neighborhood == AStarNeighborhood::EIGHT);
+    m_flowField.initialize(m_gridWidth, m_gridHeight, neighborhood == AStarNeighborhood::EIGHT);
+    m_flowFieldDirty = true;
+    m_landmarks.initialize(m_gridWidth, m_gridHeight, neighborhood == AStarNeighborhood::EIGHT);
+    for (int i = 0; i < m_originalGrid.size(); i++) {
+        if (m_originalGrid.weights[i] > 1) m_planner.setWeight(i, m_originalGrid.weights[i]);
+        if (m_originalGrid.types[i] == CellType::WALL) {
+            m_planner.setBlocked(i, true);
+            m_flowField.setBlocked(i, true);
+            m_landmarks.setBlocked(i, true);
+        }
+    }
+    repairPlan();
+}
+
+void AStarController::setHeuristic(AStarHeuristic heuristic) {
+    // Takes effect the next time the trace is generated
+    m_heuristic = heuristic;
+}
+
+void AStarController::setTieBreak(AStarTieBreak tieBreak) {
+    // Takes effect the next time the trace is generated
+    m_tieBreak = tieBreak;
+}
+
+void AStarController::setPlannerKind(AStarPlannerKind kind) {
+    // Both planners already track every wall, so switching is one query
+    if (kind == m_plannerKind) return;
+    m_plannerKind = kind;
+    if (!m_originalGrid.empty()) {
+        repairPlan();
+    }
+}
+
+std::string AStarController::getHeuristicName(AStarHeuristic heuristic) {
+    switch (heuristic) {
+        case AStarHeuristic::MANHATTAN: return "MANHATTAN";
+        case AStarHeuristic::OCTILE: return "OCTILE";
+        case AStarHeuristic::EUCLIDEAN: return "EUCLIDEAN";
+        case AStarHeuristic::CHEBYSHEV: return "CHEBYSHEV";
+        case AStarHeuristic::ZERO: return "ZERO (DIJKSTRA)";
+        case AStarHeuristic::LANDMARKS: return "ALT (" + std::to_string(LandmarkTable::LANDMARK_COUNT) + " LANDMARKS)";
+    }
+    return "";
+}
+
+std::string AStarController::getTieBreakName(AStarTieBreak tieBreak) {
+    switch (tieBreak) {
+        case AStarTieBreak::HEAP_ORDER: return "HEAP ORDER";
+        case AStarTieBreak::LOW_H: return "LOW H";
+        case AStarTieBreak::LOW_G: return "LOW G";
+    }
+    return "";
+}
+
+std::string AStarController::getOpenListName(AStarOpenListKind kind) {
+    switch (kind) {
+        case AStarOpenListKind::INDEXED_HEAP: return "INDEXED HEAP";
+        case AStarOpenListKind::LAZY_HEAP: return "LAZY HEAP";
+        case AStarOpenListKind::BUCKET_QUEUE: return "BUCKETS";
+    }
+    return "";
+}
+
+std::string AStarController::getSearchEngineName(AStarSearchEngine engine) {
+    switch (engine) {
+        case AStarSearchEngine::ASTAR: return "A*";
+        case AStarSearchEngine::JPS: return "JPS";
+        case AStarSearchEngine::JPS_PLUS: return "JPS+";
+    }
+    return "";
+}
+
+std::string AStarController::getPlannerName(AStarPlannerKind kind) {
+    switch (kind) {
+        case AStarPlannerKind::INCREMENTAL: return "D* LITE";
+        case AStarPlannerKind::HIERARCHICAL: return "HPA*";
+    }
+    return "";
+}
+
+std::vector<AStarEngineResult> AStarController::measureSearchEngines(int repetitions) const {
+    std::vector<std::pair<int, int>> walls;
+    for (int i = 0; i < m_originalGrid.size(); i++) {
+        if (m_originalGrid.types[i] == CellType::WALL) {
+            walls.push_back({m_originalGrid.toX(i), m_originalGrid.toY(i)});
+        }
+    }
+    
+    std::vector<AStarEngineResult> results;
+    const AStarSearchEngine engines[] = {AStarSearchEngine::ASTAR, AStarSearchEngine::JPS, AStarSearchEngine::JPS_PLUS};
+    for (AStarSearchEngine engine : engines) {
+        AStarController scratch;
+        scratch.setOpenListKind(m_openListKind);
+        scratch.setSearchEngine(engine);
+        scratch.setNeighborhood(m_neighborhood);
+        scratch.setHeuristic(m_heuristic);
+        scratch.setTieBreak(m_tieBreak);
+        scratch.initialize(m_gridWidth, m_gridHeight, m_startX, m_startY, m_goalX, m_goalY);
+        scratch.setWalls(walls);
+        scratch.setWeights(m_originalGrid.weights);
+        
+        // reset() generates the whole trace; JPS+ tables are built by the first run
+        double bestMs = 0.0;
+        for (int run = 0; run < std::max(1, repetitions); run++) {
+            auto start = std::chrono::steady_clock::now();
+            scratch.reset();
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (run == 0 || ms < bestMs) bestMs = ms;
+        }
+        
+        AStarEngineResult result;
+        result.engine = engine;
+        result.expansions = scratch.getSearchCounters().expansions;
+        result.runtimeMs = bestMs;
+        result.pathLength = scratch.m_finalPath.empty() ? -1 : static_cast<int>(scratch.m_finalPath.size()) - 1;
+        results.push_back(result);
+    }
+    return results;
+}
+
 void AStarController::slowDown() {
     m_stepDelay = std::min(5000.0f, m_stepDelay + 200.0f);
 }
@@ -318,171 +618,633 @@ void AStarController::update(float deltaTime) {
     }
 }
 
-float AStarController::calculateHeuristic(int x1, int y1, int x2, int y2) {
-    // Manhattan distance for grid-based pathfinding
-    return static_cast<float>(std::abs(x1 - x2) + std::abs(y1 - y2));
+float AStarController::calculateHeuristic(int x1, int y1, int x2, int y2) const {
+    // Runtime switch for one-off estimates; expansions use the kernel's policy
+    int dx = std::abs(x1 - x2);
+    int dy = std::abs(y1 - y2);
+    switch (m_heuristic) {
+        case AStarHeuristic::MANHATTAN: return ManhattanHeuristic::estimate(dx, dy);
+        case AStarHeuristic::OCTILE: return OctileHeuristic::estimate(dx, dy);
+        case AStarHeuristic::EUCLIDEAN: return EuclideanHeuristic::estimate(dx, dy);
+        case AStarHeuristic::CHEBYSHEV: return ChebyshevHeuristic::estimate(dx, dy);
+        case AStarHeuristic::ZERO: return ZeroHeuristic::estimate(dx, dy);
+        case AStarHeuristic::LANDMARKS: return m_landmarks.estimate(m_originalGrid.index(x1, y1), m_originalGrid.index(x2, y2));
+    }
+    return 0.0f;
 }
 
-void AStarController::generateSteps() {
-    m_steps.clear();
-    m_totalSteps = 0;
+template <typename Heuristic>
+float AStarController::estimateToGoal(int cellIndex) const {
+    return Heuristic::estimate(std::abs(m_workingGrid.toX(cellIndex) - m_goalX),
+                               std::abs(m_workingGrid.toY(cellIndex) - m_goalY));
+}
+
+// The tables hold the goal's row since the search was seeded
+template <>
+float AStarController::estimateToGoal<LandmarkHeuristic>(int cellIndex) const {
+    return m_landmarks.estimate(cellIndex);
+}
+
+AStarController::ExpandKernel AStarController::selectExpandKernel() const {
+    switch (m_heuristic) {
+        case AStarHeuristic::MANHATTAN: return selectExpandKernel<ManhattanHeuristic>();
+        case AStarHeuristic::OCTILE: return selectExpandKernel<OctileHeuristic>();
+        case AStarHeuristic::EUCLIDEAN: return selectExpandKernel<EuclideanHeuristic>();
+        case AStarHeuristic::CHEBYSHEV: return selectExpandKernel<ChebyshevHeuristic>();
+        case AStarHeuristic::ZERO: return selectExpandKernel<ZeroHeuristic>();
+        case AStarHeuristic::LANDMARKS: return selectExpandKernel<LandmarkHeuristic>();
+    }
+    return selectExpandKernel<ManhattanHeuristic>();
+}
+
+template <typename Heuristic>
+AStarController::ExpandKernel AStarController::selectExpandKernel() const {
+    switch (m_tieBreak) {
+        case AStarTieBreak::HEAP_ORDER: return selectExpandKernel<Heuristic, HeapOrderTieBreak>();
+        case AStarTieBreak::LOW_H: return selectExpandKernel<Heuristic, LowHTieBreak>();
+        case AStarTieBreak::LOW_G: return selectExpandKernel<Heuristic, LowGTieBreak>();
+    }
+    return selectExpandKernel<Heuristic, HeapOrderTieBreak>();
+}
+
+template <typename Heuristic, typename TieBreak>
+AStarController::ExpandKernel AStarController::selectExpandKernel() const {
+    // Jump rules assume every step costs the same; weighted maps expand every neighbor instead
+    if (m_searchEngine != AStarSearchEngine::ASTAR && m_weightedCellCount > 0) {
+        return &AStarController::expandNeighbors<FourConnected, Heuristic, TieBreak>;
+    }
+    switch (m_searchEngine) {
+        case AStarSearchEngine::JPS:
+            return &AStarController::expandJumpPoints<false, Heuristic, TieBreak>;
+        case AStarSearchEngine::JPS_PLUS:
+            return &AStarController::expandJumpPoints<true, Heuristic, TieBreak>;
+        case AStarSearchEngine::ASTAR:
+            break;
+    }
+    if (m_neighborhood == AStarNeighborhood::EIGHT) {
+        return &AStarController::expandNeighbors<EightConnected, Heuristic, TieBreak>;
+    }
+    return &AStarController::expandNeighbors<FourConnected, Heuristic, TieBreak>;
+}
+
+template <typename Neighborhood, typename Heuristic, typename TieBreak>
+void AStarController::expandNeighbors(int cellIndex) {
+    int x = m_workingGrid.toX(cellIndex);
+    int y = m_workingGrid.toY(cellIndex);
+    for (int direction = 0; direction < Neighborhood::COUNT; direction++) {
+        int nx = x + Neighborhood::DX[direction];
+        int ny = y + Neighborhood::DY[direction];
+        if (!m_workingGrid.inBounds(nx, ny)) continue;
+        if (Neighborhood::isDiagonal(direction) && (!isWalkable(nx, y) || !isWalkable(x, ny))) {
+            continue;  // Would cut a wall corner
+        }
+        relaxSuccessor<Heuristic, TieBreak>(cellIndex, m_workingGrid.index(nx, ny), Neighborhood::cost(direction));
+    }
+}
+
+template <bool Precomputed, typename Heuristic, typename TieBreak>
+void AStarController::expandJumpPoints(int cellIndex) {
+    m_successors.clear();
+    if (Precomputed) {
+        collectJumpPlusSuccessors(cellIndex);
+    } else {
+        collectJumpSuccessors(cellIndex);
+    }
+    for (const auto& successor : m_successors) {
+        relaxSuccessor<Heuristic, TieBreak>(cellIndex, successor.index, successor.cost);
+    }
+}
+
+template <typename Heuristic, typename TieBreak>
+void AStarController::relaxSuccessor(int fromIndex, int toIndex, float stepCost) {
+    auto& workingGrid = m_workingGrid;
+    if (workingGrid.types[toIndex] == CellType::WALL || isClosed(toIndex)) {
+        return;
+    }
+    
+    // Entering a cell costs the move times the cell's weight; weights of at
+    // least 1 keep every heuristic admissible
+    float tentativeGCost = workingGrid.gCost[fromIndex] + stepCost * workingGrid.weights[toIndex];
+    if (!(tentativeGCost < workingGrid.gCost[toIndex])) return;
+    
+    // Update parent
+    recordCellChange(toIndex);
+    workingGrid.parent[toIndex] = fromIndex;
+    workingGrid.gCost[toIndex] = tentativeGCost;
+    workingGrid.hCost[toIndex] = estimateToGoal<Heuristic>(toIndex);
+    workingGrid.fCost[toIndex] = tentativeGCost + workingGrid.hCost[toIndex];
     
-    // Initial state
-    addStep(m_originalGrid, -1, -1, "Starting A* pathfinding algorithm");
+    if (!isOpen(toIndex)) {
+        // Mark as open (except start/goal)
+        if (workingGrid.types[toIndex] != CellType::START && 
+            workingGrid.types[toIndex] != CellType::GOAL) {
+            workingGrid.types[toIndex] = CellType::OPEN_LIST;
+        }
+        m_openStamp[toIndex] = m_searchGeneration;
+        m_openCount++;
+    }
     
-    // Run A* algorithm
-    runAStar();
+    pushOpenNode(toIndex, {workingGrid.fCost[toIndex], TieBreak::tie(tentativeGCost, workingGrid.hCost[toIndex])});
 }
 
-void AStarController::runAStar() {
-    // Create a working copy of the grid
-    std::vector<std::vector<GridCell>> workingGrid = m_originalGrid;
+void AStarController::generateSteps() {
+    resetSearch();
     
-    // Reset all costs and parent information
-    for (int y = 0; y < m_gridHeight; ++y) {
-        for (int x = 0; x < m_gridWidth; ++x) {
-            workingGrid[y][x].gCost = std::numeric_limits<float>::infinity();
-            workingGrid[y][x].hCost = 0;
-            workingGrid[y][x].fCost = std::numeric_limits<float>::infinity();
-            workingGrid[y][x].hasParent = false;
+    if (m_lazyGeneration) {
+        // Only the first step up front; the rest is produced as step() asks for it
+        ensureStepGenerated(0);
+    } else {
+        while (advanceSearch()) {
         }
     }
-    
-    // Priority queue for open list (min-heap based on fCost)
-    // We'll store coordinates instead of pointers
-    struct Node {
-        int x, y;
-        float fCost;
-        bool operator>(const Node& other) const {
-            return fCost > other.fCost;
+}
+
+void AStarController::regenerateIfReady() {
+    if (m_state == AStarState::READY) {
+        // Only the first step; the search itself waits for playback, so an
+        // edit costs the planner repair rather than a whole new trace
+        if (m_currentStepIndex != 0) {
+            // Scrubbed while ready; the new trace starts from the edited grid
+            m_currentGrid = m_originalGrid;
+            m_currentStepIndex = 0;
         }
-    };
-    
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openList;
-    std::unordered_map<int, bool> openSet;  // key = y * width + x
-    std::unordered_map<int, bool> closedSet;
+        resetSearch();
+        ensureStepGenerated(0);
+        if (getTotalSteps() > 0) {
+            m_currentStep = stepAt(0);
+            if (m_stepCallback) {
+                m_stepCallback(m_currentStep);
+            }
+        }
+    }
+}
+
+void AStarController::repairPlan() {
+    if (m_plannerKind == AStarPlannerKind::HIERARCHICAL) {
+        // A walled-off goal would make HPA* exhaust every abstract node; the
+        // wavefront rules that out for a fraction of the cost
+        int startIndex = m_originalGrid.index(m_startX, m_startY);
+        int goalIndex = m_originalGrid.index(m_goalX, m_goalY);
+        if (m_reachability.isReachable(startIndex, goalIndex)) {
+            // Rebuilds the sectors edited since the last query, then searches
+            m_hierarchical.findPath(startIndex, goalIndex, m_plannedCells);
+        } else {
+            m_plannedCells.clear();
+        }
+    } else {
+        m_planner.computeShortestPath();
+        m_planner.extractPath(m_plannedCells);
+    }
     
-    // Initialize start cell
-    workingGrid[m_startY][m_startX].gCost = 0;
-    workingGrid[m_startY][m_startX].hCost = calculateHeuristic(m_startX, m_startY, m_goalX, m_goalY);
-    workingGrid[m_startY][m_startX].fCost = workingGrid[m_startY][m_startX].hCost;
+    m_plannedPath.clear();
+    for (int cellIndex : m_plannedCells) {
+        m_plannedPath.push_back({m_originalGrid.toX(cellIndex), m_originalGrid.toY(cellIndex)});
+    }
+}
+
+void AStarController::setPlannerBlocked(int cellIndex, bool blocked) {
+    // D* Lite queues the change, HPA* marks sectors dirty; nothing searches yet
+    m_planner.setBlocked(cellIndex, blocked);
+    m_hierarchical.setBlocked(cellIndex, blocked);
+    m_reachability.setBlocked(cellIndex, blocked);
+    m_flowField.setBlocked(cellIndex, blocked);
+    m_landmarks.setBlocked(cellIndex, blocked);
+}
+
+const FlowField& AStarController::getFlowField() {
+    if (m_flowFieldDirty && !m_originalGrid.empty()) {
+        m_flowField.build(m_originalGrid.index(m_goalX, m_goalY));
+        m_flowFieldDirty = false;
+    }
+    return m_flowField;
+}
+
+void AStarController::resetSearch() {
+    m_steps.clear();
+    m_keyframes.clear();
+    m_traceBase = 0;
+    m_totalSteps = 0;
+    m_currentOpenListSize = 0;
+    m_currentClosedListSize = 0;
     
-    openList.push({m_startX, m_startY, workingGrid[m_startY][m_startX].fCost});
-    openSet[m_startY * m_gridWidth + m_startX] = true;
+    m_openHeap.reset(m_originalGrid.size());
+    m_lazyOpenList = decltype(m_lazyOpenList)();
+    if (m_openListKind == AStarOpenListKind::BUCKET_QUEUE) {
+        m_openBuckets.reset(m_originalGrid.size());
+    }
+    m_bucketSearch = false;
+    m_counters = AStarSearchCounters();
+    m_openCount = 0;
+    m_closedCount = 0;
     
-    addStep(workingGrid, m_startX, m_startY, "Added start cell to open list");
+    // New generation invalidates every stamp; only a wrap-around needs a real clear
+    size_t cellCount = static_cast<size_t>(m_originalGrid.size());
+    if (m_openStamp.size() != cellCount) {
+        m_openStamp.assign(cellCount, 0);
+        m_closedStamp.assign(cellCount, 0);
+        m_searchGeneration = 0;
+    }
+    if (++m_searchGeneration == 0) {
+        std::fill(m_openStamp.begin(), m_openStamp.end(), 0);
+        std::fill(m_closedStamp.begin(), m_closedStamp.end(), 0);
+        m_searchGeneration = 1;
+    }
+    m_finalPath.clear();
+    m_pendingChanges.clear();
+    m_pathIndex = 0;
+    m_searchPhase = SearchPhase::START;
+}
+
+bool AStarController::ensureStepGenerated(size_t stepIndex) {
+    while (getTotalSteps() <= stepIndex && advanceSearch()) {
+    }
+    return stepIndex < getTotalSteps();
+}
+
+bool AStarController::advanceSearch() {
+    auto& workingGrid = m_workingGrid;
     
-    while (!openList.empty()) {
-        // Get the cell with lowest fCost
-        Node current = openList.top();
-        openList.pop();
+    switch (m_searchPhase) {
+        case SearchPhase::START:
+            // Initial state; the first step never changes a cell, so the
+            // trace can start from m_originalGrid without applying it
+            addStep(AStarStepKind::START, -1, -1);
+            m_searchPhase = SearchPhase::SEED;
+            return true;
         
-        int key = current.y * m_gridWidth + current.x;
-        
-        // Skip if already processed
-        if (closedSet.find(key) != closedSet.end()) {
-            continue;
+        case SearchPhase::SEED: {
+            // Create a working copy of the grid; costs and parents are still
+            // unvisited because edits only ever change cell types and weights
+            workingGrid = m_originalGrid;
+            if (m_searchEngine == AStarSearchEngine::JPS_PLUS && m_jumpTablesDirty) {
+                buildJumpTables();
+            }
+            if (m_heuristic == AStarHeuristic::LANDMARKS) {
+                // Rebuilds only the tables an edit invalidated since the last search
+                m_landmarks.update();
+                m_landmarks.setTarget(workingGrid.index(m_goalX, m_goalY));
+            }
+            m_expandKernel = selectExpandKernel();
+            
+            // Buckets need whole-number f: straight moves, integer weights and an integer heuristic
+            bool straightMoves = m_neighborhood == AStarNeighborhood::FOUR || m_searchEngine != AStarSearchEngine::ASTAR;
+            bool integerHeuristic = m_heuristic == AStarHeuristic::MANHATTAN || m_heuristic == AStarHeuristic::ZERO ||
+                                    (m_heuristic == AStarHeuristic::LANDMARKS && m_neighborhood == AStarNeighborhood::FOUR);
+            m_bucketSearch = m_openListKind == AStarOpenListKind::BUCKET_QUEUE && straightMoves && integerHeuristic;
+            
+            // Initialize start cell
+            int startIndex = workingGrid.index(m_startX, m_startY);
+            recordCellChange(startIndex);
+            workingGrid.gCost[startIndex] = 0;
+            workingGrid.hCost[startIndex] = calculateHeuristic(m_startX, m_startY, m_goalX, m_goalY);
+            workingGrid.fCost[startIndex] = workingGrid.hCost[startIndex];
+            
+            pushOpenNode(startIndex, {workingGrid.fCost[startIndex], 0.0f});
+            m_openStamp[startIndex] = m_searchGeneration;
+            m_openCount++;
+            
+            addStep(AStarStepKind::START_OPENED, m_startX, m_startY);
+            m_searchPhase = SearchPhase::EXPAND;
+            return true;
         }
         
-        openSet.erase(key);
-        closedSet[key] = true;
-        
-        // Mark as closed (except start/goal)
-        if (workingGrid[current.y][current.x].type != CellType::START && 
-            workingGrid[current.y][current.x].type != CellType::GOAL) {
-            workingGrid[current.y][current.x].type = CellType::CLOSED_LIST;
+        case SearchPhase::EXPAND: {
+            // Get the cell with lowest fCost
+            int key;
+            if (!popOpenNode(key)) {
+                // No path found
+                addStep(AStarStepKind::NO_PATH, -1, -1);
+                m_searchPhase = SearchPhase::DONE;
+                return true;
+            }
+            
+            int currentX = workingGrid.toX(key);
+            int currentY = workingGrid.toY(key);
+            m_openStamp[key] = 0;
+            m_closedStamp[key] = m_searchGeneration;
+            m_openCount--;
+            m_closedCount++;
+            m_counters.expansions++;
+            
+            // Mark as closed (except start/goal)
+            if (workingGrid.types[key] != CellType::START && 
+                workingGrid.types[key] != CellType::GOAL) {
+                recordCellChange(key);
+                workingGrid.types[key] = CellType::CLOSED_LIST;
+            }
+            
+            m_currentOpenListSize = m_openCount;
+            m_currentClosedListSize = m_closedCount;
+            
+            addStep(AStarStepKind::EXAMINE, currentX, currentY);
+            
+            // Check if we reached the goal
+            if (currentX == m_goalX && currentY == m_goalY) {
+                m_finalPath = reconstructPath(currentX, currentY);
+                m_pathIndex = 0;
+                m_searchPhase = SearchPhase::BUILD_PATH;
+                return true;
+            }
+            
+            // Neighbors for A*, jump points for JPS
+            (this->*m_expandKernel)(key);
+            return true;
         }
         
-        m_currentOpenListSize = static_cast<int>(openSet.size());
-        m_currentClosedListSize = static_cast<int>(closedSet.size());
-        
-        addStep(workingGrid, current.x, current.y, 
-               "Examining cell (" + std::to_string(current.x) + "," + std::to_string(current.y) + 
-               ") f=" + std::to_string((int)workingGrid[current.y][current.x].fCost));
-        
-        // Check if we reached the goal
-        if (current.x == m_goalX && current.y == m_goalY) {
-            auto path = reconstructPath(current.x, current.y);
-            
+        case SearchPhase::BUILD_PATH:
             // Add path visualization steps
-            for (const auto& p : path) {
+            if (m_pathIndex < m_finalPath.size()) {
+                const auto& p = m_finalPath[m_pathIndex++];
                 if (!(p.first == m_startX && p.second == m_startY) && 
                     !(p.first == m_goalX && p.second == m_goalY)) {
-                    workingGrid[p.second][p.first].type = CellType::PATH;
+                    recordCellChange(workingGrid.index(p.first, p.second));
+                    workingGrid.types[workingGrid.index(p.first, p.second)] = CellType::PATH;
                 }
-                addStep(workingGrid, p.first, p.second, "Building optimal path...", path);
+                addStep(AStarStepKind::BUILD_PATH, p.first, p.second);
+            } else {
+                addStep(AStarStepKind::PATH_FOUND, -1, -1);
+                m_searchPhase = SearchPhase::DONE;
             }
-            
-            addStep(workingGrid, -1, -1, "Path found! Total path length: " + std::to_string(path.size() - 1) + " steps", path);
-            return;
-        }
-        
-        // Check neighbors
-        auto neighbors = getNeighbors(current.x, current.y);
+            return true;
         
-        for (const auto& neighbor : neighbors) {
-            int nx = neighbor.first;
-            int ny = neighbor.second;
-            int nkey = ny * m_gridWidth + nx;
-            
-            if (workingGrid[ny][nx].type == CellType::WALL || closedSet.find(nkey) != closedSet.end()) {
+        case SearchPhase::DONE:
+            break;
+    }
+    
+    return false;
+}
+
+void AStarController::pushOpenNode(int cellIndex, OpenKey key) {
+    if (m_bucketSearch) {
+        // f is a whole number here; rounding only guards the conversion
+        int priority = static_cast<int>(key.fCost + 0.5f);
+        if (m_openBuckets.contains(cellIndex)) {
+            m_openBuckets.decreaseKey(cellIndex, priority);
+            m_counters.decreaseKeys++;
+        } else {
+            m_openBuckets.push(cellIndex, priority);
+            m_counters.heapPushes++;
+        }
+    } else if (m_openListKind == AStarOpenListKind::LAZY_HEAP) {
+        m_lazyOpenList.push({cellIndex, key});
+        m_counters.heapPushes++;
+    } else if (m_openHeap.contains(cellIndex)) {
+        m_openHeap.decreaseKey(cellIndex, key);
+        m_counters.decreaseKeys++;
+    } else {
+        m_openHeap.push(cellIndex, key);
+        m_counters.heapPushes++;
+    }
+}
+
+bool AStarController::popOpenNode(int& cellIndex) {
+    if (m_bucketSearch) {
+        if (m_openBuckets.empty()) return false;
+        cellIndex = m_openBuckets.pop();
+        m_counters.heapPops++;
+        return true;
+    }
+    if (m_openListKind == AStarOpenListKind::LAZY_HEAP) {
+        // Improved cells were pushed again; older copies surface after the cell is closed
+        while (!m_lazyOpenList.empty()) {
+            OpenNode node = m_lazyOpenList.top();
+            m_lazyOpenList.pop();
+            m_counters.heapPops++;
+            if (isClosed(node.index)) {
+                m_counters.stalePops++;
                 continue;
             }
-            
-            float tentativeGCost = workingGrid[current.y][current.x].gCost + 1.0f;
-            
-            if (tentativeGCost < workingGrid[ny][nx].gCost) {
-                // Update parent
-                workingGrid[ny][nx].parentX = current.x;
-                workingGrid[ny][nx].parentY = current.y;
-                workingGrid[ny][nx].hasParent = true;
-                workingGrid[ny][nx].gCost = tentativeGCost;
-                workingGrid[ny][nx].hCost = calculateHeuristic(nx, ny, m_goalX, m_goalY);
-                workingGrid[ny][nx].fCost = tentativeGCost + workingGrid[ny][nx].hCost;
-                
-                if (openSet.find(nkey) == openSet.end()) {
-                    // Mark as open (except start/goal)
-                    if (workingGrid[ny][nx].type != CellType::START && 
-                        workingGrid[ny][nx].type != CellType::GOAL) {
-                        workingGrid[ny][nx].type = CellType::OPEN_LIST;
-                    }
-                }
-                
-                openList.push({nx, ny, workingGrid[ny][nx].fCost});
-                openSet[nkey] = true;
-            }
+            cellIndex = node.index;
+            return true;
         }
+        return false;
     }
     
-    // No path found
-    addStep(workingGrid, -1, -1, "No path exists to the goal!");
+    if (m_openHeap.empty()) return false;
+    cellIndex = m_openHeap.pop();
+    m_counters.heapPops++;
+    return true;
 }
 
-std::vector<std::pair<int, int>> AStarController::getNeighbors(int x, int y) {
-    std::vector<std::pair<int, int>> neighbors;
+void AStarController::trimHistory() {
+    if (!m_lazyGeneration || m_historyLimit == 0) return;
     
-    // Check 4-directional neighbors (up, down, left, right)
-    int directions[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    if (m_traceBase == 0 && m_steps.size() > m_historyLimit) {
+        // Window is about to slide for the first time this trace
+        m_baseGrid = m_originalGrid;
+    }
+    while (m_steps.size() > m_historyLimit) {
+        applyStepChanges(m_steps.front(), m_baseGrid, true);
+        m_steps.pop_front();
+        m_traceBase++;
+    }
+    // m_baseGrid now covers every snapshot the window slid past
+    while (!m_keyframes.empty() && m_keyframes.front().stepIndex <= m_traceBase) {
+        m_keyframes.pop_front();
+    }
+}
+
+void AStarController::rebuildKeyframes() {
+    m_keyframes.clear();
+    if (getTotalSteps() == 0) return;
     
-    for (int i = 0; i < 4; ++i) {
-        int newX = x + directions[i][0];
-        int newY = y + directions[i][1];
-        
-        if (newX >= 0 && newX < m_gridWidth && newY >= 0 && newY < m_gridHeight) {
-            neighbors.push_back({newX, newY});
+    // Replay the deltas once from the window base, snapshotting at the new spacing
+    size_t spacing = getKeyframeSpacing();
+    AStarGrid replay = m_traceBase > 0 ? m_baseGrid : m_originalGrid;
+    for (size_t i = m_traceBase; i < getTotalSteps(); i++) {
+        if (i > m_traceBase && i % spacing == 0) {
+            m_keyframes.push_back({i, replay});
+        }
+        applyStepChanges(stepAt(i), replay, true);
+    }
+}
+
+void AStarController::addKeyframe(size_t stepIndex) {
+    // Replay from the newest snapshot, or the window base when none is left
+    AStarKeyframe keyframe;
+    keyframe.stepIndex = stepIndex;
+    size_t from = m_traceBase;
+    if (!m_keyframes.empty()) {
+        keyframe.grid = m_keyframes.back().grid;
+        from = m_keyframes.back().stepIndex;
+    } else {
+        keyframe.grid = m_traceBase > 0 ? m_baseGrid : m_originalGrid;
+    }
+    for (size_t i = from; i < stepIndex; i++) {
+        applyStepChanges(stepAt(i), keyframe.grid, true);
+    }
+    m_keyframes.push_back(std::move(keyframe));
+}
+
+bool AStarController::isWalkable(int x, int y) const {
+    return m_workingGrid.inBounds(x, y) && m_workingGrid.types[m_workingGrid.index(x, y)] != CellType::WALL;
+}
+
+// 4-connected jump rules: a horizontal scan stops beside a wall corner it
+// can turn around, and a vertical scan also stops wherever a horizontal scan
+// from it would find a jump point. Only the direction back to the parent is
+// pruned, so every shortest path survives as a chain of straight segments.
+int AStarController::jumpHorizontal(int x, int y, int dx) const {
+    while (true) {
+        x += dx;
+        if (!isWalkable(x, y)) return -1;
+        if (x == m_goalX && y == m_goalY) return m_workingGrid.index(x, y);
+        if ((isWalkable(x, y - 1) && !isWalkable(x - dx, y - 1)) ||
+            (isWalkable(x, y + 1) && !isWalkable(x - dx, y + 1))) {
+            return m_workingGrid.index(x, y);
+        }
+    }
+}
+
+int AStarController::jumpVertical(int x, int y, int dy) const {
+    while (true) {
+        y += dy;
+        if (!isWalkable(x, y)) return -1;
+        if (x == m_goalX && y == m_goalY) return m_workingGrid.index(x, y);
+        if ((isWalkable(x - 1, y) && !isWalkable(x - 1, y - dy)) ||
+            (isWalkable(x + 1, y) && !isWalkable(x + 1, y - dy))) {
+            return m_workingGrid.index(x, y);
+        }
+        if (jumpHorizontal(x, y, 1) >= 0 || jumpHorizontal(x, y, -1) >= 0) {
+            return m_workingGrid.index(x, y);
         }
     }
+}
+
+void AStarController::collectJumpSuccessors(int cellIndex) {
+    int x = m_workingGrid.toX(cellIndex);
+    int y = m_workingGrid.toY(cellIndex);
+    
+    // Direction of travel into this cell; the start scans all four ways
+    int dx = 0;
+    int dy = 0;
+    int parentIndex = m_workingGrid.parent[cellIndex];
+    if (parentIndex >= 0) {
+        int px = m_workingGrid.toX(parentIndex);
+        int py = m_workingGrid.toY(parentIndex);
+        dx = (x > px) - (x < px);
+        dy = (y > py) - (y < py);
+    }
+    
+    auto addJump = [&](int jumpIndex) {
+        if (jumpIndex < 0) return;
+        int distance = std::abs(m_workingGrid.toX(jumpIndex) - x) + std::abs(m_workingGrid.toY(jumpIndex) - y);
+        m_successors.push_back({jumpIndex, static_cast<float>(distance)});
+    };
+    
+    if (dy != 1) addJump(jumpVertical(x, y, -1));
+    if (dy != -1) addJump(jumpVertical(x, y, 1));
+    if (dx != 1) addJump(jumpHorizontal(x, y, -1));
+    if (dx != -1) addJump(jumpHorizontal(x, y, 1));
+}
+
+void AStarController::buildJumpTables() {
+    // Same jump rules as the scans above, minus the goal test, stored per
+    // direction. Horizontal tables come first because vertical jump points
+    // depend on them. Each cell reads the cell after it in the direction of
+    // travel, so every line is swept from its far end.
+    int width = m_workingGrid.width;
+    int height = m_workingGrid.height;
+    size_t cellCount = static_cast<size_t>(m_workingGrid.size());
+    for (auto& table : m_jumpDistance) {
+        table.assign(cellCount, 0);
+    }
+    
+    auto extend = [](std::int32_t next) {
+        return next > 0 ? next + 1 : next - 1;
+    };
+    
+    for (int y = 0; y < height; y++) {
+        for (int x = width - 1; x >= 0; x--) {
+            if (!isWalkable(x, y) || !isWalkable(x + 1, y)) continue;
+            bool forced = (isWalkable(x + 1, y - 1) && !isWalkable(x, y - 1)) ||
+                          (isWalkable(x + 1, y + 1) && !isWalkable(x, y + 1));
+            m_jumpDistance[JUMP_RIGHT][m_workingGrid.index(x, y)] = forced ? 1 : extend(m_jumpDistance[JUMP_RIGHT][m_workingGrid.index(x + 1, y)]);
+        }
+        for (int x = 0; x < width; x++) {
+            if (!isWalkable(x, y) || !isWalkable(x - 1, y)) continue;
+            bool forced = (isWalkable(x - 1, y - 1) && !isWalkable(x, y - 1)) ||
+                          (isWalkable(x - 1, y + 1) && !isWalkable(x, y + 1));
+            m_jumpDistance[JUMP_LEFT][m_workingGrid.index(x, y)] = forced ? 1 : extend(m_jumpDistance[JUMP_LEFT][m_workingGrid.index(x - 1, y)]);
+        }
+    }
+    
+    auto hasHorizontalJump = [&](int x, int y) {
+        int index = m_workingGrid.index(x, y);
+        return m_jumpDistance[JUMP_LEFT][index] > 0 || m_jumpDistance[JUMP_RIGHT][index] > 0;
+    };
+    
+    for (int x = 0; x < width; x++) {
+        for (int y = height - 1; y >= 0; y--) {
+            if (!isWalkable(x, y) || !isWalkable(x, y + 1)) continue;
+            bool forced = (isWalkable(x - 1, y + 1) && !isWalkable(x - 1, y)) ||
+                          (isWalkable(x + 1, y + 1) && !isWalkable(x + 1, y)) ||
+                          hasHorizontalJump(x, y + 1);
+            m_jumpDistance[JUMP_DOWN][m_workingGrid.index(x, y)] = forced ? 1 : extend(m_jumpDistance[JUMP_DOWN][m_workingGrid.index(x, y + 1)]);
+        }
+        for (int y = 0; y < height; y++) {
+            if (!isWalkable(x, y) || !isWalkable(x, y - 1)) continue;
+            bool forced = (isWalkable(x - 1, y - 1) && !isWalkable(x - 1, y)) ||
+                          (isWalkable(x + 1, y - 1) && !isWalkable(x + 1, y)) ||
+                          hasHorizontalJump(x, y - 1);
+            m_jumpDistance[JUMP_UP][m_workingGrid.index(x, y)] = forced ? 1 : extend(m_jumpDistance[JUMP_UP][m_workingGrid.index(x, y - 1)]);
+        }
+    }
+    m_jumpTablesDirty = false;
+}
+
+void AStarController::collectJumpPlusSuccessors(int cellIndex) {
+    int x = m_workingGrid.toX(cellIndex);
+    int y = m_workingGrid.toY(cellIndex);
+    
+    int dx = 0;
+    int dy = 0;
+    int parentIndex = m_workingGrid.parent[cellIndex];
+    if (parentIndex >= 0) {
+        int px = m_workingGrid.toX(parentIndex);
+        int py = m_workingGrid.toY(parentIndex);
+        dx = (x > px) - (x < px);
+        dy = (y > py) - (y < py);
+    }
+    
+    static const int directionX[JUMP_DIRECTION_COUNT] = {0, 0, -1, 1};
+    static const int directionY[JUMP_DIRECTION_COUNT] = {-1, 1, 0, 0};
     
-    return neighbors;
+    for (int direction = 0; direction < JUMP_DIRECTION_COUNT; direction++) {
+        int stepX = directionX[direction];
+        int stepY = directionY[direction];
+        if (stepX == -dx && stepY == -dy && (dx != 0 || dy != 0)) continue;  // Back towards the parent
+        
+        std::int32_t distance = m_jumpDistance[direction][cellIndex];
+        int reach = distance > 0 ? distance : -distance;
+        
+        // The tables ignore the goal, so test for it along the scanned line
+        int goalSteps = stepX != 0 ? (m_goalX - x) * stepX : (m_goalY - y) * stepY;
+        bool goalOnLine = stepX != 0 ? m_goalY == y : m_goalX == x;
+        if (goalSteps > 0 && goalSteps <= reach) {
+            if (goalOnLine) {
+                m_successors.push_back({m_workingGrid.index(m_goalX, m_goalY), static_cast<float>(goalSteps)});
+                continue;
+            }
+            if (stepY != 0) {
+                // A vertical scan crossing the goal row stops there so a
+                // horizontal jump can reach the goal
+                m_successors.push_back({m_workingGrid.index(x, m_goalY), static_cast<float>(goalSteps)});
+                continue;
+            }
+        }
+        
+        if (distance > 0) {
+            m_successors.push_back({m_workingGrid.index(x + stepX * distance, y + stepY * distance), static_cast<float>(distance)});
+        }
+    }
 }
 
 std::vector<std::pair<int, int>> AStarController::reconstructPath(int goalX, int goalY) {
     std::vector<std::pair<int, int>> path;
     
-    // Get the last step to access the final grid state
-    if (m_steps.empty()) return path;
-    
-    const auto& finalGrid = m_steps.back().grid;
+    // Parents live in the search's working grid
+    const auto& finalGrid = m_workingGrid;
     
     int currentX = goalX;
     int currentY = goalY;
@@ -495,11 +1257,10 @@ std::vector<std::pair<int, int>> AStarController::reconstructPath(int goalX, int
             break;
         }
         
-        if (finalGrid[currentY][currentX].hasParent) {
-            int parentX = finalGrid[currentY][currentX].parentX;
-            int parentY = finalGrid[currentY][currentX].parentY;
-            currentX = parentX;
-            currentY = parentY;
+        int parentIndex = finalGrid.parent[finalGrid.index(currentX, currentY)];
+        if (parentIndex >= 0) {
+            currentX = finalGrid.toX(parentIndex);
+            currentY = finalGrid.toY(parentIndex);
         } else {
             break;
         }
@@ -508,41 +1269,180 @@ std::vector<std::pair<int, int>> AStarController::reconstructPath(int goalX, int
     // Reverse to get path from start to goal
     std::reverse(path.begin(), path.end());
     
-    return path;
+    // JPS parents are jump points; fill in the straight runs between them
+    std::vector<std::pair<int, int>> cells;
+    for (size_t i = 0; i < path.size(); i++) {
+        if (i > 0) {
+            int stepX = (path[i].first > path[i - 1].first) - (path[i].first < path[i - 1].first);
+            int stepY = (path[i].second > path[i - 1].second) - (path[i].second < path[i - 1].second);
+            int cellX = path[i - 1].first + stepX;
+            int cellY = path[i - 1].second + stepY;
+            while (cellX != path[i].first || cellY != path[i].second) {
+                cells.push_back({cellX, cellY});
+                cellX += stepX;
+                cellY += stepY;
+            }
+        }
+        cells.push_back(path[i]);
+    }
+    
+    return cells;
+}
+
+void AStarController::recordCellChange(int cellIndex) {
+    for (const auto& change : m_pendingChanges) {
+        if (change.index == cellIndex) return;  // Old values already captured this step
+    }
+    
+    AStarCellChange change;
+    change.index = cellIndex;
+    change.oldType = m_workingGrid.types[cellIndex];
+    change.oldParent = m_workingGrid.parent[cellIndex];
+    change.oldG = m_workingGrid.gCost[cellIndex];
+    change.oldH = m_workingGrid.hCost[cellIndex];
+    change.oldF = m_workingGrid.fCost[cellIndex];
+    m_pendingChanges.push_back(change);
 }
 
-void AStarController::addStep(const std::vector<std::vector<GridCell>>& grid, int currentX, int currentY, const std::string& desc, const std::vector<std::pair<int, int>>& path) {
+void AStarController::addStep(AStarStepKind kind, int currentX, int currentY) {
     AStarStep step;
-    step.grid = grid;
+    step.kind = kind;
+    
+    // Pair each captured old value with the cell's state now
+    for (auto& change : m_pendingChanges) {
+        change.newType = m_workingGrid.types[change.index];
+        change.newParent = m_workingGrid.parent[change.index];
+        change.newG = m_workingGrid.gCost[change.index];
+        change.newH = m_workingGrid.hCost[change.index];
+        change.newF = m_workingGrid.fCost[change.index];
+    }
+    step.changes.swap(m_pendingChanges);
+    m_pendingChanges.clear();
+    
     step.currentX = currentX;
     step.currentY = currentY;
     step.hasCurrentCell = (currentX >= 0 && currentY >= 0);
-    step.description = desc;
     step.stepCount = m_totalSteps++;
     step.openListSize = m_currentOpenListSize;
     step.closedListSize = m_currentClosedListSize;
-    step.path = path;
     
-    m_steps.push_back(step);
+    m_steps.push_back(std::move(step));
+    size_t stepIndex = getTotalSteps() - 1;
+    if (stepIndex % getKeyframeSpacing() == 0 && stepIndex > m_traceBase) {
+        addKeyframe(stepIndex);
+    }
+    trimHistory();
+}
+
+void AStarController::applyStepChanges(const AStarStep& step, AStarGrid& grid, bool forward) const {
+    if (forward) {
+        for (const auto& change : step.changes) {
+            grid.types[change.index] = change.newType;
+            grid.parent[change.index] = change.newParent;
+            grid.gCost[change.index] = change.newG;
+            grid.hCost[change.index] = change.newH;
+            grid.fCost[change.index] = change.newF;
+        }
+    } else {
+        for (auto it = step.changes.rbegin(); it != step.changes.rend(); ++it) {
+            grid.types[it->index] = it->oldType;
+            grid.parent[it->index] = it->oldParent;
+            grid.gCost[it->index] = it->oldG;
+            grid.hCost[it->index] = it->oldH;
+            grid.fCost[it->index] = it->oldF;
+        }
+    }
+}
+
+void AStarController::moveToStep(size_t stepIndex, bool restore) {
+    // Nearest snapshot at or before the target: a keyframe, else the window base
+    size_t restoreIndex = m_traceBase;
+    const AStarGrid* restoreGrid = m_traceBase > 0 ? &m_baseGrid : &m_originalGrid;
+    auto keyframe = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), stepIndex,
+        [](size_t index, const AStarKeyframe& frame) { return index < frame.stepIndex; });
+    if (keyframe != m_keyframes.begin()) {
+        --keyframe;
+        restoreIndex = keyframe->stepIndex;
+        restoreGrid = &keyframe->grid;
+    }
+    
+    // Restore it unless walking the deltas from the current step is cheaper
+    size_t distanceFromCurrent = (stepIndex > m_currentStepIndex) ? stepIndex - m_currentStepIndex : m_currentStepIndex - stepIndex;
+    if (restore || stepIndex - restoreIndex < distanceFromCurrent) {
+        m_currentGrid = *restoreGrid;
+        for (size_t i = restoreIndex; i <= stepIndex; i++) {
+            applyStepChanges(stepAt(i), m_currentGrid, true);
+        }
+    } else {
+        while (m_currentStepIndex < stepIndex) {
+            applyStepChanges(stepAt(++m_currentStepIndex), m_currentGrid, true);
+        }
+        while (m_currentStepIndex > stepIndex) {
+            applyStepChanges(stepAt(m_currentStepIndex--), m_currentGrid, false);
+        }
+    }
+    m_currentStepIndex = stepIndex;
+}
+
+std::string AStarController::getCurrentDescription() const {
+    if (getTotalSteps() == 0) return "";
+    
+    const AStarStep& step = m_currentStep;
+    switch (step.kind) {
+        case AStarStepKind::START:
+            return "Starting A* pathfinding algorithm";
+        case AStarStepKind::START_OPENED:
+            return "Added start cell to open list";
+        case AStarStepKind::EXAMINE:
+            return "Examining cell (" + std::to_string(step.currentX) + "," + std::to_string(step.currentY) +
+                   ") f=" + std::to_string((int)m_currentGrid.fCost[m_currentGrid.index(step.currentX, step.currentY)]);
+        case AStarStepKind::BUILD_PATH:
+            return "Building optimal path...";
+        case AStarStepKind::PATH_FOUND:
+            return "Path found! Total path length: " + std::to_string(m_finalPath.size() - 1) + " steps";
+        case AStarStepKind::NO_PATH:
+            return "No path exists to the goal!";
+    }
+    return "";
 }
 
 int AStarController::getStepCount() const {
-    if (m_currentStepIndex < m_steps.size()) {
-        return m_steps[m_currentStepIndex].stepCount;
+    if (m_currentStepIndex < getTotalSteps()) {
+        return m_currentStep.stepCount;
     }
     return 0;
 }
 
 int AStarController::getOpenListSize() const {
-    if (m_currentStepIndex < m_steps.size()) {
-        return m_steps[m_currentStepIndex].openListSize;
+    if (m_currentStepIndex < getTotalSteps()) {
+        return m_currentStep.openListSize;
     }
     return 0;
 }
 
 int AStarController::getClosedListSize() const {
-    if (m_currentStepIndex < m_steps.size()) {
-        return m_steps[m_currentStepIndex].closedListSize;
+    if (m_currentStepIndex < getTotalSteps()) {
+        return m_currentStep.closedListSize;
     }
     return 0;
+}
+
+const std::vector<std::pair<int, int>>& AStarController::getCurrentPath() const {
+    static const std::vector<std::pair<int, int>> noPath;
+    if (getTotalSteps() > 0 &&
+        (m_currentStep.kind == AStarStepKind::BUILD_PATH || m_currentStep.kind == AStarStepKind::PATH_FOUND)) {
+        return m_finalPath;
+    }
+    return noPath;
+}
+
+size_t AStarController::getTraceMemoryBytes() const {
+    size_t bytes = m_traceBase > 0 ? m_baseGrid.getMemoryBytes() : 0;
+    for (const auto& keyframe : m_keyframes) {
+        bytes += sizeof(AStarKeyframe) + keyframe.grid.getMemoryBytes();
+    }
+    for (const auto& step : m_steps) {
+        bytes += sizeof(AStarStep) + step.changes.capacity() * sizeof(AStarCellChange);
+    }
+    return bytes;
 }
\ No newline at end of file
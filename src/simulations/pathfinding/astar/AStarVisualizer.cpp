@@ -4,6 +4,13 @@
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
+
+static const int CROWD_AGENT_COUNT = 20000;
+static const int COOPERATIVE_AGENT_COUNT = 60;
+static const int COOPERATIVE_WINDOW = 8;             // Replans after half of it
+static const float COOPERATIVE_STEP_SECONDS = 0.15f;
+static const int MUD_WEIGHT = 5;                     // Painted with D; roads cost 1
 
 AStarVisualizer::AStarVisualizer() 
     : m_controller(nullptr)
@@ -22,6 +29,8 @@ AStarVisualizer::AStarVisualizer()
     , m_pathColor(255, 255, 0)          // Bright amber (final path)
     , m_currentColor(255, 255, 150)     // Bright amber (current cell)
     , m_inactiveColor(0, 102, 0)        // Dim green
+    , m_plannedColor(255, 255, 0, 110)  // Faded amber (incremental plan)
+    , m_terrainColor(120, 80, 20)       // Mud brown (heaviest terrain)
     , m_gridAreaX(50.0f)
     , m_gridAreaY(100.0f)
     , m_gridAreaWidth(900.0f)
@@ -29,6 +38,9 @@ AStarVisualizer::AStarVisualizer()
     , m_cellSize(20.0f)
     , m_gridOffsetX(0.0f)
     , m_gridOffsetY(0.0f)
+    , m_scrubBarY(503.0f)
+    , m_scrubBarHeight(8.0f)
+    , m_scrubbing(false)
     , m_stepCount(0)
     , m_openListSize(0)
     , m_closedListSize(0)
@@ -37,6 +49,12 @@ AStarVisualizer::AStarVisualizer()
     , m_hoveredGridX(-1)
     , m_hoveredGridY(-1)
     , m_mousePressed(false)
+    , m_editBatchOpen(false)
+    , m_crowdActive(false)
+    , m_cooperativeActive(false)
+    , m_cooperativeStep(0)
+    , m_cooperativeClock(0.0f)
+    , m_cooperativeRng(7)
     , m_viewInitialized(false)
 {
 }
@@ -65,7 +83,10 @@ void AStarVisualizer::initialize(sf::RenderWindow& window) {
 }
 
 void AStarVisualizer::setController(AStarController* controller) {
+    flushEdits();
     m_controller = controller;
+    m_crowd.clear();
+    m_cooperativeActive = false;
     
     if (m_controller) {
         // Set up callback to receive step updates
@@ -85,6 +106,8 @@ void AStarVisualizer::handleEvent(const sf::Event* event) {
     if (!m_controller || !event) return;
     
     if (auto keyPressed = event->getIf<sf::Event::KeyPressed>()) {
+        // Commands see the grid as painted so far this frame
+        flushEdits();
         switch (keyPressed->code) {
             case sf::Keyboard::Key::Left:
                 navigateControlsLeft();
@@ -104,11 +127,68 @@ void AStarVisualizer::handleEvent(const sf::Event* event) {
             case sf::Keyboard::Key::G:
                 m_editMode = (m_editMode == EditMode::PLACE_GOAL) ? EditMode::NONE : EditMode::PLACE_GOAL;
                 break;
+            case sf::Keyboard::Key::D:
+                m_editMode = (m_editMode == EditMode::PAINT_MUD) ? EditMode::NONE : EditMode::PAINT_MUD;
+                break;
             case sf::Keyboard::Key::C:
                 m_controller->clearGrid();
                 break;
+            case sf::Keyboard::Key::V:
+                // Noise terrain on, or every cell back to road
+                if (m_controller->hasWeights()) {
+                    m_controller->clearWeights();
+                } else {
+                    m_controller->generateTerrain(m_controller->getMapSeed() + 1, AStarController::MAX_CELL_WEIGHT);
+                }
+                break;
+            case sf::Keyboard::Key::O:
+                m_controller->setOpenListKind(static_cast<AStarOpenListKind>((static_cast<int>(m_controller->getOpenListKind()) + 1) % 3));
+                m_controller->reset();
+                break;
             case sf::Keyboard::Key::R:
-                m_controller->generateRandomMaze(0.3f);
+            case sf::Keyboard::Key::K: {
+                // R: another map of the same kind; K: the next kind. Seeds count up, so a session replays
+                MapGeneratorKind kind = m_controller->getMapKind();
+                if (keyPressed->code == sf::Keyboard::Key::K) {
+                    kind = static_cast<MapGeneratorKind>((static_cast<int>(kind) + 1) % 6);
+                }
+                m_controller->generateMap(kind, m_controller->getMapSeed() + 1, MapGenerator::getDefaultDensity(kind));
+                break;
+            }
+            case sf::Keyboard::Key::J:
+                cycleSearchEngine();
+                break;
+            case sf::Keyboard::Key::N:
+                m_controller->setNeighborhood(m_controller->getNeighborhood() == AStarNeighborhood::FOUR ?
+                                              AStarNeighborhood::EIGHT : AStarNeighborhood::FOUR);
+                m_controller->reset();
+                break;
+            case sf::Keyboard::Key::H:
+                m_controller->setHeuristic(static_cast<AStarHeuristic>((static_cast<int>(m_controller->getHeuristic()) + 1) % 6));
+                m_controller->reset();
+                break;
+            case sf::Keyboard::Key::T:
+                m_controller->setTieBreak(static_cast<AStarTieBreak>((static_cast<int>(m_controller->getTieBreak()) + 1) % 3));
+                m_controller->reset();
+                break;
+            case sf::Keyboard::Key::P:
+                m_controller->setPlannerKind(m_controller->getPlannerKind() == AStarPlannerKind::INCREMENTAL ?
+                                             AStarPlannerKind::HIERARCHICAL : AStarPlannerKind::INCREMENTAL);
+                break;
+            case sf::Keyboard::Key::F:
+                // Spawned on the next update, against the field of the map as it is then
+                m_crowdActive = !m_crowdActive;
+                m_crowd.clear();
+                break;
+            case sf::Keyboard::Key::M:
+                m_cooperativeActive = !m_cooperativeActive;
+                if (m_cooperativeActive) {
+                    startCooperativeAgents();
+                }
+                break;
+            case sf::Keyboard::Key::B:
+                // Small enough to run inline; each engine searches its own copy of the map
+                m_engineResults = m_controller->measureSearchEngines(3);
                 break;
             case sf::Keyboard::Key::Escape:
                 m_editMode = EditMode::NONE;
@@ -119,29 +199,101 @@ void AStarVisualizer::handleEvent(const sf::Event* event) {
     }
     else if (auto mousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
         if (mousePressed->button == sf::Mouse::Button::Left) {
-            m_mousePressed = true;
-            handleMouseClick(mousePressed->position.x, mousePressed->position.y);
+            flushEdits();
+            m_scrubbing = handleScrub(mousePressed->position.x, mousePressed->position.y);
+            if (!m_scrubbing) {
+                m_mousePressed = true;
+                handleMouseClick(mousePressed->position.x, mousePressed->position.y);
+            }
         }
     }
     else if (auto mouseReleased = event->getIf<sf::Event::MouseButtonReleased>()) {
         if (mouseReleased->button == sf::Mouse::Button::Left) {
             m_mousePressed = false;
+            m_scrubbing = false;
         }
     }
     else if (auto mouseMoved = event->getIf<sf::Event::MouseMoved>()) {
-        handleMouseMove(mouseMoved->position.x, mouseMoved->position.y);
+        if (m_scrubbing) {
+            handleScrub(mouseMoved->position.x, static_cast<int>(m_scrubBarY));
+        } else {
+            handleMouseMove(mouseMoved->position.x, mouseMoved->position.y);
+        }
     }
 }
 
 void AStarVisualizer::update(float deltaTime) {
+    // One plan repair per frame no matter how many cells the drag crossed
+    flushEdits();
+    
     // Update controller (algorithm stepping)
     if (m_controller) {
         m_controller->update(deltaTime);
+        
+        // Edits only dirty the field; the first lookup after them rebuilds it once
+        if (m_crowdActive) {
+            const FlowField& field = m_controller->getFlowField();
+            if (m_crowd.getAgentCount() == 0) {
+                m_crowd.spawn(field, CROWD_AGENT_COUNT, 1);
+            }
+            m_crowd.update(field, deltaTime);
+        }
+        if (m_cooperativeActive) {
+            advanceCooperativeAgents(deltaTime);
+        }
+    }
+}
+
+void AStarVisualizer::startCooperativeAgents() {
+    const AStarGrid& grid = m_controller->getOriginalGrid();
+    m_cooperative.initialize(grid.width, grid.height, COOPERATIVE_WINDOW);
+    std::vector<int> openCells;
+    for (int i = 0; i < grid.size(); i++) {
+        if (grid.types[i] == CellType::WALL) m_cooperative.setBlocked(i, true);
+        else openCells.push_back(i);
+    }
+    
+    // Distinct starts and distinct goals, or agents would begin stacked
+    int agentCount = std::min<int>(COOPERATIVE_AGENT_COUNT, static_cast<int>(openCells.size()));
+    std::shuffle(openCells.begin(), openCells.end(), m_cooperativeRng);
+    std::vector<int> starts(openCells.begin(), openCells.begin() + agentCount);
+    std::shuffle(openCells.begin(), openCells.end(), m_cooperativeRng);
+    for (int i = 0; i < agentCount; i++) {
+        m_cooperative.addAgent(starts[i], openCells[i]);
+    }
+    m_cooperative.planWindow();
+    m_cooperativeStep = 0;
+    m_cooperativeClock = 0.0f;
+}
+
+void AStarVisualizer::advanceCooperativeAgents(float deltaTime) {
+    m_cooperativeClock += deltaTime;
+    while (m_cooperativeClock >= COOPERATIVE_STEP_SECONDS) {
+        m_cooperativeClock -= COOPERATIVE_STEP_SECONDS;
+        if (++m_cooperativeStep < COOPERATIVE_WINDOW / 2) continue;
+        
+        // Half the window walked: pick up wall edits, send arrivals on, replan
+        m_cooperative.advance(m_cooperativeStep);
+        m_cooperativeStep = 0;
+        const AStarGrid& grid = m_controller->getOriginalGrid();
+        for (int i = 0; i < grid.size(); i++) {
+            m_cooperative.setBlocked(i, grid.types[i] == CellType::WALL);
+        }
+        for (int agent = 0; agent < m_cooperative.getAgentCount(); agent++) {
+            if (m_cooperative.getPosition(agent) != m_cooperative.getGoal(agent)) continue;
+            int goal = static_cast<int>(m_cooperativeRng() % grid.size());
+            for (int tries = 0; tries < 16 && grid.types[goal] == CellType::WALL; tries++) {
+                goal = static_cast<int>(m_cooperativeRng() % grid.size());
+            }
+            m_cooperative.setGoal(agent, goal);
+        }
+        m_cooperative.planWindow();
     }
 }
 
 void AStarVisualizer::render(sf::RenderWindow& window) {
     drawGrid(window);
+    drawScrubBar(window);
     drawInfo(window);
     drawControls(window);
 }
@@ -155,14 +307,14 @@ void AStarVisualizer::drawGrid(sf::RenderWindow& window) {
     if (grid.empty()) return;
     
     // Calculate cell size based on grid dimensions and available space
-    float cellWidth = m_gridAreaWidth / grid[0].size();
-    float cellHeight = m_gridAreaHeight / grid.size();
+    float cellWidth = m_gridAreaWidth / grid.width;
+    float cellHeight = m_gridAreaHeight / grid.height;
     m_cellSize = std::min(cellWidth, cellHeight);
     m_cellSize = std::min(m_cellSize, 30.0f); // Cap the cell size
     
     // Center the grid
-    float totalWidth = grid[0].size() * m_cellSize;
-    float totalHeight = grid.size() * m_cellSize;
+    float totalWidth = grid.width * m_cellSize;
+    float totalHeight = grid.height * m_cellSize;
     m_gridOffsetX = m_gridAreaX + (m_gridAreaWidth - totalWidth) / 2.0f;
     m_gridOffsetY = m_gridAreaY + (m_gridAreaHeight - totalHeight) / 2.0f;
     
@@ -175,56 +327,75 @@ void AStarVisualizer::drawGrid(sf::RenderWindow& window) {
     gridBg.setOutlineColor(m_primaryColor);
     window.draw(gridBg);
     
-    // Draw grid cells
-    for (size_t y = 0; y < grid.size(); ++y) {
-        for (size_t x = 0; x < grid[y].size(); ++x) {
-            sf::RectangleShape cell;
-            
+    // Cell borders: the gaps between cells show this color
+    sf::RectangleShape cellBorders;
+    cellBorders.setPosition(sf::Vector2f(m_gridOffsetX - 0.5f, m_gridOffsetY - 0.5f));
+    cellBorders.setSize(sf::Vector2f(totalWidth, totalHeight));
+    cellBorders.setFillColor(sf::Color(0, 50, 0));
+    window.draw(cellBorders);
+    
+    // Draw grid cells as one vertex batch; a shape per cell is a draw call
+    // per cell, which a 200x200 grid cannot afford at 60 fps
+    float cellExtent = m_cellSize - 1.0f;  // Small gap between cells
+    m_cellVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    m_cellVertices.resize(static_cast<size_t>(grid.size()) * 6);
+    for (int y = 0; y < grid.height; ++y) {
+        for (int x = 0; x < grid.width; ++x) {
             float posX = m_gridOffsetX + x * m_cellSize;
             float posY = m_gridOffsetY + y * m_cellSize;
+            sf::Color color = getCellColor(grid.types[grid.index(x, y)], grid.weights[grid.index(x, y)]);
             
-            cell.setPosition(sf::Vector2f(posX, posY));
-            cell.setSize(sf::Vector2f(m_cellSize - 1.0f, m_cellSize - 1.0f)); // Small gap between cells
-            cell.setFillColor(getCellColor(grid[y][x]));
-            
-            // Add subtle border
-            cell.setOutlineThickness(0.5f);
-            cell.setOutlineColor(sf::Color(0, 50, 0));
-            
-            // Highlight hovered cell
-            if (m_hoveredGridX == static_cast<int>(x) && m_hoveredGridY == static_cast<int>(y)) {
-                sf::Color hoverColor = cell.getFillColor();
-                hoverColor.a = 200;
-                cell.setFillColor(hoverColor);
-                cell.setOutlineColor(m_secondaryColor);
-                cell.setOutlineThickness(2.0f);
-            }
-            
-            window.draw(cell);
-            
-            // Highlight current cell being examined
-            if (step.hasCurrentCell && step.currentX == static_cast<int>(x) && step.currentY == static_cast<int>(y)) {
-                sf::RectangleShape highlight;
-                highlight.setPosition(sf::Vector2f(posX - 2, posY - 2));
-                highlight.setSize(sf::Vector2f(m_cellSize + 3, m_cellSize + 3));
-                highlight.setFillColor(sf::Color::Transparent);
-                highlight.setOutlineThickness(3.0f);
-                highlight.setOutlineColor(m_currentColor);
-                window.draw(highlight);
-            }
-            
-            // Path visualization is now handled separately
+            size_t v = static_cast<size_t>(grid.index(x, y)) * 6;
+            m_cellVertices[v + 0] = sf::Vertex(sf::Vector2f(posX, posY), color);
+            m_cellVertices[v + 1] = sf::Vertex(sf::Vector2f(posX + cellExtent, posY), color);
+            m_cellVertices[v + 2] = sf::Vertex(sf::Vector2f(posX, posY + cellExtent), color);
+            m_cellVertices[v + 3] = sf::Vertex(sf::Vector2f(posX + cellExtent, posY), color);
+            m_cellVertices[v + 4] = sf::Vertex(sf::Vector2f(posX + cellExtent, posY + cellExtent), color);
+            m_cellVertices[v + 5] = sf::Vertex(sf::Vector2f(posX, posY + cellExtent), color);
         }
     }
+    window.draw(m_cellVertices);
+    drawCrowd(window);
+    drawCooperativeAgents(window);
+    
+    // Highlight hovered cell
+    if (grid.inBounds(m_hoveredGridX, m_hoveredGridY)) {
+        sf::RectangleShape hovered;
+        hovered.setPosition(sf::Vector2f(m_gridOffsetX + m_hoveredGridX * m_cellSize, m_gridOffsetY + m_hoveredGridY * m_cellSize));
+        hovered.setSize(sf::Vector2f(cellExtent, cellExtent));
+        int hoveredIndex = grid.index(m_hoveredGridX, m_hoveredGridY);
+        sf::Color hoverColor = getCellColor(grid.types[hoveredIndex], grid.weights[hoveredIndex]);
+        hoverColor.a = 200;
+        hovered.setFillColor(hoverColor);
+        hovered.setOutlineColor(m_secondaryColor);
+        hovered.setOutlineThickness(2.0f);
+        window.draw(hovered);
+    }
+    
+    // Highlight current cell being examined
+    if (step.hasCurrentCell) {
+        sf::RectangleShape highlight;
+        highlight.setPosition(sf::Vector2f(m_gridOffsetX + step.currentX * m_cellSize - 2, m_gridOffsetY + step.currentY * m_cellSize - 2));
+        highlight.setSize(sf::Vector2f(m_cellSize + 3, m_cellSize + 3));
+        highlight.setFillColor(sf::Color::Transparent);
+        highlight.setOutlineThickness(3.0f);
+        highlight.setOutlineColor(m_currentColor);
+        window.draw(highlight);
+    }
     
     // Draw current path if we're examining a cell during search
     if (step.hasCurrentCell) {
         drawCurrentPath(window, step.currentX, step.currentY);
     }
     
-    // Draw final path if complete
-    if (!step.path.empty()) {
-        drawPath(window, step.path, m_pathColor, 4.0f);
+    // Draw final path if complete, otherwise the incrementally repaired plan.
+    // HPA* ignores terrain, so on weighted maps its plan would not be the route the search finds
+    bool planIgnoresTerrain = m_controller->getPlannerKind() == AStarPlannerKind::HIERARCHICAL && m_controller->hasWeights();
+    if (!m_controller->getCurrentPath().empty()) {
+        drawPath(window, m_controller->getCurrentPath(), m_pathColor, 4.0f);
+    } else if ((m_controller->getState() == AStarState::READY || m_controller->getState() == AStarState::PAUSED) &&
+               !planIgnoresTerrain) {
+        drawPath(window, m_controller->getPlannedPath(), m_plannedColor, 2.0f);
     }
     
     // Draw edit mode indicator
@@ -245,6 +416,10 @@ void AStarVisualizer::drawGrid(sf::RenderWindow& window) {
                 modeText = "GOAL PLACEMENT MODE (G to toggle, Click to place)";
                 modeColor = m_goalColor;
                 break;
+            case EditMode::PAINT_MUD:
+                modeText = "MUD PAINT MODE (D to toggle, Click to paint/clear, cost " + std::to_string(MUD_WEIGHT) + ")";
+                modeColor = m_terrainColor;
+                break;
             default:
                 break;
         }
@@ -258,6 +433,67 @@ void AStarVisualizer::drawGrid(sf::RenderWindow& window) {
     }
 }
 
+void AStarVisualizer::drawCrowd(sf::RenderWindow& window) {
+    if (!m_crowdActive || m_crowd.getAgentCount() == 0) return;
+    
+    // Same batching as the cells: tens of thousands of agents in one draw call
+    float half = std::max(1.0f, m_cellSize * 0.12f);
+    sf::Color color = m_currentColor;
+    color.a = 180;
+    const std::vector<float>& agentX = m_crowd.getX();
+    const std::vector<float>& agentY = m_crowd.getY();
+    m_agentVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    m_agentVertices.resize(agentX.size() * 6);
+    for (size_t i = 0; i < agentX.size(); ++i) {
+        float posX = m_gridOffsetX + agentX[i] * m_cellSize;
+        float posY = m_gridOffsetY + agentY[i] * m_cellSize;
+        
+        size_t v = i * 6;
+        m_agentVertices[v + 0] = sf::Vertex(sf::Vector2f(posX - half, posY - half), color);
+        m_agentVertices[v + 1] = sf::Vertex(sf::Vector2f(posX + half, posY - half), color);
+        m_agentVertices[v + 2] = sf::Vertex(sf::Vector2f(posX - half, posY + half), color);
+        m_agentVertices[v + 3] = sf::Vertex(sf::Vector2f(posX + half, posY - half), color);
+        m_agentVertices[v + 4] = sf::Vertex(sf::Vector2f(posX + half, posY + half), color);
+        m_agentVertices[v + 5] = sf::Vertex(sf::Vector2f(posX - half, posY + half), color);
+    }
+    window.draw(m_agentVertices);
+}
+
+void AStarVisualizer::drawCooperativeAgents(sf::RenderWindow& window) {
+    if (!m_cooperativeActive || m_cooperative.getAgentCount() == 0) return;
+    
+    // Each agent slides between its planned cells; its goal is a smaller square in its color
+    const AStarGrid& grid = m_controller->getOriginalGrid();
+    float progress = std::min(1.0f, m_cooperativeClock / COOPERATIVE_STEP_SECONDS);
+    float agentHalf = m_cellSize * 0.3f;
+    float goalHalf = m_cellSize * 0.15f;
+    m_cooperativeVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    m_cooperativeVertices.resize(static_cast<size_t>(m_cooperative.getAgentCount()) * 12);
+    auto placeSquare = [&](size_t v, float centerX, float centerY, float half, sf::Color color) {
+        m_cooperativeVertices[v + 0] = sf::Vertex(sf::Vector2f(centerX - half, centerY - half), color);
+        m_cooperativeVertices[v + 1] = sf::Vertex(sf::Vector2f(centerX + half, centerY - half), color);
+        m_cooperativeVertices[v + 2] = sf::Vertex(sf::Vector2f(centerX - half, centerY + half), color);
+        m_cooperativeVertices[v + 3] = sf::Vertex(sf::Vector2f(centerX + half, centerY - half), color);
+        m_cooperativeVertices[v + 4] = sf::Vertex(sf::Vector2f(centerX + half, centerY + half), color);
+        m_cooperativeVertices[v + 5] = sf::Vertex(sf::Vector2f(centerX - half, centerY + half), color);
+    };
+    for (int agent = 0; agent < m_cooperative.getAgentCount(); agent++) {
+        int from = m_cooperative.getPlannedCell(agent, m_cooperativeStep);
+        int to = m_cooperative.getPlannedCell(agent, m_cooperativeStep + 1);
+        float cellX = grid.toX(from) + (grid.toX(to) - grid.toX(from)) * progress + 0.5f;
+        float cellY = grid.toY(from) + (grid.toY(to) - grid.toY(from)) * progress + 0.5f;
+        sf::Color color(static_cast<std::uint8_t>(80 + agent * 53 % 176), static_cast<std::uint8_t>(80 + agent * 97 % 176),
+                        static_cast<std::uint8_t>(80 + agent * 151 % 176));
+        
+        int goal = m_cooperative.getGoal(agent);
+        size_t v = static_cast<size_t>(agent) * 12;
+        placeSquare(v, m_gridOffsetX + cellX * m_cellSize, m_gridOffsetY + cellY * m_cellSize, agentHalf, color);
+        placeSquare(v + 6, m_gridOffsetX + (grid.toX(goal) + 0.5f) * m_cellSize,
+                    m_gridOffsetY + (grid.toY(goal) + 0.5f) * m_cellSize, goalHalf, color);
+    }
+    window.draw(m_cooperativeVertices);
+}
+
 void AStarVisualizer::drawInfo(sf::RenderWindow& window) {
     if (!m_controller || !m_fontLoaded) return;
     
@@ -283,9 +519,9 @@ void AStarVisualizer::drawInfo(sf::RenderWindow& window) {
             break;
     }
     
-    const auto& step = m_controller->getCurrentStep();
-    if (!step.description.empty()) {
-        topInfo << " | " << step.description;
+    std::string description = m_controller->getCurrentDescription();
+    if (!description.empty()) {
+        topInfo << " | " << description;
     }
     
     sf::Text topText(m_font, topInfo.str(), 18);
@@ -296,9 +532,17 @@ void AStarVisualizer::drawInfo(sf::RenderWindow& window) {
     // Second line - Statistics
     std::stringstream statsInfo;
     statsInfo << "SPEED: " << static_cast<int>(m_controller->getSpeed()) << "ms | ";
-    statsInfo << "STEP: " << (m_controller->getCurrentStepIndex() + 1) << "/" << m_controller->getTotalSteps() << " | ";
+    statsInfo << "STEP: " << (m_controller->getCurrentStepIndex() + 1) << "/" << m_controller->getTotalSteps()
+              << (m_controller->isTraceComplete() ? "" : "+") << " | ";
     statsInfo << "OPEN LIST: " << m_controller->getOpenListSize() << " | ";
-    statsInfo << "CLOSED LIST: " << m_controller->getClosedListSize();
+    statsInfo << "CLOSED LIST: " << m_controller->getClosedListSize() << " | ";
+    statsInfo << "EXPANDED: " << m_controller->getSearchCounters().expansions << " | ";
+    if (m_controller->getPlannerKind() == AStarPlannerKind::HIERARCHICAL) {
+        const HierarchicalStats& hpa = m_controller->getHierarchicalStats();
+        statsInfo << "REPLAN: " << hpa.sectorsRebuilt << " sectors, " << hpa.abstractExpansions << " nodes";
+    } else {
+        statsInfo << "REPLAN: " << m_controller->getPlannerCounters().lastExpansions << " cells";
+    }
     
     sf::Text statsText(m_font, statsInfo.str(), 16);
     statsText.setFillColor(m_inactiveColor);
@@ -318,9 +562,11 @@ void AStarVisualizer::drawInfo(sf::RenderWindow& window) {
             {m_startColor, "START"},
             {m_goalColor, "GOAL"},
             {m_wallColor, "WALL"},
+            {m_terrainColor, "MUD (HEAVIER = DARKER)"},
             {m_openListColor, "TO EXPLORE"},
             {m_closedListColor, "EXPLORED"},
             {m_pathColor, "FINAL PATH"},
+            {m_plannedColor, "PLANNED"},
             {m_currentColor, "CURRENT"}
         };
         
@@ -340,6 +586,72 @@ void AStarVisualizer::drawInfo(sf::RenderWindow& window) {
             label.setPosition({990.0f, itemY - 2});
             window.draw(label);
         }
+        
+        // Engine comparison on the current map (B to measure)
+        float engineY = legendY + 25 + legendItems.size() * 20 + 20;
+        sf::Text engineTitle(m_font, "ENGINE: " + AStarController::getSearchEngineName(m_controller->getSearchEngine()) + " (J)", 14);
+        engineTitle.setFillColor(m_primaryColor);
+        engineTitle.setPosition({970.0f, engineY});
+        window.draw(engineTitle);
+        
+        std::vector<std::string> engineLines;
+        engineLines.push_back(std::string("N: ") + (m_controller->getNeighborhood() == AStarNeighborhood::EIGHT ? "8-WAY" : "4-WAY"));
+        engineLines.push_back("H: " + AStarController::getHeuristicName(m_controller->getHeuristic()));
+        if (m_controller->getHeuristic() == AStarHeuristic::LANDMARKS) {
+            // Cost of the last rebuild; edits patched in place since then cost nothing
+            const LandmarkStats& alt = m_controller->getLandmarkStats();
+            std::stringstream landmarks;
+            landmarks << "   TABLES " << alt.tablesRebuilt << " ON " << alt.threadCount << " THREADS, " << std::fixed
+                      << std::setprecision(2) << alt.buildMs << "ms, " << alt.editsAbsorbed << " EDITS PATCHED";
+            engineLines.push_back(landmarks.str());
+        }
+        engineLines.push_back("T: TIES " + AStarController::getTieBreakName(m_controller->getTieBreak()));
+        std::string openList = "O: OPEN " + AStarController::getOpenListName(m_controller->getOpenListKind());
+        if (m_controller->getOpenListKind() == AStarOpenListKind::BUCKET_QUEUE && !m_controller->isBucketQueueActive()) {
+            openList += " (HEAP: FRACTIONAL F)";
+        }
+        engineLines.push_back(openList);
+        engineLines.push_back(std::string("V: TERRAIN ") + (m_controller->hasWeights() ? "ON" : "OFF"));
+        std::string plan = "P: PLAN " + AStarController::getPlannerName(m_controller->getPlannerKind());
+        if (m_controller->getPlannerKind() == AStarPlannerKind::HIERARCHICAL && m_controller->hasWeights()) {
+            plan += " (HIDDEN: IGNORES TERRAIN)";
+        }
+        engineLines.push_back(plan);
+        std::stringstream map;
+        map << "R/K: MAP " << MapGenerator::getKindName(m_controller->getMapKind()) << ", SEED " << m_controller->getMapSeed()
+            << ", " << std::fixed << std::setprecision(2) << m_controller->getMapGenerationMs() << "ms";
+        engineLines.push_back(map.str());
+        if (m_crowdActive) {
+            std::stringstream crowd;
+            crowd << "F: CROWD " << m_crowd.getAgentCount() << ", FIELD " << std::fixed << std::setprecision(2)
+                  << m_controller->getFlowField().getStats().buildMs << "ms, TICK " << m_crowd.getLastTick().tickMs << "ms";
+            engineLines.push_back(crowd.str());
+        } else {
+            engineLines.push_back("F: CROWD OFF");
+        }
+        if (m_cooperativeActive) {
+            std::stringstream agents;
+            agents << "M: AGENTS " << m_cooperative.getArrivedCount() << "/" << m_cooperative.getAgentCount()
+                   << " HOME, PLAN " << std::fixed << std::setprecision(2) << m_cooperative.getStats().wallMs << "ms";
+            engineLines.push_back(agents.str());
+        } else {
+            engineLines.push_back("M: AGENTS OFF");
+        }
+        if (m_engineResults.empty()) {
+            engineLines.push_back("B: compare engines");
+        }
+        for (const auto& result : m_engineResults) {
+            std::stringstream line;
+            line << AStarController::getSearchEngineName(result.engine) << ": " << result.expansions << " exp "
+                 << std::fixed << std::setprecision(2) << result.runtimeMs << "ms";
+            engineLines.push_back(line.str());
+        }
+        for (size_t i = 0; i < engineLines.size(); ++i) {
+            sf::Text engineLine(m_font, engineLines[i], 12);
+            engineLine.setFillColor(m_inactiveColor);
+            engineLine.setPosition({970.0f, engineY + 22 + i * 18});
+            window.draw(engineLine);
+        }
     }
 }
 
@@ -347,7 +659,7 @@ void AStarVisualizer::drawControls(sf::RenderWindow& window) {
     if (!m_fontLoaded) return;
     
     // Draw instruction text
-    sf::Text instructionText(m_font, "CONTROLS: LEFT/RIGHT to navigate, ENTER to select | W: Wall mode, S: Start mode, G: Goal mode, C: Clear grid, R: Random maze", 12);
+    sf::Text instructionText(m_font, "CONTROLS: LEFT/RIGHT to navigate, ENTER to select | W: Wall mode, S: Start mode, G: Goal mode, D: Mud mode, C: Clear grid, R/K: New map/Generator, V: Terrain, J: Engine, N/H/T/O: Moves/Heuristic/Ties/Open list, B: Compare, F: Crowd, M: Agents, click timeline to seek", 12);
     instructionText.setFillColor(m_inactiveColor);
     instructionText.setPosition({50.0f, 520.0f});
     window.draw(instructionText);
@@ -364,6 +676,44 @@ void AStarVisualizer::drawControls(sf::RenderWindow& window) {
     }
 }
 
+void AStarVisualizer::drawScrubBar(sf::RenderWindow& window) {
+    if (!m_controller || m_controller->getTotalSteps() == 0) return;
+    
+    sf::RectangleShape track;
+    track.setPosition(sf::Vector2f(m_gridAreaX, m_scrubBarY));
+    track.setSize(sf::Vector2f(m_gridAreaWidth, m_scrubBarHeight));
+    track.setFillColor(m_backgroundColor);
+    track.setOutlineThickness(1.0f);
+    track.setOutlineColor(m_inactiveColor);
+    window.draw(track);
+    
+    size_t lastStep = m_controller->getTotalSteps() - 1;
+    float progress = lastStep > 0 ? static_cast<float>(m_controller->getCurrentStepIndex()) / lastStep : 1.0f;
+    
+    sf::RectangleShape fill;
+    fill.setPosition(sf::Vector2f(m_gridAreaX, m_scrubBarY));
+    fill.setSize(sf::Vector2f(m_gridAreaWidth * progress, m_scrubBarHeight));
+    fill.setFillColor(m_primaryColor);
+    window.draw(fill);
+}
+
+bool AStarVisualizer::handleScrub(int mouseX, int mouseY) {
+    if (!m_controller || m_controller->getTotalSteps() == 0) return false;
+    
+    // Accept clicks slightly above/below the bar so it is easy to grab
+    if (mouseY < m_scrubBarY - 4.0f || mouseY > m_scrubBarY + m_scrubBarHeight + 4.0f ||
+        mouseX < m_gridAreaX || mouseX > m_gridAreaX + m_gridAreaWidth) {
+        return false;
+    }
+    
+    float ratio = (mouseX - m_gridAreaX) / m_gridAreaWidth;
+    ratio = std::max(0.0f, std::min(1.0f, ratio));
+    
+    size_t lastStep = m_controller->getTotalSteps() - 1;
+    m_controller->seek(static_cast<size_t>(ratio * lastStep + 0.5f));
+    return true;
+}
+
 void AStarVisualizer::onAStarStep(const AStarStep& step) {
     // Update statistics
     m_stepCount = step.stepCount;
@@ -372,29 +722,39 @@ void AStarVisualizer::onAStarStep(const AStarStep& step) {
     
     // Play audio based on step type
     if (m_audioManager) {
-        if (step.description.find("Examining cell") != std::string::npos) {
-            // Play a tone when examining a cell
-            m_audioManager->playSound(SoundType::COMPARISON, 1.0f, 0.5f);
-        } else if (step.description.find("Added start") != std::string::npos) {
-            // Play start sound
-            m_audioManager->playSound(SoundType::PIVOT_SELECT, 1.0f, 0.7f);
-        } else if (step.description.find("Path found!") != std::string::npos) {
-            // Play success sound
-            m_audioManager->playSound(SoundType::ALGORITHM_COMPLETE, 1.0f, 1.0f);
-        } else if (step.description.find("No path exists") != std::string::npos) {
-            // Play failure sound
-            m_audioManager->playSound(SoundType::SWAP, 0.5f, 0.8f);
-        } else if (step.description.find("Building optimal path") != std::string::npos) {
-            // Play path building sound
-            m_audioManager->playSound(SoundType::MENU_SELECT, 1.2f, 0.6f);
+        switch (step.kind) {
+            case AStarStepKind::EXAMINE:
+                // Play a tone when examining a cell
+                m_audioManager->playSound(SoundType::COMPARISON, 1.0f, 0.5f);
+                break;
+            case AStarStepKind::START_OPENED:
+                // Play start sound
+                m_audioManager->playSound(SoundType::PIVOT_SELECT, 1.0f, 0.7f);
+                break;
+            case AStarStepKind::PATH_FOUND:
+                // Play success sound
+                m_audioManager->playSound(SoundType::ALGORITHM_COMPLETE, 1.0f, 1.0f);
+                break;
+            case AStarStepKind::NO_PATH:
+                // Play failure sound
+                m_audioManager->playSound(SoundType::SWAP, 0.5f, 0.8f);
+                break;
+            case AStarStepKind::BUILD_PATH:
+                // Play path building sound
+                m_audioManager->playSound(SoundType::MENU_SELECT, 1.2f, 0.6f);
+                break;
+            default:
+                break;
         }
     }
 }
 
-sf::Color AStarVisualizer::getCellColor(const GridCell& cell) {
-    switch (cell.type) {
+sf::Color AStarVisualizer::getCellColor(CellType type, int weight) {
+    sf::Color color;
+    switch (type) {
         case CellType::EMPTY:
-            return m_backgroundColor;
+            color = m_backgroundColor;
+            break;
         case CellType::WALL:
             return m_wallColor;
         case CellType::START:
@@ -402,14 +762,25 @@ sf::Color AStarVisualizer::getCellColor(const GridCell& cell) {
         case CellType::GOAL:
             return m_goalColor;
         case CellType::OPEN_LIST:
-            return m_openListColor;
+            color = m_openListColor;
+            break;
         case CellType::CLOSED_LIST:
-            return m_closedListColor;
+            color = m_closedListColor;
+            break;
         case CellType::PATH:
-            return m_pathColor;
+            color = m_pathColor;
+            break;
         default:
             return m_inactiveColor;
     }
+    if (weight <= 1) return color;
+    
+    // Empty cells take the full terrain shade; search overlays keep most of their own color
+    float shade = static_cast<float>(weight - 1) / (AStarController::MAX_CELL_WEIGHT - 1) * (type == CellType::EMPTY ? 1.0f : 0.5f);
+    auto blend = [shade](std::uint8_t from, std::uint8_t to) {
+        return static_cast<std::uint8_t>(from + (to - from) * shade);
+    };
+    return sf::Color(blend(color.r, m_terrainColor.r), blend(color.g, m_terrainColor.g), blend(color.b, m_terrainColor.b));
 }
 
 void AStarVisualizer::updateGridDisplay() {
@@ -537,6 +908,7 @@ void AStarVisualizer::handleMouseClick(int mouseX, int mouseY) {
     
     switch (m_editMode) {
         case EditMode::PLACE_WALL:
+            openEditBatch();
             m_controller->toggleWall(gridX, gridY);
             break;
         case EditMode::PLACE_START:
@@ -547,6 +919,10 @@ void AStarVisualizer::handleMouseClick(int mouseX, int mouseY) {
             m_controller->setGoal(gridX, gridY);
             m_editMode = EditMode::NONE; // Exit mode after placing
             break;
+        case EditMode::PAINT_MUD:
+            openEditBatch();
+            m_controller->setCellWeight(gridX, gridY, m_controller->getCellWeight(gridX, gridY) > 1 ? 1 : MUD_WEIGHT);
+            break;
         default:
             break;
     }
@@ -562,14 +938,45 @@ void AStarVisualizer::handleMouseMove(int mouseX, int mouseY) {
         // Handle wall painting while dragging
         if (m_mousePressed && m_editMode == EditMode::PLACE_WALL && 
             m_controller && m_controller->getState() == AStarState::READY) {
+            openEditBatch();
             m_controller->setWall(gridX, gridY);
         }
+        if (m_mousePressed && m_editMode == EditMode::PAINT_MUD &&
+            m_controller && m_controller->getState() == AStarState::READY) {
+            openEditBatch();
+            m_controller->setCellWeight(gridX, gridY, MUD_WEIGHT);
+        }
     } else {
         m_hoveredGridX = -1;
         m_hoveredGridY = -1;
     }
 }
 
+void AStarVisualizer::cycleSearchEngine() {
+    AStarSearchEngine engine = m_controller->getSearchEngine();
+    switch (engine) {
+        case AStarSearchEngine::ASTAR: engine = AStarSearchEngine::JPS; break;
+        case AStarSearchEngine::JPS: engine = AStarSearchEngine::JPS_PLUS; break;
+        case AStarSearchEngine::JPS_PLUS: engine = AStarSearchEngine::ASTAR; break;
+    }
+    m_controller->setSearchEngine(engine);
+    m_controller->reset();
+}
+
+void AStarVisualizer::openEditBatch() {
+    if (!m_editBatchOpen) {
+        m_controller->beginEdit();
+        m_editBatchOpen = true;
+    }
+}
+
+void AStarVisualizer::flushEdits() {
+    if (m_editBatchOpen && m_controller) {
+        m_controller->commitEdit();
+    }
+    m_editBatchOpen = false;
+}
+
 std::pair<int, int> AStarVisualizer::screenToGrid(int screenX, int screenY) {
     if (!m_controller || m_cellSize <= 0) return {-1, -1};
     
@@ -632,13 +1039,13 @@ void AStarVisualizer::drawPath(sf::RenderWindow& window, const std::vector<std::
             // Draw end caps (circles)
             if (i == 1) { // Start cap
                 sf::CircleShape startCap(thickness * 0.5f);
-                startCap.setPosition(x1 - thickness * 0.5f, y1 - thickness * 0.5f);
+                startCap.setPosition({x1 - thickness * 0.5f, y1 - thickness * 0.5f});
                 startCap.setFillColor(color);
                 window.draw(startCap);
             }
             if (i == path.size() - 1) { // End cap
                 sf::CircleShape endCap(thickness * 0.5f);
-                endCap.setPosition(x2 - thickness * 0.5f, y2 - thickness * 0.5f);
+                endCap.setPosition({x2 - thickness * 0.5f, y2 - thickness * 0.5f});
                 endCap.setFillColor(color);
                 window.draw(endCap);
             }
@@ -647,22 +1054,22 @@ void AStarVisualizer::drawPath(sf::RenderWindow& window, const std::vector<std::
 }
 
 void AStarVisualizer::drawCurrentPath(sf::RenderWindow& window, int currentX, int currentY) {
-    if (!m_controller || m_steps.empty()) return;
+    if (!m_controller || m_controller->getTotalSteps() == 0) return;
     
-    // Get the current step's grid to access parent information
-    const auto& currentGrid = m_controller->getCurrentStep().grid;
-    if (currentY >= static_cast<int>(currentGrid.size()) || 
-        currentX >= static_cast<int>(currentGrid[currentY].size())) return;
+    // The displayed grid holds the parents as of the current step
+    const auto& currentGrid = m_controller->getCurrentGrid();
+    if (!currentGrid.inBounds(currentX, currentY)) return;
     
     // Trace back from current cell to start to show potential path
     std::vector<std::pair<int, int>> currentPath;
     int x = currentX;
     int y = currentY;
     
-    while (x != -1 && y != -1 && currentGrid[y][x].hasParent) {
+    while (x != -1 && y != -1 && currentGrid.parent[currentGrid.index(x, y)] >= 0) {
         currentPath.push_back({x, y});
-        int parentX = currentGrid[y][x].parentX;
-        int parentY = currentGrid[y][x].parentY;
+        int parentIndex = currentGrid.parent[currentGrid.index(x, y)];
+        int parentX = currentGrid.toX(parentIndex);
+        int parentY = currentGrid.toY(parentIndex);
         
         // Prevent infinite loops
         if (parentX == x && parentY == y) break;
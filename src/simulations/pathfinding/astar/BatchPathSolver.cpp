@@ -0,0 +1,177 @@
+#include "simulations/pathfinding/astar/BatchPathSolver.h"
+#include "simulations/pathfinding/astar/SearchPolicies.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+// Queries claimed per atomic increment; small enough to balance uneven
+// queries, large enough that the counter is not contended
+static const size_t QUERIES_PER_CLAIM = 8;
+
+BatchPathSolver::BatchPathSolver(int threadCount)
+    : m_threadCount(threadCount)
+    , m_neighborhood(AStarNeighborhood::FOUR)
+    , m_heuristic(AStarHeuristic::MANHATTAN)
+{
+    if (m_threadCount <= 0) {
+        m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    m_scratch.resize(m_threadCount);
+}
+
+std::vector<PathQueryResult> BatchPathSolver::solveBatch(const AStarGrid& grid, const std::vector<PathQuery>& queries) {
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<PathQueryResult> results(queries.size());
+    QueryKernel kernel = selectKernel();
+    
+    // No point waking threads that would find the queue already empty
+    size_t claims = (queries.size() + QUERIES_PER_CLAIM - 1) / QUERIES_PER_CLAIM;
+    int workerCount = static_cast<int>(std::min<size_t>(m_threadCount, std::max<size_t>(1, claims)));
+    
+    std::atomic<size_t> nextQuery(0);
+    auto workerLoop = [&](int workerId) {
+        Scratch& scratch = m_scratch[workerId];
+        prepareScratch(scratch, grid.size());
+        while (true) {
+            size_t first = nextQuery.fetch_add(QUERIES_PER_CLAIM, std::memory_order_relaxed);
+            if (first >= queries.size()) break;
+            size_t last = std::min(first + QUERIES_PER_CLAIM, queries.size());
+            for (size_t i = first; i < last; i++) {
+                auto queryBegin = std::chrono::steady_clock::now();
+                kernel(grid, queries[i], scratch, results[i]);
+                auto queryEnd = std::chrono::steady_clock::now();
+                results[i].runtimeUs = std::chrono::duration<double, std::micro>(queryEnd - queryBegin).count();
+            }
+        }
+    };
+    
+    // The calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workerCount; i++) {
+        threads.emplace_back(workerLoop, i);
+    }
+    workerLoop(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    auto end = std::chrono::steady_clock::now();
+    m_lastStats = BatchSolveStats();
+    m_lastStats.threadCount = workerCount;
+    m_lastStats.queryCount = queries.size();
+    m_lastStats.wallMs = std::chrono::duration<double, std::milli>(end - begin).count();
+    m_lastStats.queriesPerSecond = m_lastStats.wallMs > 0.0 ? queries.size() / (m_lastStats.wallMs / 1000.0) : 0.0;
+    for (const auto& result : results) {
+        m_lastStats.expansions += result.expansions;
+    }
+    return results;
+}
+
+BatchPathSolver::QueryKernel BatchPathSolver::selectKernel() const {
+    switch (m_heuristic) {
+        case AStarHeuristic::MANHATTAN: return selectKernel<ManhattanHeuristic>();
+        case AStarHeuristic::OCTILE: return selectKernel<OctileHeuristic>();
+        case AStarHeuristic::EUCLIDEAN: return selectKernel<EuclideanHeuristic>();
+        case AStarHeuristic::CHEBYSHEV: return selectKernel<ChebyshevHeuristic>();
+        case AStarHeuristic::ZERO: return selectKernel<ZeroHeuristic>();
+        // Landmark tables belong to one controller's map, not to a batch; the
+        // octile part of the ALT bound is admissible either way
+        case AStarHeuristic::LANDMARKS: return selectKernel<OctileHeuristic>();
+    }
+    return selectKernel<ManhattanHeuristic>();
+}
+
+template <typename Heuristic>
+BatchPathSolver::QueryKernel BatchPathSolver::selectKernel() const {
+    if (m_neighborhood == AStarNeighborhood::EIGHT) {
+        return &BatchPathSolver::solveQuery<EightConnected, Heuristic>;
+    }
+    return &BatchPathSolver::solveQuery<FourConnected, Heuristic>;
+}
+
+template <typename Neighborhood, typename Heuristic>
+void BatchPathSolver::solveQuery(const AStarGrid& grid, const PathQuery& query, Scratch& scratch, PathQueryResult& result) {
+    result = PathQueryResult();
+    const CellType* types = grid.types.data();
+    int cellCount = grid.size();
+    if (query.startIndex < 0 || query.startIndex >= cellCount || query.goalIndex < 0 || query.goalIndex >= cellCount ||
+        types[query.startIndex] == CellType::WALL || types[query.goalIndex] == CellType::WALL) {
+        return;
+    }
+    
+    if (++scratch.generation == 0) {
+        std::fill(scratch.seenStamp.begin(), scratch.seenStamp.end(), 0);
+        std::fill(scratch.closedStamp.begin(), scratch.closedStamp.end(), 0);
+        scratch.generation = 1;
+    }
+    std::uint32_t generation = scratch.generation;
+    scratch.open.reset(cellCount);
+    
+    int goalX = grid.toX(query.goalIndex);
+    int goalY = grid.toY(query.goalIndex);
+    auto estimate = [&](int x, int y) { return Heuristic::estimate(std::abs(x - goalX), std::abs(y - goalY)); };
+    
+    scratch.gCost[query.startIndex] = 0.0f;
+    scratch.parent[query.startIndex] = -1;
+    scratch.seenStamp[query.startIndex] = generation;
+    float startH = estimate(grid.toX(query.startIndex), grid.toY(query.startIndex));
+    scratch.open.push(query.startIndex, {startH, startH});
+    result.heapPushes++;
+    
+    auto walkable = [&](int x, int y) { return types[grid.index(x, y)] != CellType::WALL; };
+    while (!scratch.open.empty()) {
+        int cellIndex = scratch.open.pop();
+        if (cellIndex == query.goalIndex) {
+            result.cost = scratch.gCost[cellIndex];
+            for (int cell = cellIndex; cell != -1; cell = scratch.parent[cell]) {
+                result.path.push_back(cell);
+            }
+            std::reverse(result.path.begin(), result.path.end());
+            return;
+        }
+        scratch.closedStamp[cellIndex] = generation;
+        result.expansions++;
+        
+        int x = grid.toX(cellIndex);
+        int y = grid.toY(cellIndex);
+        float g = scratch.gCost[cellIndex];
+        for (int direction = 0; direction < Neighborhood::COUNT; direction++) {
+            int nx = x + Neighborhood::DX[direction];
+            int ny = y + Neighborhood::DY[direction];
+            if (!grid.inBounds(nx, ny) || !walkable(nx, ny)) continue;
+            if (Neighborhood::isDiagonal(direction) && (!walkable(nx, y) || !walkable(x, ny))) {
+                continue;  // Would cut a wall corner
+            }
+            
+            int next = grid.index(nx, ny);
+            if (scratch.closedStamp[next] == generation) continue;
+            float tentative = g + Neighborhood::cost(direction);
+            bool seen = scratch.seenStamp[next] == generation;
+            if (seen && tentative >= scratch.gCost[next]) continue;
+            
+            scratch.gCost[next] = tentative;
+            scratch.parent[next] = cellIndex;
+            scratch.seenStamp[next] = generation;
+            float h = estimate(nx, ny);
+            if (seen) {
+                scratch.open.decreaseKey(next, {tentative + h, h});
+            } else {
+                scratch.open.push(next, {tentative + h, h});
+                result.heapPushes++;
+            }
+        }
+    }
+}
+
+void BatchPathSolver::prepareScratch(Scratch& scratch, int cellCount) {
+    // Reused as long as the grid keeps its size; stamps make the contents irrelevant
+    if (static_cast<int>(scratch.gCost.size()) == cellCount) return;
+    scratch.gCost.assign(cellCount, 0.0f);
+    scratch.parent.assign(cellCount, -1);
+    scratch.seenStamp.assign(cellCount, 0);
+    scratch.closedStamp.assign(cellCount, 0);
+    scratch.generation = 0;
+    scratch.open.reset(cellCount);
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "simulations/pathfinding/astar/BitParallelBfs.h"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int countTrailingZeros(std::uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static int countBits(std::uint64_t bits) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+// Sweep whole rows while active words make up at least 1 in this many of
+// the words in the frontier's row span
+static const size_t DENSE_SWEEP_RATIO = 8;
+
+BitParallelBfs::BitParallelBfs()
+    : m_width(0)
+    , m_height(0)
+    , m_wordsPerRow(0)
+    , m_stride(0)
+    , m_waveStamp(0)
+    , m_firstRow(0)
+    , m_lastRow(0)
+    , m_source(-1)
+{
+}
+
+void BitParallelBfs::initialize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_wordsPerRow = (width + 63) / 64;
+    m_stride = m_wordsPerRow + 2;
+    
+    size_t wordCount = static_cast<size_t>(height + 2) * m_stride;
+    m_open.assign(wordCount, 0);
+    m_reached.assign(wordCount, 0);
+    m_frontier.assign(wordCount, 0);
+    m_next.assign(wordCount, 0);
+    m_wordStamp.assign(wordCount, 0);
+    m_waveStamp = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            m_open[wordIndex(x, y + 1)] |= std::uint64_t(1) << (x % 64);
+        }
+    }
+    m_distances.assign(static_cast<size_t>(width) * height, -1);
+    m_source = -1;
+    m_stats = BitBfsStats();
+}
+
+void BitParallelBfs::setBlocked(int cellIndex, bool blocked) {
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    std::uint64_t bit = std::uint64_t(1) << (x % 64);
+    if (blocked) {
+        m_open[wordIndex(x, y + 1)] &= ~bit;
+    } else {
+        m_open[wordIndex(x, y + 1)] |= bit;
+    }
+}
+
+bool BitParallelBfs::isBlocked(int cellIndex) const {
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    return !(m_open[wordIndex(x, y + 1)] & (std::uint64_t(1) << (x % 64)));
+}
+
+void BitParallelBfs::computeDistanceField(int sourceIndex) {
+    std::fill(m_distances.begin(), m_distances.end(), -1);
+    m_source = sourceIndex;
+    if (!seed(sourceIndex)) return;
+    m_distances[sourceIndex] = 0;
+    
+    while (advanceWave()) {
+        // Only new bits need a distance, one trailing-zero count per cell
+        int wave = m_stats.waves;
+        for (size_t wordIndex : m_activeWords) {
+            int row = static_cast<int>(wordIndex / m_stride) - 1;
+            int firstX = (static_cast<int>(wordIndex % m_stride) - 1) * 64;
+            int* distances = &m_distances[static_cast<size_t>(row) * m_width + firstX];
+            std::uint64_t bits = m_frontier[wordIndex];
+            while (bits) {
+                distances[countTrailingZeros(bits)] = wave;
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+bool BitParallelBfs::extractPath(int targetIndex, std::vector<int>& path) const {
+    path.clear();
+    if (m_source < 0 || m_distances[targetIndex] < 0) return false;
+    
+    // Any neighbor one step closer lies on a shortest path
+    int cell = targetIndex;
+    path.push_back(cell);
+    while (cell != m_source) {
+        int x = cell % m_width;
+        int y = cell / m_width;
+        int distance = m_distances[cell] - 1;
+        if (y > 0 && m_distances[cell - m_width] == distance) cell -= m_width;
+        else if (y < m_height - 1 && m_distances[cell + m_width] == distance) cell += m_width;
+        else if (x > 0 && m_distances[cell - 1] == distance) cell -= 1;
+        else cell += 1;
+        path.push_back(cell);
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+bool BitParallelBfs::isReachable(int sourceIndex, int targetIndex) {
+    if (!seed(sourceIndex) || isBlocked(targetIndex)) return false;
+    
+    size_t targetWord = wordIndex(targetIndex % m_width, targetIndex / m_width + 1);
+    std::uint64_t targetBit = std::uint64_t(1) << (targetIndex % m_width % 64);
+    if (m_reached[targetWord] & targetBit) return true;
+    while (advanceWave()) {
+        if (m_reached[targetWord] & targetBit) return true;
+    }
+    return false;
+}
+
+bool BitParallelBfs::seed(int sourceIndex) {
+    m_stats = BitBfsStats();
+    std::fill(m_reached.begin(), m_reached.end(), 0);
+    std::fill(m_frontier.begin(), m_frontier.end(), 0);
+    m_activeWords.clear();
+    if (isBlocked(sourceIndex)) return false;
+    
+    size_t word = wordIndex(sourceIndex % m_width, sourceIndex / m_width + 1);
+    std::uint64_t bit = std::uint64_t(1) << (sourceIndex % m_width % 64);
+    m_reached[word] = bit;
+    m_frontier[word] = bit;
+    m_activeWords.push_back(word);
+    m_firstRow = m_lastRow = sourceIndex / m_width + 1;
+    m_stats.reachedCells = 1;
+    return true;
+}
+
+bool BitParallelBfs::advanceWave() {
+    // Dense sweeps stream every word of the frontier's rows and vectorize;
+    // sparse visits chase individual words. Sweep while the rows are mostly
+    // frontier, which is how a wave starts and how corridors look.
+    size_t rangeWords = static_cast<size_t>(m_lastRow - m_firstRow + 3) * m_wordsPerRow;
+    m_nextWords.clear();
+    if (m_activeWords.size() * DENSE_SWEEP_RATIO >= rangeWords) {
+        sweepRows(std::max(1, m_firstRow - 1), std::min(m_height, m_lastRow + 1));
+    } else {
+        visitFrontierWords();
+    }
+    
+    // The old frontier is read above, so it is only replaced once every word is done
+    for (size_t word : m_activeWords) {
+        m_frontier[word] = 0;
+    }
+    m_firstRow = m_height + 1;
+    m_lastRow = 0;
+    for (size_t word : m_nextWords) {
+        m_frontier[word] = m_next[word];
+        m_reached[word] |= m_next[word];
+        m_stats.reachedCells += countBits(m_next[word]);
+        int row = static_cast<int>(word / m_stride);
+        m_firstRow = std::min(m_firstRow, row);
+        m_lastRow = std::max(m_lastRow, row);
+    }
+    m_activeWords.swap(m_nextWords);
+    if (m_activeWords.empty()) return false;
+    m_stats.waves++;
+    return true;
+}
+
+void BitParallelBfs::sweepRows(int firstRow, int lastRow) {
+    for (int row = firstRow; row <= lastRow; row++) {
+        size_t base = static_cast<size_t>(row) * m_stride;
+        for (int column = 1; column <= m_wordsPerRow; column++) {
+            size_t word = base + column;
+            if (spreadInto(word)) m_nextWords.push_back(word);
+        }
+    }
+    m_stats.wordOps += static_cast<long long>(lastRow - firstRow + 1) * m_wordsPerRow;
+}
+
+void BitParallelBfs::visitFrontierWords() {
+    if (++m_waveStamp == 0) {
+        std::fill(m_wordStamp.begin(), m_wordStamp.end(), 0);
+        m_waveStamp = 1;
+    }
+    
+    // A frontier word can only spread into itself and its four neighbor
+    // words; pad words are never open, so they drop out here
+    const std::ptrdiff_t offsets[5] = {0, -1, 1, -static_cast<std::ptrdiff_t>(m_stride), m_stride};
+    for (size_t word : m_activeWords) {
+        for (std::ptrdiff_t offset : offsets) {
+            size_t candidate = word + offset;
+            if (m_wordStamp[candidate] == m_waveStamp || !m_open[candidate]) continue;
+            m_wordStamp[candidate] = m_waveStamp;
+            m_stats.wordOps++;
+            if (spreadInto(candidate)) m_nextWords.push_back(candidate);
+        }
+    }
+}
+
+bool BitParallelBfs::spreadInto(size_t word) {
+    // Bits cross word edges through the neighbor words' top and bottom bits
+    const std::uint64_t* frontier = &m_frontier[word];
+    std::uint64_t around = frontier[0] | (frontier[0] << 1) | (frontier[-1] >> 63) |
+                           (frontier[0] >> 1) | (frontier[1] << 63) |
+                           frontier[-static_cast<std::ptrdiff_t>(m_stride)] | frontier[m_stride];
+    std::uint64_t next = around & m_open[word] & ~m_reached[word];
+    m_next[word] = next;
+    return next != 0;
+}
\ No newline at end of file
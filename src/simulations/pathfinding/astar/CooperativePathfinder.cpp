@@ -0,0 +1,231 @@
+#include "simulations/pathfinding/astar/CooperativePathfinder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+// Wait first, then the straight moves in the A* neighbor order
+static const int MOVE_DX[5] = {0, 0, 0, -1, 1};
+static const int MOVE_DY[5] = {0, -1, 1, 0, 0};
+
+// Replans of one window with the blocked agents promoted, before giving up
+static const int MAX_PRIORITY_RETRIES = 2;
+
+CooperativePathfinder::CooperativePathfinder()
+    : m_width(0)
+    , m_height(0)
+    , m_cellCount(0)
+    , m_window(0)
+    , m_side(0)
+    , m_plansReserved(false)
+    , m_searchGeneration(0)
+{
+}
+
+void CooperativePathfinder::initialize(int width, int height, int window) {
+    m_width = width;
+    m_height = height;
+    m_cellCount = width * height;
+    m_window = std::max(1, window);
+    m_side = 2 * m_window + 1;
+    m_blocked.assign(m_cellCount, 0);
+    m_reservations.assign(static_cast<size_t>(m_cellCount) * (m_window + 1), -1);
+    clearAgents();
+    
+    size_t stateCount = static_cast<size_t>(m_side) * m_side * (m_window + 1);
+    m_stateStamp.assign(stateCount, 0);
+    m_stateParent.assign(stateCount, -1);
+    m_searchGeneration = 0;
+    m_open.reset(static_cast<int>(stateCount));
+}
+
+void CooperativePathfinder::setBlocked(int cellIndex, bool blocked) {
+    m_blocked[cellIndex] = blocked ? 1 : 0;
+}
+
+int CooperativePathfinder::addAgent(int startIndex, int goalIndex) {
+    releasePlans();
+    m_positions.push_back(startIndex);
+    m_goals.push_back(goalIndex);
+    m_order.push_back(static_cast<std::int32_t>(m_order.size()));
+    m_plans.resize(m_plans.size() + m_window + 1, startIndex);
+    return static_cast<int>(m_positions.size()) - 1;
+}
+
+void CooperativePathfinder::clearAgents() {
+    releasePlans();
+    m_positions.clear();
+    m_goals.clear();
+    m_plans.clear();
+    m_order.clear();
+    m_stats = CooperativeStats();
+}
+
+void CooperativePathfinder::planWindow() {
+    auto begin = std::chrono::steady_clock::now();
+    m_stats = CooperativeStats();
+    int agentCount = getAgentCount();
+    std::vector<std::uint8_t> blocked(agentCount, 0);
+    for (int attempt = 0; ; attempt++) {
+        releasePlans();
+        m_stats.blockedAgents = 0;
+        
+        // Where everyone stands now is fixed, whatever their priority, and stays
+        // theirs for one more step: nobody walks into an agent that has not yet
+        // planned, so every agent can at least wait out its first step
+        for (int agent = 0; agent < agentCount; agent++) {
+            reserve(m_positions[agent], 0, agent);
+            reserve(m_positions[agent], 1, agent);
+        }
+        for (int agent : m_order) {
+            blocked[agent] = planAgent(agent) ? 0 : 1;
+        }
+        m_plansReserved = true;
+        if (m_stats.blockedAgents == 0 || attempt == MAX_PRIORITY_RETRIES) break;
+        
+        // Whoever was boxed in goes first, so the agents that ran it over plan around it
+        std::stable_partition(m_order.begin(), m_order.end(), [&](std::int32_t agent) { return blocked[agent] != 0; });
+    }
+    
+    // Half a turn, so the agents that yielded most plan first next time
+    std::rotate(m_order.begin(), m_order.begin() + agentCount / 2, m_order.end());
+    
+    auto end = std::chrono::steady_clock::now();
+    m_stats.agentsPlanned = agentCount;
+    m_stats.wallMs = std::chrono::duration<double, std::milli>(end - begin).count();
+    m_stats.agentsPerSecond = m_stats.wallMs > 0.0 ? agentCount / (m_stats.wallMs / 1000.0) : 0.0;
+}
+
+void CooperativePathfinder::advance(int steps) {
+    // The rest of the old plan no longer matches anyone's position
+    releasePlans();
+    steps = std::max(0, std::min(steps, m_window));
+    for (int agent = 0; agent < getAgentCount(); agent++) {
+        m_positions[agent] = getPlannedCell(agent, steps);
+    }
+    for (int agent = 0; agent < getAgentCount(); agent++) {
+        std::fill_n(m_plans.begin() + static_cast<size_t>(agent) * (m_window + 1), m_window + 1, m_positions[agent]);
+    }
+}
+
+int CooperativePathfinder::getArrivedCount() const {
+    int arrived = 0;
+    for (int agent = 0; agent < getAgentCount(); agent++) {
+        if (m_positions[agent] == m_goals[agent]) arrived++;
+    }
+    return arrived;
+}
+
+bool CooperativePathfinder::planAgent(int agent) {
+    if (++m_searchGeneration == 0) {
+        std::fill(m_stateStamp.begin(), m_stateStamp.end(), 0);
+        m_searchGeneration = 1;
+    }
+    m_open.reset(static_cast<int>(m_stateStamp.size()));
+    
+    int startIndex = m_positions[agent];
+    int goalIndex = m_goals[agent];
+    int startX = startIndex % m_width;
+    int startY = startIndex / m_width;
+    int goalX = goalIndex % m_width;
+    int goalY = goalIndex / m_width;
+    int sliceSize = m_side * m_side;
+    auto stateOf = [&](int x, int y, int step) {
+        return (step * m_side + (y - startY + m_window)) * m_side + (x - startX + m_window);
+    };
+    
+    int startState = stateOf(startX, startY, 0);
+    int startH = std::abs(startX - goalX) + std::abs(startY - goalY);
+    m_stateStamp[startState] = m_searchGeneration;
+    m_stateParent[startState] = -1;
+    m_open.push(startState, {startH, startH});
+    
+    int finalState = -1;
+    int deepestState = startState;   // Fallback when the window cannot be filled
+    while (!m_open.empty()) {
+        int state = m_open.pop();
+        int step = state / sliceSize;
+        int x = state % m_side + startX - m_window;
+        int y = (state / m_side) % m_side + startY - m_window;
+        int cellIndex = y * m_width + x;
+        
+        // Done once the window is used up, or parked on a goal nobody crosses later
+        if (step == m_window) {
+            finalState = state;
+            break;
+        }
+        if (cellIndex == goalIndex) {
+            bool goalHeld = true;
+            for (int later = step + 1; later <= m_window && goalHeld; later++) {
+                goalHeld = isFree(goalIndex, later, agent);
+            }
+            if (goalHeld) {
+                finalState = state;
+                break;
+            }
+        }
+        m_stats.expansions++;
+        if (step > deepestState / sliceSize) deepestState = state;
+        
+        for (int move = 0; move < 5; move++) {
+            int nx = x + MOVE_DX[move];
+            int ny = y + MOVE_DY[move];
+            if (nx < 0 || nx >= m_width || ny < 0 || ny >= m_height) continue;
+            int next = ny * m_width + nx;
+            if (isBlocked(next) || !isFree(next, step + 1, agent)) continue;
+            
+            // Two agents may not trade places across one edge
+            std::int32_t owner = m_reservations[reservationIndex(next, step)];
+            if (move != 0 && owner >= 0 && owner != agent &&
+                m_reservations[reservationIndex(cellIndex, step + 1)] == owner) {
+                continue;
+            }
+            
+            // Every move costs one step, so a state's g is its step and is
+            // never improved; the first visit is final
+            int nextState = stateOf(nx, ny, step + 1);
+            if (m_stateStamp[nextState] == m_searchGeneration) continue;
+            m_stateStamp[nextState] = m_searchGeneration;
+            m_stateParent[nextState] = state;
+            int h = std::abs(nx - goalX) + std::abs(ny - goalY);
+            m_open.push(nextState, {step + 1 + h, h});
+        }
+    }
+    
+    // Unwind the parents, then hold the last cell for the rest of the window.
+    // An agent boxed in before the window ends gets as far as it can and then
+    // waits, even where a later step is taken; the next replan resolves it.
+    bool planned = finalState >= 0;
+    if (!planned) {
+        m_stats.blockedAgents++;
+        finalState = deepestState;
+    }
+    std::int32_t* plan = &m_plans[static_cast<size_t>(agent) * (m_window + 1)];
+    int lastStep = finalState / sliceSize;
+    for (int state = finalState; state >= 0; state = m_stateParent[state]) {
+        int x = state % m_side + startX - m_window;
+        int y = (state / m_side) % m_side + startY - m_window;
+        plan[state / sliceSize] = y * m_width + x;
+    }
+    for (int step = lastStep + 1; step <= m_window; step++) {
+        plan[step] = plan[lastStep];
+    }
+    if (plan[1] != startIndex) {
+        reserve(startIndex, 1, -1);   // Held for this agent only in case it had to wait
+    }
+    for (int step = 1; step <= m_window; step++) {
+        if (isFree(plan[step], step, agent)) reserve(plan[step], step, agent);
+    }
+    return planned;
+}
+
+void CooperativePathfinder::releasePlans() {
+    // Only the cells the plans hold, not the whole table
+    if (!m_plansReserved) return;
+    for (int agent = 0; agent < getAgentCount(); agent++) {
+        for (int step = 0; step <= m_window; step++) {
+            std::int32_t& owner = m_reservations[reservationIndex(getPlannedCell(agent, step), step)];
+            if (owner == agent) owner = -1;
+        }
+    }
+    m_plansReserved = false;
+}
\ No newline at end of file
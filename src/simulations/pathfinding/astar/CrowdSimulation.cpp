@@ -0,0 +1,83 @@
+#include "simulations/pathfinding/astar/CrowdSimulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static const float MIN_AGENT_SPEED = 2.0f;   // Cells per second
+static const float MAX_AGENT_SPEED = 4.0f;
+
+CrowdSimulation::CrowdSimulation()
+    : m_rng(1)
+    , m_totalArrivals(0)
+{
+}
+
+void CrowdSimulation::spawn(const FlowField& field, int agentCount, unsigned seed) {
+    m_rng.seed(seed);
+    m_x.assign(agentCount, 0.0f);
+    m_y.assign(agentCount, 0.0f);
+    m_speed.resize(agentCount);
+    std::uniform_real_distribution<float> speed(MIN_AGENT_SPEED, MAX_AGENT_SPEED);
+    for (int i = 0; i < agentCount; i++) {
+        m_speed[i] = speed(m_rng);
+        respawn(field, i);
+    }
+    m_totalArrivals = 0;
+    m_lastTick = CrowdTickStats();
+}
+
+void CrowdSimulation::clear() {
+    m_x.clear();
+    m_y.clear();
+    m_speed.clear();
+    m_totalArrivals = 0;
+    m_lastTick = CrowdTickStats();
+}
+
+void CrowdSimulation::update(const FlowField& field, float deltaTime) {
+    auto begin = std::chrono::steady_clock::now();
+    m_lastTick = CrowdTickStats();
+    const std::uint8_t* directions = field.getDirections().data();
+    int width = field.getWidth();
+    int height = field.getHeight();
+    
+    size_t agentCount = m_x.size();
+    for (size_t i = 0; i < agentCount; i++) {
+        int cellX = std::min(std::max(static_cast<int>(m_x[i]), 0), width - 1);
+        int cellY = std::min(std::max(static_cast<int>(m_y[i]), 0), height - 1);
+        std::uint8_t direction = directions[cellY * width + cellX];
+        if (direction == FLOW_GOAL) {
+            m_lastTick.arrivals++;
+            respawn(field, i);
+            continue;
+        }
+        if (direction == FLOW_NONE) {
+            // A wall was painted under the agent or its region was sealed off
+            m_lastTick.stalled++;
+            continue;
+        }
+        
+        float dx = cellX + FLOW_DX[direction] + 0.5f - m_x[i];
+        float dy = cellY + FLOW_DY[direction] + 0.5f - m_y[i];
+        float distance = std::sqrt(dx * dx + dy * dy);
+        float travel = std::min(m_speed[i] * deltaTime, distance);
+        if (distance > 0.0f) {
+            m_x[i] += dx * (travel / distance);
+            m_y[i] += dy * (travel / distance);
+        }
+    }
+    
+    m_totalArrivals += m_lastTick.arrivals;
+    auto end = std::chrono::steady_clock::now();
+    m_lastTick.tickMs = std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+void CrowdSimulation::respawn(const FlowField& field, size_t agent) {
+    // Element 0 is the goal itself; with nothing else reachable the agent stays put
+    const std::vector<std::int32_t>& cells = field.getReachableCells();
+    if (cells.size() < 2) return;
+    int cellIndex = cells[1 + m_rng() % (cells.size() - 1)];
+    std::uniform_real_distribution<float> offset(0.1f, 0.9f);
+    m_x[agent] = cellIndex % field.getWidth() + offset(m_rng);
+    m_y[agent] = cellIndex / field.getWidth() + offset(m_rng);
+}
\ No newline at end of file
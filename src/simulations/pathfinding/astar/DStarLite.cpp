@@ -0,0 +1,252 @@
+#include "simulations/pathfinding/astar/DStarLite.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+// Edge costs in fixed point; DIAGONAL_COST is round(sqrt(2) * 2^20)
+static const DStarCost STRAIGHT_COST = DStarCost(1) << 20;
+static const DStarCost DIAGONAL_COST = 1482910;
+// Unreachable; far enough below the int64 limit that adding a heuristic and km cannot overflow
+static const DStarCost INF_COST = std::numeric_limits<DStarCost>::max() / 4;
+
+DStarLite::DStarLite()
+    : m_width(0)
+    , m_height(0)
+    , m_diagonal(false)
+    , m_start(0)
+    , m_goal(0)
+    , m_lastStart(0)
+    , m_km(0)
+{
+}
+
+void DStarLite::initialize(int width, int height, int startIndex, int goalIndex, bool diagonal) {
+    m_width = width;
+    m_height = height;
+    m_diagonal = diagonal;
+    m_start = startIndex;
+    m_lastStart = startIndex;
+    
+    size_t cellCount = static_cast<size_t>(width) * height;
+    m_blocked.assign(cellCount, 0);
+    m_weights.assign(cellCount, 1);
+    m_counters = DStarLiteCounters();
+    setGoal(goalIndex);
+}
+
+void DStarLite::setBlocked(int cellIndex, bool blocked) {
+    if (isBlocked(cellIndex) == blocked) return;
+    m_blocked[cellIndex] = blocked ? 1 : 0;
+    
+    // Every edge into the cell changed cost, so each endpoint's rhs may have
+    // too; with diagonals that includes corner cuts between two neighbors
+    int adjacent[8];
+    int count = getAdjacent(cellIndex, adjacent);
+    updateVertex(cellIndex);
+    for (int i = 0; i < count; i++) {
+        updateVertex(adjacent[i]);
+    }
+}
+
+void DStarLite::setWeight(int cellIndex, int weight) {
+    if (m_weights[cellIndex] == weight) return;
+    m_weights[cellIndex] = static_cast<std::uint8_t>(weight);
+    
+    // Only edges into the cell changed; their sources are its neighbors
+    int adjacent[8];
+    int count = getAdjacent(cellIndex, adjacent);
+    for (int i = 0; i < count; i++) {
+        updateVertex(adjacent[i]);
+    }
+}
+
+void DStarLite::setStart(int cellIndex) {
+    // Keys already queued were computed against the old start; km lower-bounds
+    // the drift so they stay valid without re-keying the whole queue
+    m_km += heuristic(m_lastStart, cellIndex);
+    m_lastStart = cellIndex;
+    m_start = cellIndex;
+}
+
+void DStarLite::setGoal(int cellIndex) {
+    // Every g value is a distance to the goal, so none of them survive
+    m_goal = cellIndex;
+    m_lastStart = m_start;
+    m_km = 0;
+    
+    size_t cellCount = m_blocked.size();
+    m_g.assign(cellCount, INF_COST);
+    m_rhs.assign(cellCount, INF_COST);
+    m_queue.reset(static_cast<int>(cellCount));
+    
+    m_rhs[m_goal] = 0;
+    m_queue.push(m_goal, calculateKey(m_goal));
+}
+
+void DStarLite::computeShortestPath() {
+    m_counters.lastExpansions = 0;
+    m_counters.lastVertexUpdates = 0;
+    
+    int adjacent[8];
+    while (!m_queue.empty() &&
+           (m_queue.topPriority() < calculateKey(m_start) || m_rhs[m_start] != m_g[m_start])) {
+        int cell = m_queue.top();
+        DStarKey oldKey = m_queue.topPriority();
+        DStarKey newKey = calculateKey(cell);
+        
+        if (oldKey < newKey) {
+            // Queued before the start moved; re-key and look again
+            m_queue.update(cell, newKey);
+            continue;
+        }
+        
+        m_counters.lastExpansions++;
+        int count = getAdjacent(cell, adjacent);
+        if (m_g[cell] > m_rhs[cell]) {
+            // Overconsistent: the cell got closer to the goal
+            m_g[cell] = m_rhs[cell];
+            m_queue.remove(cell);
+        } else {
+            // Underconsistent: invalidate and let the lookahead rebuild it
+            m_g[cell] = INF_COST;
+            updateVertex(cell);
+        }
+        for (int i = 0; i < count; i++) {
+            updateVertex(adjacent[i]);
+        }
+    }
+    
+    m_counters.totalExpansions += m_counters.lastExpansions;
+    m_counters.totalVertexUpdates += m_counters.lastVertexUpdates;
+}
+
+void DStarLite::extractPath(std::vector<int>& path) const {
+    path.clear();
+    if (!hasPath()) return;
+    
+    // Follow the cheapest neighbor; the cells on a shortest path are consistent
+    // after computeShortestPath(), so g strictly decreases towards the goal
+    int neighbors[8];
+    DStarCost costs[8];
+    int cell = m_start;
+    path.push_back(cell);
+    while (cell != m_goal) {
+        int best = -1;
+        DStarCost bestCost = INF_COST;
+        int count = getNeighbors(cell, neighbors, costs);
+        for (int i = 0; i < count; i++) {
+            int next = neighbors[i];
+            if (m_g[next] == INF_COST) continue;
+            DStarCost cost = costs[i] + m_g[next];
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = next;
+            }
+        }
+        if (best < 0 || path.size() > m_blocked.size()) {
+            path.clear();
+            return;
+        }
+        cell = best;
+        path.push_back(cell);
+    }
+}
+
+bool DStarLite::hasPath() const {
+    return !m_g.empty() && m_g[m_start] != INF_COST;
+}
+
+float DStarLite::getPathCost() const {
+    if (!hasPath()) return std::numeric_limits<float>::infinity();
+    return static_cast<float>(static_cast<double>(m_g[m_start]) / STRAIGHT_COST);
+}
+
+DStarCost DStarLite::heuristic(int fromIndex, int toIndex) const {
+    // Manhattan on 4-connected grids, octile with diagonals; both consistent
+    // since no weight is below 1, and exact because they are sums of the same
+    // fixed-point edge costs
+    DStarCost dx = std::abs(fromIndex % m_width - toIndex % m_width);
+    DStarCost dy = std::abs(fromIndex / m_width - toIndex / m_width);
+    if (m_diagonal) {
+        return STRAIGHT_COST * (std::max(dx, dy) - std::min(dx, dy)) + DIAGONAL_COST * std::min(dx, dy);
+    }
+    return STRAIGHT_COST * (dx + dy);
+}
+
+DStarKey DStarLite::calculateKey(int cellIndex) const {
+    DStarCost best = std::min(m_g[cellIndex], m_rhs[cellIndex]);
+    return {best + heuristic(m_start, cellIndex) + m_km, best};
+}
+
+void DStarLite::updateVertex(int cellIndex) {
+    m_counters.lastVertexUpdates++;
+    
+    if (cellIndex != m_goal) {
+        DStarCost best = INF_COST;
+        int neighbors[8];
+        DStarCost costs[8];
+        int count = getNeighbors(cellIndex, neighbors, costs);
+        for (int i = 0; i < count; i++) {
+            if (m_g[neighbors[i]] != INF_COST) best = std::min(best, costs[i] + m_g[neighbors[i]]);
+        }
+        m_rhs[cellIndex] = best;
+    }
+    
+    bool queued = m_queue.contains(cellIndex);
+    if (m_g[cellIndex] != m_rhs[cellIndex]) {
+        if (queued) {
+            m_queue.update(cellIndex, calculateKey(cellIndex));
+        } else {
+            m_queue.push(cellIndex, calculateKey(cellIndex));
+        }
+    } else if (queued) {
+        m_queue.remove(cellIndex);
+    }
+}
+
+int DStarLite::getNeighbors(int cellIndex, int neighbors[8], DStarCost costs[8]) const {
+    if (isBlocked(cellIndex)) return 0;
+    
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    bool up = y > 0 && !isBlocked(cellIndex - m_width);
+    bool down = y < m_height - 1 && !isBlocked(cellIndex + m_width);
+    bool left = x > 0 && !isBlocked(cellIndex - 1);
+    bool right = x < m_width - 1 && !isBlocked(cellIndex + 1);
+    
+    int count = 0;
+    auto add = [&](int neighbor, DStarCost cost) {
+        neighbors[count] = neighbor;
+        costs[count] = cost * m_weights[neighbor];
+        count++;
+    };
+    if (up) add(cellIndex - m_width, STRAIGHT_COST);
+    if (down) add(cellIndex + m_width, STRAIGHT_COST);
+    if (left) add(cellIndex - 1, STRAIGHT_COST);
+    if (right) add(cellIndex + 1, STRAIGHT_COST);
+    if (m_diagonal) {
+        // Both orthogonal cells must be open, so paths never squeeze past a corner
+        if (up && left && !isBlocked(cellIndex - m_width - 1)) add(cellIndex - m_width - 1, DIAGONAL_COST);
+        if (up && right && !isBlocked(cellIndex - m_width + 1)) add(cellIndex - m_width + 1, DIAGONAL_COST);
+        if (down && left && !isBlocked(cellIndex + m_width - 1)) add(cellIndex + m_width - 1, DIAGONAL_COST);
+        if (down && right && !isBlocked(cellIndex + m_width + 1)) add(cellIndex + m_width + 1, DIAGONAL_COST);
+    }
+    return count;
+}
+
+int DStarLite::getAdjacent(int cellIndex, int adjacent[8]) const {
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    int count = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if ((dx == 0 && dy == 0) || (!m_diagonal && dx != 0 && dy != 0)) continue;
+            int nx = x + dx;
+            int ny = y + dy;
+            if (nx >= 0 && nx < m_width && ny >= 0 && ny < m_height) {
+                adjacent[count++] = ny * m_width + nx;
+            }
+        }
+    }
+    return count;
+}
\ No newline at end of file
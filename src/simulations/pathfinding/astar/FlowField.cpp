@@ -0,0 +1,96 @@
+#include "simulations/pathfinding/astar/FlowField.h"
+#include <algorithm>
+#include <chrono>
+
+// Every pending cell costs between the current bucket and current + the
+// largest edge, so this many buckets never wrap onto one another
+static const int BUCKET_COUNT = FlowField::DIAGONAL_COST + 1;
+
+// Direction code of the move that undoes each move
+static const std::uint8_t OPPOSITE[8] = {1, 0, 3, 2, 7, 6, 5, 4};
+
+FlowField::FlowField()
+    : m_width(0)
+    , m_height(0)
+    , m_diagonal(false)
+    , m_goal(-1)
+{
+}
+
+void FlowField::initialize(int width, int height, bool diagonal) {
+    m_width = width;
+    m_height = height;
+    m_diagonal = diagonal;
+    m_goal = -1;
+    
+    size_t cellCount = static_cast<size_t>(width) * height;
+    m_blocked.assign(cellCount, 0);
+    m_costs.assign(cellCount, -1);
+    m_directions.assign(cellCount, FLOW_NONE);
+    m_reachable.clear();
+    m_buckets.assign(BUCKET_COUNT, std::vector<std::int32_t>());
+    m_stats = FlowFieldStats();
+}
+
+void FlowField::setBlocked(int cellIndex, bool blocked) {
+    m_blocked[cellIndex] = blocked ? 1 : 0;
+}
+
+void FlowField::build(int goalIndex) {
+    auto begin = std::chrono::steady_clock::now();
+    m_goal = goalIndex;
+    m_stats = FlowFieldStats();
+    std::fill(m_costs.begin(), m_costs.end(), -1);
+    std::fill(m_directions.begin(), m_directions.end(), FLOW_NONE);
+    m_reachable.clear();
+    for (auto& bucket : m_buckets) {
+        bucket.clear();
+    }
+    
+    if (goalIndex >= 0 && !isBlocked(goalIndex)) {
+        // The search runs outward from the goal, so a settled cell's direction
+        // reverses the move that reached it
+        m_costs[goalIndex] = 0;
+        m_directions[goalIndex] = FLOW_GOAL;
+        m_buckets[0].push_back(goalIndex);
+        size_t pending = 1;
+        int directionCount = m_diagonal ? 8 : 4;
+        
+        for (int cost = 0; pending > 0; cost++) {
+            std::vector<std::int32_t>& bucket = m_buckets[cost % BUCKET_COUNT];
+            // Appends only land in later buckets, so the index loop is safe
+            for (size_t i = 0; i < bucket.size(); i++) {
+                int cellIndex = bucket[i];
+                m_stats.bucketPops++;
+                if (m_costs[cellIndex] != cost) continue;   // Improved after it was queued
+                m_reachable.push_back(cellIndex);
+                
+                int x = cellIndex % m_width;
+                int y = cellIndex / m_width;
+                for (int direction = 0; direction < directionCount; direction++) {
+                    int nx = x + FLOW_DX[direction];
+                    int ny = y + FLOW_DY[direction];
+                    if (nx < 0 || nx >= m_width || ny < 0 || ny >= m_height) continue;
+                    int next = ny * m_width + nx;
+                    if (isBlocked(next)) continue;
+                    if (direction >= 4 && (isBlocked(y * m_width + nx) || isBlocked(ny * m_width + x))) {
+                        continue;  // Would cut a wall corner
+                    }
+                    
+                    int nextCost = cost + (direction >= 4 ? DIAGONAL_COST : STRAIGHT_COST);
+                    if (m_costs[next] >= 0 && m_costs[next] <= nextCost) continue;
+                    m_costs[next] = nextCost;
+                    m_directions[next] = OPPOSITE[direction];
+                    m_buckets[nextCost % BUCKET_COUNT].push_back(next);
+                    pending++;
+                }
+            }
+            pending -= bucket.size();
+            bucket.clear();
+        }
+    }
+    
+    m_stats.reachedCells = static_cast<int>(m_reachable.size());
+    auto end = std::chrono::steady_clock::now();
+    m_stats.buildMs = std::chrono::duration<double, std::milli>(end - begin).count();
+}
\ No newline at end of file
@@ -0,0 +1,498 @@
+#include "simulations/pathfinding/astar/HierarchicalPathfinder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+static const float INF_COST = std::numeric_limits<float>::infinity();
+
+// Border runs shorter than this get one entrance in the middle; longer runs
+// get one at each end, so wide openings do not force a detour to their center
+static const int ENTRANCE_SPLIT_LENGTH = 6;
+
+HierarchicalPathfinder::HierarchicalPathfinder()
+    : m_width(0)
+    , m_height(0)
+    , m_sectorSize(32)
+    , m_sectorsX(0)
+    , m_sectorsY(0)
+    , m_loadedSector(-1)
+    , m_localPitch(0)
+    , m_localX0(0)
+    , m_localY0(0)
+    , m_localGeneration(0)
+    , m_queryGeneration(0)
+{
+}
+
+void HierarchicalPathfinder::initialize(int width, int height, int sectorSize) {
+    m_width = width;
+    m_height = height;
+    m_sectorSize = std::max(2, std::min(64, sectorSize));
+    m_sectorsX = (width + m_sectorSize - 1) / m_sectorSize;
+    m_sectorsY = (height + m_sectorSize - 1) / m_sectorSize;
+    
+    m_blocked.assign(static_cast<size_t>(width) * height, 0);
+    
+    // Everything starts dirty; the first query builds the whole graph
+    int sectorCount = m_sectorsX * m_sectorsY;
+    m_sectors.assign(sectorCount, Sector());
+    m_dirtySectors.resize(sectorCount);
+    for (int i = 0; i < sectorCount; i++) {
+        m_dirtySectors[i] = i;
+    }
+    m_nodeOffsets.assign(sectorCount + 1, 0);
+    m_nodeCell.clear();
+    m_nodeSector.clear();
+    m_nodeStamp.clear();
+    m_queryGeneration = 0;
+    
+    m_loadedSector = -1;
+    m_localPitch = m_sectorSize + 2;
+    size_t localCount = static_cast<size_t>(m_localPitch) * m_localPitch;
+    m_localOpen.assign(localCount, 0);
+    m_rowOpen.assign(m_sectorSize + 2, 0);
+    m_rowReached.assign(m_sectorSize + 2, 0);
+    m_rowFrontier.assign(m_sectorSize + 2, 0);
+    m_rowNext.assign(m_sectorSize + 2, 0);
+    m_localParent.assign(localCount, -1);
+    m_localStamp.assign(localCount, 0);
+    m_localGeneration = 0;
+    m_stats = HierarchicalStats();
+}
+
+void HierarchicalPathfinder::setBlocked(int cellIndex, bool blocked) {
+    if (isBlocked(cellIndex) == blocked) return;
+    m_blocked[cellIndex] = blocked ? 1 : 0;
+    
+    auto markDirty = [this](int sectorIndex) {
+        Sector& sector = m_sectors[sectorIndex];
+        if (!sector.dirty) {
+            sector.dirty = true;
+            m_dirtySectors.push_back(sectorIndex);
+        }
+    };
+    
+    // A border cell also decides the entrances of the sector across it
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    markDirty(sectorOf(x, y));
+    if (x % m_sectorSize == 0 && x > 0) markDirty(sectorOf(x - 1, y));
+    if (x % m_sectorSize == m_sectorSize - 1 && x + 1 < m_width) markDirty(sectorOf(x + 1, y));
+    if (y % m_sectorSize == 0 && y > 0) markDirty(sectorOf(x, y - 1));
+    if (y % m_sectorSize == m_sectorSize - 1 && y + 1 < m_height) markDirty(sectorOf(x, y + 1));
+}
+
+void HierarchicalPathfinder::rebuildDirtySectors() {
+    m_stats.sectorsRebuilt = static_cast<int>(m_dirtySectors.size());
+    m_stats.rebuildMs = 0.0;
+    if (m_dirtySectors.empty()) return;
+    
+    auto begin = std::chrono::high_resolution_clock::now();
+    m_loadedSector = -1;
+    for (int sectorIndex : m_dirtySectors) {
+        buildSector(sectorIndex);
+        m_sectors[sectorIndex].dirty = false;
+    }
+    m_dirtySectors.clear();
+    
+    // Node counts may have changed, so renumber; this is linear in the node
+    // count and far cheaper than the breadth-first searches above
+    int sectorCount = static_cast<int>(m_sectors.size());
+    for (int i = 0; i < sectorCount; i++) {
+        m_nodeOffsets[i + 1] = m_nodeOffsets[i] + static_cast<int>(m_sectors[i].nodeCells.size());
+    }
+    int nodeCount = m_nodeOffsets[sectorCount];
+    m_nodeCell.resize(nodeCount);
+    m_nodeSector.resize(nodeCount);
+    for (int i = 0; i < sectorCount; i++) {
+        const std::vector<int>& cells = m_sectors[i].nodeCells;
+        std::copy(cells.begin(), cells.end(), m_nodeCell.begin() + m_nodeOffsets[i]);
+        std::fill(m_nodeSector.begin() + m_nodeOffsets[i], m_nodeSector.begin() + m_nodeOffsets[i + 1], i);
+    }
+    m_stats.abstractNodes = nodeCount;
+    
+    // Stamps index the old numbering, so start every slot over
+    m_g.resize(nodeCount + 2);
+    m_parent.resize(nodeCount + 2);
+    m_closed.resize(nodeCount + 2);
+    m_nodeStamp.assign(nodeCount + 2, 0);
+    m_queryGeneration = 0;
+    m_open.reset(nodeCount + 2);
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.rebuildMs = std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+bool HierarchicalPathfinder::findPath(int startIndex, int goalIndex, std::vector<int>& path) {
+    path.clear();
+    rebuildDirtySectors();
+    m_stats.abstractExpansions = 0;
+    m_stats.refineExpansions = 0;
+    m_stats.queryMs = 0.0;
+    
+    if (isBlocked(startIndex) || isBlocked(goalIndex)) return false;
+    if (startIndex == goalIndex) {
+        path.push_back(startIndex);
+        return true;
+    }
+    
+    auto begin = std::chrono::high_resolution_clock::now();
+    int nodeCount = m_nodeOffsets.back();
+    int startNode = nodeCount;
+    int goalNode = nodeCount + 1;
+    int startSector = sectorOf(startIndex % m_width, startIndex / m_width);
+    int goalSector = sectorOf(goalIndex % m_width, goalIndex / m_width);
+    
+    // Temporary edges from the start and to the goal inside their own sectors
+    int directDistance = -1;
+    if (startSector == goalSector) {
+        loadSector(startSector);
+        measureDistances(startIndex, &goalIndex, 1, m_measured);
+        directDistance = m_measured[0];
+    }
+    auto measureFrom = [this](int sectorIndex, int cellIndex, std::vector<float>& out) {
+        const std::vector<int>& cells = m_sectors[sectorIndex].nodeCells;
+        loadSector(sectorIndex);
+        measureDistances(cellIndex, cells.data(), static_cast<int>(cells.size()), m_measured);
+        out.resize(cells.size());
+        for (size_t i = 0; i < cells.size(); i++) {
+            out[i] = m_measured[i] < 0 ? INF_COST : static_cast<float>(m_measured[i]);
+        }
+    };
+    measureFrom(startSector, startIndex, m_startDistances);
+    measureFrom(goalSector, goalIndex, m_goalDistances);
+    
+    // A* over the entrance graph
+    if (++m_queryGeneration == 0) {
+        std::fill(m_nodeStamp.begin(), m_nodeStamp.end(), 0);
+        m_queryGeneration = 1;
+    }
+    auto touch = [this](int node) {
+        if (m_nodeStamp[node] != m_queryGeneration) {
+            m_nodeStamp[node] = m_queryGeneration;
+            m_g[node] = INF_COST;
+            m_parent[node] = -1;
+            m_closed[node] = 0;
+        }
+    };
+    m_open.reset(nodeCount + 2);
+    touch(startNode);
+    touch(goalNode);
+    m_g[startNode] = 0.0f;
+    float startH = heuristic(startIndex, goalIndex);
+    m_open.push(startNode, {startH, startH});
+    
+    int current = -1;
+    auto relax = [&](int next, float cost) {
+        touch(next);
+        if (m_closed[next]) return;
+        float tentative = m_g[current] + cost;
+        if (tentative >= m_g[next]) return;
+        m_g[next] = tentative;
+        m_parent[next] = current;
+        float h = next == goalNode ? 0.0f : heuristic(m_nodeCell[next], goalIndex);
+        if (m_open.contains(next)) {
+            m_open.decreaseKey(next, {tentative + h, h});
+        } else {
+            m_open.push(next, {tentative + h, h});
+        }
+    };
+    
+    while (!m_open.empty()) {
+        current = m_open.pop();
+        if (current == goalNode) break;
+        m_closed[current] = 1;
+        m_stats.abstractExpansions++;
+        
+        if (current == startNode) {
+            int offset = m_nodeOffsets[startSector];
+            for (size_t i = 0; i < m_startDistances.size(); i++) {
+                if (m_startDistances[i] != INF_COST) relax(offset + static_cast<int>(i), m_startDistances[i]);
+            }
+            if (directDistance >= 0) relax(goalNode, static_cast<float>(directDistance));
+            continue;
+        }
+        
+        int sectorIndex = m_nodeSector[current];
+        const Sector& sector = m_sectors[sectorIndex];
+        int offset = m_nodeOffsets[sectorIndex];
+        int local = current - offset;
+        int count = static_cast<int>(sector.nodeCells.size());
+        const float* row = sector.distances.data() + static_cast<size_t>(local) * count;
+        for (int i = 0; i < count; i++) {
+            if (i != local && row[i] != INF_COST) relax(offset + i, row[i]);
+        }
+        if (sectorIndex == goalSector && m_goalDistances[local] != INF_COST) {
+            relax(goalNode, m_goalDistances[local]);
+        }
+        
+        // Crossings into neighboring sectors
+        int cell = m_nodeCell[current];
+        int x = cell % m_width;
+        int y = cell / m_width;
+        const int crossings[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+        for (const auto& step : crossings) {
+            int nx = x + step[0];
+            int ny = y + step[1];
+            if (nx < 0 || nx >= m_width || ny < 0 || ny >= m_height) continue;
+            int neighborSector = sectorOf(nx, ny);
+            if (neighborSector == sectorIndex) continue;
+            int neighborNode = findNode(neighborSector, ny * m_width + nx);
+            if (neighborNode >= 0) relax(neighborNode, 1.0f);
+        }
+    }
+    
+    if (m_g[goalNode] != INF_COST) {
+        // Abstract route, goal first
+        std::vector<int> waypoints;
+        for (int node = goalNode; node != -1; node = m_parent[node]) {
+            if (node == goalNode) {
+                waypoints.push_back(goalIndex);
+            } else if (node == startNode) {
+                waypoints.push_back(startIndex);
+            } else {
+                waypoints.push_back(m_nodeCell[node]);
+            }
+        }
+        std::reverse(waypoints.begin(), waypoints.end());
+        
+        // Refine each hop: crossings are single steps, everything else stays
+        // inside one sector
+        path.push_back(startIndex);
+        for (size_t i = 1; i < waypoints.size(); i++) {
+            int from = waypoints[i - 1];
+            int to = waypoints[i];
+            if (from == to) continue;
+            int fromSectorIndex = sectorOf(from % m_width, from / m_width);
+            if (fromSectorIndex != sectorOf(to % m_width, to / m_width)) {
+                path.push_back(to);
+            } else {
+                loadSector(fromSectorIndex);
+                m_stats.refineExpansions += searchSector(from, to, path);
+            }
+        }
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.queryMs = std::chrono::duration<double, std::milli>(end - begin).count();
+    return !path.empty();
+}
+
+void HierarchicalPathfinder::buildSector(int sectorIndex) {
+    Sector& sector = m_sectors[sectorIndex];
+    int x0 = (sectorIndex % m_sectorsX) * m_sectorSize;
+    int y0 = (sectorIndex / m_sectorsX) * m_sectorSize;
+    int x1 = std::min(x0 + m_sectorSize, m_width);
+    int y1 = std::min(y0 + m_sectorSize, m_height);
+    
+    std::vector<int>& cells = sector.nodeCells;
+    cells.clear();
+    if (x0 > 0) addBorderEntrances(true, x0, y0, y1, -1, cells);
+    if (x1 < m_width) addBorderEntrances(true, x1 - 1, y0, y1, 1, cells);
+    if (y0 > 0) addBorderEntrances(false, y0, x0, x1, -m_width, cells);
+    if (y1 < m_height) addBorderEntrances(false, y1 - 1, x0, x1, m_width, cells);
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    
+    // Path lengths between every pair of entrances; symmetric, so each
+    // search fills a row and a column
+    int count = static_cast<int>(cells.size());
+    sector.distances.assign(static_cast<size_t>(count) * count, INF_COST);
+    loadSector(sectorIndex);
+    for (int i = 0; i < count; i++) {
+        sector.distances[static_cast<size_t>(i) * count + i] = 0.0f;
+        if (i == count - 1) break;
+        measureDistances(cells[i], cells.data() + i + 1, count - i - 1, m_measured);
+        for (int j = i + 1; j < count; j++) {
+            int distance = m_measured[j - i - 1];
+            if (distance < 0) continue;
+            sector.distances[static_cast<size_t>(i) * count + j] = static_cast<float>(distance);
+            sector.distances[static_cast<size_t>(j) * count + i] = static_cast<float>(distance);
+        }
+    }
+}
+
+void HierarchicalPathfinder::addBorderEntrances(bool vertical, int line, int from, int to, int outward,
+                                                std::vector<int>& cells) const {
+    // Both sectors scan the same border with the same rule, so the entrance
+    // cells on either side always pair up
+    int runStart = -1;
+    for (int t = from; t <= to; t++) {
+        bool open = false;
+        if (t < to) {
+            int inside = vertical ? t * m_width + line : line * m_width + t;
+            open = !isBlocked(inside) && !isBlocked(inside + outward);
+        }
+        if (open && runStart < 0) {
+            runStart = t;
+        } else if (!open && runStart >= 0) {
+            int length = t - runStart;
+            auto add = [&](int position) {
+                cells.push_back(vertical ? position * m_width + line : line * m_width + position);
+            };
+            if (length < ENTRANCE_SPLIT_LENGTH) {
+                add(runStart + length / 2);
+            } else {
+                add(runStart);
+                add(t - 1);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+int HierarchicalPathfinder::findNode(int sectorIndex, int cellIndex) const {
+    const std::vector<int>& cells = m_sectors[sectorIndex].nodeCells;
+    auto it = std::lower_bound(cells.begin(), cells.end(), cellIndex);
+    if (it == cells.end() || *it != cellIndex) return -1;
+    return m_nodeOffsets[sectorIndex] + static_cast<int>(it - cells.begin());
+}
+
+void HierarchicalPathfinder::loadSector(int sectorIndex) {
+    if (sectorIndex == m_loadedSector) return;
+    m_loadedSector = sectorIndex;
+    m_localX0 = (sectorIndex % m_sectorsX) * m_sectorSize;
+    m_localY0 = (sectorIndex / m_sectorsX) * m_sectorSize;
+    int width = std::min(m_sectorSize, m_width - m_localX0);
+    int height = std::min(m_sectorSize, m_height - m_localY0);
+    
+    // Cells outside a clipped edge sector stay closed along with the rim
+    std::fill(m_localOpen.begin(), m_localOpen.end(), 0);
+    std::fill(m_rowOpen.begin(), m_rowOpen.end(), 0);
+    for (int y = 0; y < height; y++) {
+        const std::uint8_t* blocked = &m_blocked[static_cast<size_t>(m_localY0 + y) * m_width + m_localX0];
+        std::uint8_t* open = &m_localOpen[static_cast<size_t>(y + 1) * m_localPitch + 1];
+        std::uint64_t bits = 0;
+        for (int x = 0; x < width; x++) {
+            open[x] = blocked[x] ? 0 : 1;
+            bits |= static_cast<std::uint64_t>(open[x]) << x;
+        }
+        m_rowOpen[y + 1] = bits;
+    }
+}
+
+int HierarchicalPathfinder::toLocal(int cellIndex) const {
+    return (cellIndex / m_width - m_localY0 + 1) * m_localPitch + (cellIndex % m_width - m_localX0 + 1);
+}
+
+int HierarchicalPathfinder::toGlobal(int localIndex) const {
+    return (localIndex / m_localPitch - 1 + m_localY0) * m_width + (localIndex % m_localPitch - 1 + m_localX0);
+}
+
+int HierarchicalPathfinder::measureDistances(int source, const int* targets, int targetCount,
+                                             std::vector<int>& distances) {
+    distances.assign(targetCount, -1);
+    std::fill(m_rowReached.begin(), m_rowReached.end(), 0);
+    std::fill(m_rowFrontier.begin(), m_rowFrontier.end(), 0);
+    std::fill(m_rowNext.begin(), m_rowNext.end(), 0);
+    
+    // Rows carry the one-row rim of the local grid, so y - 1 and y + 1 are
+    // always valid; bit x is column x with no rim
+    auto rowOf = [this](int cell) { return cell / m_width - m_localY0 + 1; };
+    auto bitOf = [this](int cell) { return std::uint64_t(1) << (cell % m_width - m_localX0); };
+    
+    int sourceRow = rowOf(source);
+    if (!(m_rowOpen[sourceRow] & bitOf(source))) return 0;
+    m_rowReached[sourceRow] = m_rowFrontier[sourceRow] = bitOf(source);
+    
+    // Unresolved targets, compacted as they are found
+    m_pendingTargets.clear();
+    for (int i = 0; i < targetCount; i++) {
+        if (targets[i] == source) {
+            distances[i] = 0;
+        } else {
+            m_pendingTargets.push_back({rowOf(targets[i]), bitOf(targets[i]), i});
+        }
+    }
+    
+    int lowRow = sourceRow;
+    int highRow = sourceRow;
+    int lastRow = static_cast<int>(m_rowOpen.size()) - 2;
+    int wave = 0;
+    while (!m_pendingTargets.empty()) {
+        // Every open, unreached cell next to the frontier joins the next wave
+        int nextLow = lastRow + 1;
+        int nextHigh = 0;
+        int from = std::max(1, lowRow - 1);
+        int to = std::min(lastRow, highRow + 1);
+        for (int y = from; y <= to; y++) {
+            std::uint64_t around = m_rowFrontier[y] | (m_rowFrontier[y] << 1) | (m_rowFrontier[y] >> 1) |
+                                   m_rowFrontier[y - 1] | m_rowFrontier[y + 1];
+            std::uint64_t next = around & m_rowOpen[y] & ~m_rowReached[y];
+            m_rowNext[y] = next;
+            if (next) {
+                nextLow = std::min(nextLow, y);
+                nextHigh = y;
+            }
+        }
+        if (nextLow > nextHigh) break;
+        wave++;
+        
+        for (int y = from; y <= to; y++) {
+            m_rowFrontier[y] = m_rowNext[y];
+            m_rowReached[y] |= m_rowNext[y];
+        }
+        for (size_t i = 0; i < m_pendingTargets.size();) {
+            const PendingTarget& pending = m_pendingTargets[i];
+            if (m_rowFrontier[pending.row] & pending.bit) {
+                distances[pending.index] = wave;
+                m_pendingTargets[i] = m_pendingTargets.back();
+                m_pendingTargets.pop_back();
+            } else {
+                i++;
+            }
+        }
+        lowRow = nextLow;
+        highRow = nextHigh;
+    }
+    return wave;
+}
+
+int HierarchicalPathfinder::searchSector(int source, int target, std::vector<int>& path) {
+    if (++m_localGeneration == 0) {
+        std::fill(m_localStamp.begin(), m_localStamp.end(), 0);
+        m_localGeneration = 1;
+    }
+    
+    int sourceLocal = toLocal(source);
+    int targetLocal = toLocal(target);
+    m_localQueue.clear();
+    m_localStamp[sourceLocal] = m_localGeneration;
+    m_localParent[sourceLocal] = -1;
+    m_localQueue.push_back(sourceLocal);
+    
+    // Unit costs, so the first time the target is dequeued is the shortest route
+    const int steps[4] = {-m_localPitch, m_localPitch, -1, 1};
+    size_t head = 0;
+    bool found = false;
+    while (head < m_localQueue.size()) {
+        int cell = m_localQueue[head++];
+        if (cell == targetLocal) {
+            found = true;
+            break;
+        }
+        for (int step : steps) {
+            int next = cell + step;
+            if (!m_localOpen[next] || m_localStamp[next] == m_localGeneration) continue;
+            m_localStamp[next] = m_localGeneration;
+            m_localParent[next] = cell;
+            m_localQueue.push_back(next);
+        }
+    }
+    
+    if (found) {
+        m_localRoute.clear();
+        for (int cell = targetLocal; cell != sourceLocal; cell = m_localParent[cell]) {
+            m_localRoute.push_back(toGlobal(cell));
+        }
+        path.insert(path.end(), m_localRoute.rbegin(), m_localRoute.rend());
+    }
+    return static_cast<int>(head);
+}
+
+float HierarchicalPathfinder::heuristic(int fromIndex, int toIndex) const {
+    int dx = std::abs(fromIndex % m_width - toIndex % m_width);
+    int dy = std::abs(fromIndex / m_width - toIndex / m_width);
+    return static_cast<float>(dx + dy);
+}
\ No newline at end of file
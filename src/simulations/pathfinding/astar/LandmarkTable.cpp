@@ -0,0 +1,295 @@
+#include "simulations/pathfinding/astar/LandmarkTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+// Straight moves first, then diagonals, as in the A* neighborhoods
+static const int MOVE_DX[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+static const int MOVE_DY[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+
+// Pending costs span at most one diagonal, so the circular queue never wraps onto itself
+static const int BUCKET_COUNT = LandmarkTable::DIAGONAL_COST + 1;
+
+LandmarkTable::LandmarkTable()
+    : m_width(0)
+    , m_height(0)
+    , m_diagonal(false)
+    , m_targetIndex(-1)
+{
+    std::fill(m_target, m_target + LANDMARK_COUNT, -1);
+}
+
+void LandmarkTable::initialize(int width, int height, bool diagonal) {
+    m_width = width;
+    m_height = height;
+    m_diagonal = diagonal;
+    size_t cellCount = static_cast<size_t>(width) * height;
+    m_blocked.assign(cellCount, 0);
+    m_landmarks.assign(LANDMARK_COUNT, -1);
+    m_stale.assign(LANDMARK_COUNT, 1);
+    m_columns.assign(LANDMARK_COUNT, std::vector<std::int32_t>(cellCount, -1));
+    m_table.assign(cellCount * LANDMARK_COUNT, -1);
+    m_targetIndex = -1;
+    std::fill(m_target, m_target + LANDMARK_COUNT, -1);
+    m_stats = LandmarkStats();
+}
+
+void LandmarkTable::setBlocked(int cellIndex, bool blocked) {
+    if (isBlocked(cellIndex) == blocked) return;
+    
+    // A new wall is judged by the edges it removes, so before it goes in; an
+    // opened cell by the edges it adds, so after
+    if (!blocked) m_blocked[cellIndex] = 0;
+    bool absorbed = true;
+    for (int landmark = 0; landmark < LANDMARK_COUNT; landmark++) {
+        if (m_stale[landmark]) {
+            absorbed = false;
+        } else if (!absorbEdit(landmark, cellIndex, blocked)) {
+            m_stale[landmark] = 1;
+            absorbed = false;
+        }
+    }
+    if (blocked) m_blocked[cellIndex] = 1;
+    if (absorbed) m_stats.editsAbsorbed++;
+}
+
+bool LandmarkTable::isStale() const {
+    return std::find(m_stale.begin(), m_stale.end(), 1) != m_stale.end();
+}
+
+void LandmarkTable::update() {
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<int> staleLandmarks;
+    for (int landmark = 0; landmark < LANDMARK_COUNT; landmark++) {
+        if (!m_stale[landmark]) continue;
+        if (m_landmarks[landmark] < 0 || isBlocked(m_landmarks[landmark])) {
+            selectLandmark(landmark);
+        }
+        staleLandmarks.push_back(landmark);
+    }
+    if (staleLandmarks.empty()) return;
+    m_stats.tablesRebuilt = static_cast<int>(staleLandmarks.size());
+    
+    // One Dial search per table; the walls are only read, each table has its own column
+    int workerCount = static_cast<int>(std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), staleLandmarks.size()));
+    std::atomic<size_t> nextLandmark(0);
+    auto workerLoop = [&]() {
+        std::vector<std::vector<std::int32_t>> buckets(BUCKET_COUNT);
+        while (true) {
+            size_t i = nextLandmark.fetch_add(1, std::memory_order_relaxed);
+            if (i >= staleLandmarks.size()) break;
+            buildTable(staleLandmarks[i], buckets);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workerCount; i++) {
+        threads.emplace_back(workerLoop);
+    }
+    workerLoop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // Interleave in one pass, cell-major, after the threads so no cache line is shared while writing
+    size_t cellCount = m_blocked.size();
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        std::int32_t* row = &m_table[cell * LANDMARK_COUNT];
+        for (int landmark : staleLandmarks) {
+            row[landmark] = m_columns[landmark][cell];
+        }
+    }
+    for (int landmark : staleLandmarks) {
+        m_stale[landmark] = 0;
+    }
+    if (m_targetIndex >= 0) setTarget(m_targetIndex);
+    
+    auto end = std::chrono::steady_clock::now();
+    m_stats.threadCount = workerCount;
+    m_stats.buildMs = std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+void LandmarkTable::setTarget(int targetIndex) {
+    m_targetIndex = targetIndex;
+    std::copy_n(&m_table[static_cast<size_t>(targetIndex) * LANDMARK_COUNT], LANDMARK_COUNT, m_target);
+}
+
+float LandmarkTable::estimate(int cellIndex) const {
+    // Cells on either side of a component boundary both read -1 from a
+    // landmark that cannot reach them; a mixed pair means no path, where any
+    // estimate is harmless, so the lanes need no reachability test
+    const std::int32_t* row = &m_table[static_cast<size_t>(cellIndex) * LANDMARK_COUNT];
+    std::int32_t best = 0;
+    for (int landmark = 0; landmark < LANDMARK_COUNT; landmark++) {
+        std::int32_t difference = row[landmark] - m_target[landmark];
+        best = std::max(best, difference < 0 ? -difference : difference);
+    }
+    return std::max(best / static_cast<float>(STRAIGHT_COST), geometricEstimate(cellIndex, m_targetIndex));
+}
+
+float LandmarkTable::estimate(int fromIndex, int toIndex) const {
+    const std::int32_t* from = &m_table[static_cast<size_t>(fromIndex) * LANDMARK_COUNT];
+    const std::int32_t* to = &m_table[static_cast<size_t>(toIndex) * LANDMARK_COUNT];
+    std::int32_t best = 0;
+    for (int landmark = 0; landmark < LANDMARK_COUNT; landmark++) {
+        best = std::max(best, std::abs(from[landmark] - to[landmark]));
+    }
+    return std::max(best / static_cast<float>(STRAIGHT_COST), geometricEstimate(fromIndex, toIndex));
+}
+
+void LandmarkTable::selectLandmark(int landmark) {
+    // Landmarks behind the goal as seen from the start bound best, so spread
+    // them around the border: each takes the open cell nearest its own point
+    // on the perimeter, at equal spacing
+    int perimeter = std::max(1, 2 * (m_width - 1) + 2 * (m_height - 1));
+    int along = static_cast<int>((landmark + 0.5) * perimeter / LANDMARK_COUNT);
+    int pointX, pointY;
+    if (along < m_width - 1) {
+        pointX = along;
+        pointY = 0;
+    } else if ((along -= m_width - 1) < m_height - 1) {
+        pointX = m_width - 1;
+        pointY = along;
+    } else if ((along -= m_height - 1) < m_width - 1) {
+        pointX = m_width - 1 - along;
+        pointY = m_height - 1;
+    } else {
+        along -= m_width - 1;
+        pointX = 0;
+        pointY = std::max(0, m_height - 1 - along);
+    }
+    
+    int bestCell = -1;
+    long long bestDistance = 0;
+    for (int cell = 0; cell < static_cast<int>(m_blocked.size()); cell++) {
+        if (isBlocked(cell) || std::find(m_landmarks.begin(), m_landmarks.end(), cell) != m_landmarks.end()) continue;
+        long long dx = cell % m_width - pointX;
+        long long dy = cell / m_width - pointY;
+        long long distance = dx * dx + dy * dy;
+        if (bestCell < 0 || distance < bestDistance) {
+            bestCell = cell;
+            bestDistance = distance;
+        }
+    }
+    m_landmarks[landmark] = bestCell;
+}
+
+void LandmarkTable::buildTable(int landmark, std::vector<std::vector<std::int32_t>>& buckets) {
+    std::vector<std::int32_t>& distances = m_columns[landmark];
+    std::fill(distances.begin(), distances.end(), -1);
+    int source = m_landmarks[landmark];
+    if (source < 0) return;
+    
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    distances[source] = 0;
+    buckets[0].push_back(source);
+    size_t pending = 1;
+    int directionCount = m_diagonal ? 8 : 4;
+    for (int cost = 0; pending > 0; cost++) {
+        std::vector<std::int32_t>& bucket = buckets[cost % BUCKET_COUNT];
+        for (size_t i = 0; i < bucket.size(); i++) {
+            int cellIndex = bucket[i];
+            if (distances[cellIndex] != cost) continue;   // Improved after it was queued
+            for (int direction = 0; direction < directionCount; direction++) {
+                if (!isEdgeOpen(cellIndex, direction)) continue;
+                int next = cellIndex + MOVE_DY[direction] * m_width + MOVE_DX[direction];
+                int nextCost = cost + (direction >= 4 ? DIAGONAL_COST : STRAIGHT_COST);
+                if (distances[next] >= 0 && distances[next] <= nextCost) continue;
+                distances[next] = nextCost;
+                buckets[nextCost % BUCKET_COUNT].push_back(next);
+                pending++;
+            }
+        }
+        pending -= bucket.size();
+        bucket.clear();
+    }
+}
+
+bool LandmarkTable::isEdgeOpen(int fromIndex, int direction) const {
+    int x = fromIndex % m_width;
+    int y = fromIndex / m_width;
+    int nx = x + MOVE_DX[direction];
+    int ny = y + MOVE_DY[direction];
+    if (nx < 0 || nx >= m_width || ny < 0 || ny >= m_height) return false;
+    if (isBlocked(ny * m_width + nx)) return false;
+    // Diagonals never cut a wall corner
+    return direction < 4 || (!isBlocked(y * m_width + nx) && !isBlocked(ny * m_width + x));
+}
+
+bool LandmarkTable::absorbEdit(int landmark, int cellIndex, bool blocked) {
+    if (cellIndex == m_landmarks[landmark]) return false;
+    std::vector<std::int32_t>& distances = m_columns[landmark];
+    int directionCount = m_diagonal ? 8 : 4;
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    
+    // The edit also opens or closes the diagonals that use the cell as a corner
+    auto cornerEdgeChanges = [&](auto&& changesDistances) {
+        if (!m_diagonal) return false;
+        for (int sx = -1; sx <= 1; sx += 2) {
+            for (int sy = -1; sy <= 1; sy += 2) {
+                int ax = x + sx, by = y + sy;
+                if (ax < 0 || ax >= m_width || by < 0 || by >= m_height) continue;
+                int a = y * m_width + ax;
+                int b = by * m_width + x;
+                if (isBlocked(a) || isBlocked(b) || isBlocked(by * m_width + ax)) continue;
+                if (changesDistances(distances[a], distances[b])) return true;
+            }
+        }
+        return false;
+    };
+    
+    std::int32_t patched = -1;
+    if (blocked) {
+        // Closing edges changes nothing unless one of them was on a shortest path
+        std::int32_t own = distances[cellIndex];
+        if (own < 0) return true;
+        for (int direction = 0; direction < directionCount; direction++) {
+            if (!isEdgeOpen(cellIndex, direction)) continue;
+            std::int32_t neighbor = distances[cellIndex + MOVE_DY[direction] * m_width + MOVE_DX[direction]];
+            if (neighbor == own + (direction >= 4 ? DIAGONAL_COST : STRAIGHT_COST)) return false;
+        }
+        if (cornerEdgeChanges([](std::int32_t a, std::int32_t b) {
+                return a >= 0 && b >= 0 && std::abs(a - b) == DIAGONAL_COST;
+            })) {
+            return false;
+        }
+    } else {
+        // Opening edges changes nothing unless one of them is a shortcut
+        for (int direction = 0; direction < directionCount; direction++) {
+            if (!isEdgeOpen(cellIndex, direction)) continue;
+            std::int32_t neighbor = distances[cellIndex + MOVE_DY[direction] * m_width + MOVE_DX[direction]];
+            if (neighbor >= 0) {
+                std::int32_t through = neighbor + (direction >= 4 ? DIAGONAL_COST : STRAIGHT_COST);
+                if (patched < 0 || through < patched) patched = through;
+            }
+        }
+        if (patched < 0) return true;   // Opens into a region the landmark cannot reach
+        for (int direction = 0; direction < directionCount; direction++) {
+            if (!isEdgeOpen(cellIndex, direction)) continue;
+            std::int32_t neighbor = distances[cellIndex + MOVE_DY[direction] * m_width + MOVE_DX[direction]];
+            if (neighbor < 0 || neighbor > patched + (direction >= 4 ? DIAGONAL_COST : STRAIGHT_COST)) return false;
+        }
+        if (cornerEdgeChanges([](std::int32_t a, std::int32_t b) {
+                return (a < 0) != (b < 0) || std::abs(a - b) > DIAGONAL_COST;
+            })) {
+            return false;
+        }
+    }
+    
+    distances[cellIndex] = patched;
+    m_table[static_cast<size_t>(cellIndex) * LANDMARK_COUNT + landmark] = patched;
+    return true;
+}
+
+float LandmarkTable::geometricEstimate(int fromIndex, int toIndex) const {
+    int dx = std::abs(fromIndex % m_width - toIndex % m_width);
+    int dy = std::abs(fromIndex / m_width - toIndex / m_width);
+    if (m_diagonal) {
+        return static_cast<float>(std::max(dx, dy)) + 0.41421356f * std::min(dx, dy);
+    }
+    return static_cast<float>(dx + dy);
+}
\ No newline at end of file
@@ -0,0 +1,366 @@
+#include "simulations/pathfinding/astar/MapGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Smoothing passes of the cave automaton
+static const int CAVE_STEPS = 4;
+
+// Coarsest noise lattice spacing in cells; each further octave halves it and its weight
+static const int NOISE_BASE_SPACING = 32;
+static const int NOISE_OCTAVES = 4;
+static const int NOISE_ROWS_PER_CLAIM = 16;
+
+// Terrain noise below this stays road (weight 1); weights climb to the maximum over the next TERRAIN_RAMP
+static const float TERRAIN_ROAD_LEVEL = 0.5f;
+static const float TERRAIN_RAMP = 0.25f;
+
+// Maze neighbor order: up, down, left, right
+static const int MAZE_DX[4] = {0, 0, -1, 1};
+static const int MAZE_DY[4] = {-1, 1, 0, 0};
+
+static std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Random value of one lattice point in [0, 1), a pure function of its coordinates
+static float latticeValue(std::uint64_t seed, int octave, int latticeX, int latticeY) {
+    std::uint64_t state = seed ^ (static_cast<std::uint64_t>(octave) << 58) ^
+                          (static_cast<std::uint64_t>(static_cast<std::uint32_t>(latticeX)) << 29) ^
+                          static_cast<std::uint32_t>(latticeY);
+    return (splitMix64(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+static float smoothStep(float t) {
+    return t * t * (3.0f - 2.0f * t);
+}
+
+void Xoshiro256::seedWith(std::uint64_t seed) {
+    for (auto& word : m_state) {
+        word = splitMix64(seed);
+    }
+}
+
+MapGenerator::MapGenerator()
+    : m_width(0)
+    , m_height(0)
+    , m_mazeWidth(0)
+    , m_mazeHeight(0)
+    , m_walls(nullptr)
+    , m_lastMs(0.0)
+{
+}
+
+void MapGenerator::generate(MapGeneratorKind kind, int width, int height, std::uint64_t seed, float wallDensity,
+                            const std::vector<int>& keepOpen, std::vector<std::uint8_t>& walls) {
+    auto begin = std::chrono::steady_clock::now();
+    m_width = width;
+    m_height = height;
+    m_mazeWidth = std::max(0, (width - 1) / 2);
+    m_mazeHeight = std::max(0, (height - 1) / 2);
+    walls.assign(static_cast<size_t>(width) * height, 0);
+    m_walls = walls.data();
+    m_rng.seedWith(seed);
+    
+    bool maze = kind == MapGeneratorKind::BACKTRACKER || kind == MapGeneratorKind::PRIM || kind == MapGeneratorKind::KRUSKAL;
+    if (maze && m_mazeWidth > 0 && m_mazeHeight > 0) {
+        std::fill(walls.begin(), walls.end(), 1);
+        switch (kind) {
+            case MapGeneratorKind::BACKTRACKER: carveBacktracker(); break;
+            case MapGeneratorKind::PRIM: carvePrim(); break;
+            default: carveKruskal(); break;
+        }
+        for (int cellIndex : keepOpen) {
+            joinToMaze(cellIndex);
+        }
+    } else {
+        switch (kind) {
+            case MapGeneratorKind::RANDOM_FILL: fillRandom(wallDensity); break;
+            case MapGeneratorKind::CAVES: growCaves(wallDensity); break;
+            case MapGeneratorKind::VALUE_NOISE: fillValueNoise(seed, wallDensity); break;
+            default: break;   // Too small for a maze: left open
+        }
+        for (int cellIndex : keepOpen) {
+            if (cellIndex >= 0 && cellIndex < width * height) m_walls[cellIndex] = 0;
+        }
+    }
+    
+    auto end = std::chrono::steady_clock::now();
+    m_lastMs = std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+void MapGenerator::generateTerrain(int width, int height, std::uint64_t seed, int maxWeight,
+                                   std::vector<std::uint8_t>& weights) {
+    auto begin = std::chrono::steady_clock::now();
+    m_width = width;
+    m_height = height;
+    weights.assign(static_cast<size_t>(width) * height, 1);
+    maxWeight = std::max(1, std::min(255, maxWeight));
+    std::uint8_t* out = weights.data();
+    sampleValueNoise(seed, [&](int y, const float* values) {
+        std::uint8_t* row = out + static_cast<size_t>(y) * m_width;
+        for (int x = 0; x < m_width; x++) {
+            float t = std::max(0.0f, std::min(1.0f, (values[x] - TERRAIN_ROAD_LEVEL) / TERRAIN_RAMP));
+            row[x] = static_cast<std::uint8_t>(1 + static_cast<int>(t * (maxWeight - 1) + 0.5f));
+        }
+    });
+    
+    auto end = std::chrono::steady_clock::now();
+    m_lastMs = std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+std::string MapGenerator::getKindName(MapGeneratorKind kind) {
+    switch (kind) {
+        case MapGeneratorKind::RANDOM_FILL: return "RANDOM";
+        case MapGeneratorKind::BACKTRACKER: return "BACKTRACKER";
+        case MapGeneratorKind::PRIM: return "PRIM";
+        case MapGeneratorKind::KRUSKAL: return "KRUSKAL";
+        case MapGeneratorKind::CAVES: return "CAVES";
+        case MapGeneratorKind::VALUE_NOISE: return "VALUE NOISE";
+    }
+    return "";
+}
+
+float MapGenerator::getDefaultDensity(MapGeneratorKind kind) {
+    switch (kind) {
+        case MapGeneratorKind::CAVES: return 0.45f;        // Below this the automaton erodes nearly every wall
+        case MapGeneratorKind::VALUE_NOISE: return 0.4f;   // Noise bunches around 0.5, so this walls about a fifth
+        default: return 0.3f;
+    }
+}
+
+void MapGenerator::fillRandom(float wallDensity) {
+    size_t cellCount = static_cast<size_t>(m_width) * m_height;
+    for (size_t i = 0; i < cellCount; i++) {
+        m_walls[i] = m_rng.nextFloat() < wallDensity ? 1 : 0;
+    }
+}
+
+void MapGenerator::carveBacktracker() {
+    m_visited.assign(static_cast<size_t>(m_mazeWidth) * m_mazeHeight, 0);
+    m_scratch.clear();
+    int first = static_cast<int>(m_rng.nextBelow(static_cast<std::uint32_t>(m_visited.size())));
+    m_visited[first] = 1;
+    openMazeCell(first % m_mazeWidth, first / m_mazeWidth);
+    m_scratch.push_back(first);
+    
+    // Explicit stack: the corridor of a large maze is far deeper than the call stack
+    while (!m_scratch.empty()) {
+        int cell = m_scratch.back();
+        int x = cell % m_mazeWidth;
+        int y = cell / m_mazeWidth;
+        int options[4];
+        int optionCount = 0;
+        for (int direction = 0; direction < 4; direction++) {
+            int nx = x + MAZE_DX[direction];
+            int ny = y + MAZE_DY[direction];
+            if (nx >= 0 && nx < m_mazeWidth && ny >= 0 && ny < m_mazeHeight && !m_visited[ny * m_mazeWidth + nx]) {
+                options[optionCount++] = direction;
+            }
+        }
+        if (optionCount == 0) {
+            m_scratch.pop_back();
+            continue;
+        }
+        int direction = options[m_rng.nextBelow(optionCount)];
+        int nx = x + MAZE_DX[direction];
+        int ny = y + MAZE_DY[direction];
+        m_visited[ny * m_mazeWidth + nx] = 1;
+        openMazePassage(x, y, nx, ny);
+        openMazeCell(nx, ny);
+        m_scratch.push_back(ny * m_mazeWidth + nx);
+    }
+}
+
+void MapGenerator::carvePrim() {
+    // The frontier holds passages out of the maze, as cell * 4 + direction
+    m_visited.assign(static_cast<size_t>(m_mazeWidth) * m_mazeHeight, 0);
+    m_scratch.clear();
+    auto addCell = [&](int cell) {
+        int x = cell % m_mazeWidth;
+        int y = cell / m_mazeWidth;
+        m_visited[cell] = 1;
+        openMazeCell(x, y);
+        for (int direction = 0; direction < 4; direction++) {
+            int nx = x + MAZE_DX[direction];
+            int ny = y + MAZE_DY[direction];
+            if (nx >= 0 && nx < m_mazeWidth && ny >= 0 && ny < m_mazeHeight && !m_visited[ny * m_mazeWidth + nx]) {
+                m_scratch.push_back(cell * 4 + direction);
+            }
+        }
+    };
+    addCell(static_cast<int>(m_rng.nextBelow(static_cast<std::uint32_t>(m_visited.size()))));
+    
+    while (!m_scratch.empty()) {
+        size_t pick = m_rng.nextBelow(static_cast<std::uint32_t>(m_scratch.size()));
+        int passage = m_scratch[pick];
+        m_scratch[pick] = m_scratch.back();
+        m_scratch.pop_back();
+        
+        int cell = passage / 4;
+        int x = cell % m_mazeWidth;
+        int y = cell / m_mazeWidth;
+        int nx = x + MAZE_DX[passage % 4];
+        int ny = y + MAZE_DY[passage % 4];
+        if (m_visited[ny * m_mazeWidth + nx]) continue;   // Reached another way since it was queued
+        openMazePassage(x, y, nx, ny);
+        addCell(ny * m_mazeWidth + nx);
+    }
+}
+
+void MapGenerator::carveKruskal() {
+    // Every edge to the right or below, as cell * 2 + (0 right, 1 down), in shuffled order
+    int cellCount = m_mazeWidth * m_mazeHeight;
+    m_scratch.clear();
+    for (int cell = 0; cell < cellCount; cell++) {
+        openMazeCell(cell % m_mazeWidth, cell / m_mazeWidth);
+        if (cell % m_mazeWidth + 1 < m_mazeWidth) m_scratch.push_back(cell * 2);
+        if (cell / m_mazeWidth + 1 < m_mazeHeight) m_scratch.push_back(cell * 2 + 1);
+    }
+    for (size_t i = m_scratch.size(); i > 1; i--) {
+        std::swap(m_scratch[i - 1], m_scratch[m_rng.nextBelow(static_cast<std::uint32_t>(i))]);
+    }
+    
+    m_sets.resize(cellCount);
+    for (int cell = 0; cell < cellCount; cell++) {
+        m_sets[cell] = cell;
+    }
+    auto findSet = [&](int cell) {
+        while (m_sets[cell] != cell) {
+            m_sets[cell] = m_sets[m_sets[cell]];   // Path halving
+            cell = m_sets[cell];
+        }
+        return cell;
+    };
+    int joins = 0;
+    for (int edge : m_scratch) {
+        int cell = edge / 2;
+        int next = cell + (edge % 2 == 0 ? 1 : m_mazeWidth);
+        int cellSet = findSet(cell);
+        int nextSet = findSet(next);
+        if (cellSet == nextSet) continue;
+        m_sets[cellSet] = nextSet;
+        openMazePassage(cell % m_mazeWidth, cell / m_mazeWidth, next % m_mazeWidth, next / m_mazeWidth);
+        if (++joins == cellCount - 1) break;   // Spanning tree complete
+    }
+}
+
+void MapGenerator::growCaves(float wallDensity) {
+    // Each step walls a cell with at least 5 walls among its 8 neighbors, or
+    // keeps a wall with 4; off the map counts as wall. The 3x3 sums reuse
+    // one column sum per cell, so a step reads each row three times.
+    fillRandom(wallDensity);
+    std::vector<std::uint8_t> next(static_cast<size_t>(m_width) * m_height);
+    std::vector<int> columnSums(m_width + 2);
+    for (int step = 0; step < CAVE_STEPS; step++) {
+        for (int y = 0; y < m_height; y++) {
+            const std::uint8_t* above = y > 0 ? m_walls + (y - 1) * m_width : nullptr;
+            const std::uint8_t* row = m_walls + y * m_width;
+            const std::uint8_t* below = y + 1 < m_height ? m_walls + (y + 1) * m_width : nullptr;
+            columnSums[0] = 3;
+            columnSums[m_width + 1] = 3;
+            for (int x = 0; x < m_width; x++) {
+                columnSums[x + 1] = (above ? above[x] : 1) + row[x] + (below ? below[x] : 1);
+            }
+            std::uint8_t* out = next.data() + y * m_width;
+            for (int x = 0; x < m_width; x++) {
+                int neighbors = columnSums[x] + columnSums[x + 1] + columnSums[x + 2] - row[x];
+                out[x] = (neighbors >= 5 || (neighbors == 4 && row[x])) ? 1 : 0;
+            }
+        }
+        std::copy(next.begin(), next.end(), m_walls);
+    }
+}
+
+void MapGenerator::fillValueNoise(std::uint64_t seed, float wallDensity) {
+    sampleValueNoise(seed, [&](int y, const float* values) {
+        std::uint8_t* out = m_walls + static_cast<size_t>(y) * m_width;
+        for (int x = 0; x < m_width; x++) {
+            out[x] = values[x] < wallDensity ? 1 : 0;
+        }
+    });
+}
+
+void MapGenerator::sampleValueNoise(std::uint64_t seed, const std::function<void(int, const float*)>& writeRow) {
+    // Every cell is a pure function of the seed and its coordinates, so rows
+    // can go to any thread in any order and the map stays the same
+    int rowClaims = (m_height + NOISE_ROWS_PER_CLAIM - 1) / NOISE_ROWS_PER_CLAIM;
+    int workerCount = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()), rowClaims));
+    float totalWeight = 0.0f;
+    std::vector<std::vector<float>> fades(NOISE_OCTAVES);   // Eased offset within a lattice span, per octave
+    for (int octave = 0; octave < NOISE_OCTAVES; octave++) {
+        totalWeight += 1.0f / (1 << octave);
+        int spacing = std::max(1, NOISE_BASE_SPACING >> octave);
+        for (int offset = 0; offset < spacing; offset++) {
+            fades[octave].push_back(smoothStep((offset + 0.5f) / spacing));
+        }
+    }
+    
+    std::atomic<int> nextRow(0);
+    auto workerLoop = [&]() {
+        std::vector<float> values(m_width);
+        while (true) {
+            int firstRow = nextRow.fetch_add(NOISE_ROWS_PER_CLAIM, std::memory_order_relaxed);
+            if (firstRow >= m_height) break;
+            int lastRow = std::min(firstRow + NOISE_ROWS_PER_CLAIM, m_height);
+            for (int y = firstRow; y < lastRow; y++) {
+                std::fill(values.begin(), values.end(), 0.0f);
+                for (int octave = 0; octave < NOISE_OCTAVES; octave++) {
+                    int spacing = std::max(1, NOISE_BASE_SPACING >> octave);
+                    float weight = 1.0f / (1 << octave) / totalWeight;
+                    int latticeY = y / spacing;
+                    float ty = fades[octave][y % spacing];
+                    const float* fade = fades[octave].data();
+                    
+                    // Corner values are hashed once per lattice span, not per cell
+                    for (int spanX = 0; spanX < m_width; spanX += spacing) {
+                        int latticeX = spanX / spacing;
+                        float top = latticeValue(seed, octave, latticeX, latticeY);
+                        float bottom = latticeValue(seed, octave, latticeX, latticeY + 1);
+                        float topSlope = latticeValue(seed, octave, latticeX + 1, latticeY) - top;
+                        float bottomSlope = latticeValue(seed, octave, latticeX + 1, latticeY + 1) - bottom;
+                        int spanEnd = std::min(spanX + spacing, m_width);
+                        for (int x = spanX; x < spanEnd; x++) {
+                            float tx = fade[x - spanX];
+                            float upper = top + topSlope * tx;
+                            float lower = bottom + bottomSlope * tx;
+                            values[x] += weight * (upper + (lower - upper) * ty);
+                        }
+                    }
+                }
+                writeRow(y, values.data());
+            }
+        }
+    };
+    
+    // The calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workerCount; i++) {
+        threads.emplace_back(workerLoop);
+    }
+    workerLoop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void MapGenerator::joinToMaze(int cellIndex) {
+    // Walk to the nearest corridor cell (odd x and y), along the row then the column
+    if (cellIndex < 0 || cellIndex >= m_width * m_height) return;
+    int x = cellIndex % m_width;
+    int y = cellIndex / m_width;
+    int corridorX = x % 2 == 1 && x < 2 * m_mazeWidth ? x : std::min(x + 1, 2 * m_mazeWidth - 1);
+    int corridorY = y % 2 == 1 && y < 2 * m_mazeHeight ? y : std::min(y + 1, 2 * m_mazeHeight - 1);
+    for (int stepX = x; ; stepX += stepX < corridorX ? 1 : -1) {
+        m_walls[y * m_width + stepX] = 0;
+        if (stepX == corridorX) break;
+    }
+    for (int stepY = y; ; stepY += stepY < corridorY ? 1 : -1) {
+        m_walls[stepY * m_width + corridorX] = 0;
+        if (stepY == corridorY) break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "simulations/pathfinding/astar/MovingAiLoader.h"
+#include <fstream>
+#include <sstream>
+
+static bool isPassableTerrain(char terrain) {
+    return terrain == '.' || terrain == 'G' || terrain == 'S';
+}
+
+bool MovingAiLoader::loadMap(std::istream& input, AStarGrid& grid) {
+    m_error.clear();
+    int width = -1;
+    int height = -1;
+    std::string field;
+    bool mapSection = false;
+    while (!mapSection && input >> field) {
+        if (field == "type") {
+            std::string type;
+            input >> type;   // Always octile in the published sets; the rows say the rest
+        } else if (field == "height") {
+            input >> height;
+        } else if (field == "width") {
+            input >> width;
+        } else if (field == "map") {
+            mapSection = true;
+        } else {
+            return fail("Unknown map header field '" + field + "'");
+        }
+        if (!input) return fail("Malformed map header near '" + field + "'");
+    }
+    if (!mapSection) return fail("Map has no 'map' section");
+    if (width <= 0 || height <= 0) return fail("Map header has no positive width and height");
+    
+    std::string row;
+    std::getline(input, row);   // Rest of the "map" line
+    grid.resize(width, height);
+    for (int y = 0; y < height; y++) {
+        if (!std::getline(input, row)) {
+            return fail("Map ends after " + std::to_string(y) + " of " + std::to_string(height) + " rows");
+        }
+        if (!row.empty() && row.back() == '\r') row.pop_back();
+        if (static_cast<int>(row.size()) < width) {
+            return fail("Map row " + std::to_string(y) + " has " + std::to_string(row.size()) + " cells, expected " +
+                        std::to_string(width));
+        }
+        CellType* types = &grid.types[grid.index(0, y)];
+        for (int x = 0; x < width; x++) {
+            types[x] = isPassableTerrain(row[x]) ? CellType::EMPTY : CellType::WALL;
+        }
+    }
+    return true;
+}
+
+bool MovingAiLoader::loadMap(const std::string& path, AStarGrid& grid) {
+    std::ifstream file(path);
+    if (!file.is_open()) return fail("Could not open map file " + path);
+    if (!loadMap(file, grid)) {
+        m_error = path + ": " + m_error;
+        return false;
+    }
+    return true;
+}
+
+bool MovingAiLoader::loadScenarios(std::istream& input, const AStarGrid& grid, std::vector<MovingAiScenario>& scenarios) {
+    m_error.clear();
+    scenarios.clear();
+    std::string line;
+    for (int lineNumber = 1; std::getline(input, line); lineNumber++) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line.compare(0, 7, "version") == 0) continue;
+        
+        // bucket, map name, map width and height, start x y, goal x y, optimal length
+        std::istringstream fields(line);
+        MovingAiScenario scenario;
+        std::string mapName;
+        int mapWidth, mapHeight, startX, startY, goalX, goalY;
+        if (!(fields >> scenario.bucket >> mapName >> mapWidth >> mapHeight >> startX >> startY >> goalX >> goalY >>
+              scenario.optimalLength)) {
+            return fail("Scenario line " + std::to_string(lineNumber) + " is malformed");
+        }
+        if (mapWidth != grid.width || mapHeight != grid.height) {
+            return fail("Scenario line " + std::to_string(lineNumber) + " is for a " + std::to_string(mapWidth) + "x" +
+                        std::to_string(mapHeight) + " map, not " + std::to_string(grid.width) + "x" +
+                        std::to_string(grid.height));
+        }
+        if (!grid.inBounds(startX, startY) || !grid.inBounds(goalX, goalY)) {
+            return fail("Scenario line " + std::to_string(lineNumber) + " leaves the map");
+        }
+        scenario.startIndex = grid.index(startX, startY);
+        scenario.goalIndex = grid.index(goalX, goalY);
+        if (grid.types[scenario.startIndex] == CellType::WALL || grid.types[scenario.goalIndex] == CellType::WALL) {
+            return fail("Scenario line " + std::to_string(lineNumber) + " starts or ends on a wall");
+        }
+        scenarios.push_back(scenario);
+    }
+    return true;
+}
+
+bool MovingAiLoader::loadScenarios(const std::string& path, const AStarGrid& grid, std::vector<MovingAiScenario>& scenarios) {
+    std::ifstream file(path);
+    if (!file.is_open()) return fail("Could not open scenario file " + path);
+    if (!loadScenarios(file, grid, scenarios)) {
+        m_error = path + ": " + m_error;
+        return false;
+    }
+    return true;
+}
+
+bool MovingAiLoader::fail(const std::string& message) {
+    m_error = message;
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "simulations/sorting/quicksort/ParallelQuicksort.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+static int medianOfThree(const std::vector<int>& arr, int a, int b, int c, int& comparisons) {
+    comparisons += 3;
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return arr[a] < arr[c] ? c : a;
+    }
+    if (arr[a] < arr[c]) return a;
+    return arr[b] < arr[c] ? c : b;
+}
+
+ParallelQuicksort::ParallelQuicksort(int workerCount, int forkCutoff)
+    : m_workerCount(std::max(1, workerCount))
+    , m_forkCutoff(std::max(1, forkCutoff))
+    , m_kernel(PartitionKernel::HOARE)
+    , m_data(nullptr)
+    , m_pendingTasks(0)
+    , m_sequence(0)
+{
+}
+
+void ParallelQuicksort::sort(std::vector<int>& data) {
+    run<false>(data);
+}
+
+void ParallelQuicksort::sortSerial(std::vector<int>& data) {
+    m_data = &data;
+    if (data.size() < 2) return;
+    
+    // processTask's loop with a local stack standing in for the deques
+    std::vector<Task> stack{{0, static_cast<int>(data.size()) - 1}};
+    while (!stack.empty()) {
+        int low = stack.back().low;
+        int high = stack.back().high;
+        stack.pop_back();
+        
+        while (high - low + 1 > m_forkCutoff) {
+            int pivot = partition<false>(low, high, 0);
+            int leftHigh = pivot - 1;
+            int rightLow = pivot + 1;
+            gatherPivotCopies(low, high, pivot, leftHigh, rightLow);
+            if (rightLow < high) {
+                stack.push_back({rightLow, high});
+            }
+            high = leftHigh;
+        }
+        sortSequential<false>(low, high, 0);
+    }
+}
+
+std::vector<ParallelTraceEvent> ParallelQuicksort::sortWithTrace(std::vector<int>& data) {
+    run<true>(data);
+    
+    // Merge the per-worker buffers into one global order
+    std::vector<ParallelTraceEvent> merged;
+    for (const auto& events : m_events) {
+        merged.insert(merged.end(), events.begin(), events.end());
+    }
+    std::sort(merged.begin(), merged.end(), [](const ParallelTraceEvent& a, const ParallelTraceEvent& b) {
+        return a.sequence < b.sequence;
+    });
+    m_events.clear();
+    return merged;
+}
+
+template <bool Trace>
+void ParallelQuicksort::run(std::vector<int>& data) {
+    m_data = &data;
+    m_queues.clear();
+    for (int i = 0; i < m_workerCount; i++) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    m_events.assign(Trace ? m_workerCount : 0, {});
+    m_sequence = 0;
+    
+    if (data.size() < 2) return;
+    
+    m_pendingTasks = 1;
+    m_queues[0]->tasks.push_back({0, static_cast<int>(data.size()) - 1});
+    
+    // The calling thread is worker 0
+    std::vector<std::thread> threads;
+    for (int i = 1; i < m_workerCount; i++) {
+        threads.emplace_back([this, i]() { workerLoop<Trace>(i); });
+    }
+    workerLoop<Trace>(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+template <bool Trace>
+void ParallelQuicksort::workerLoop(int workerId) {
+    unsigned int victimSeed = static_cast<unsigned int>(workerId) * 2654435761u + 1;
+    
+    while (m_pendingTasks.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (popTask(workerId, task) || stealTask(workerId, victimSeed, task)) {
+            processTask<Trace>(task, workerId);
+            m_pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <bool Trace>
+void ParallelQuicksort::processTask(Task task, int workerId) {
+    int low = task.low;
+    int high = task.high;
+    
+    // Fork the right side for thieves and keep going on the left
+    while (high - low + 1 > m_forkCutoff) {
+        int pivot = partition<Trace>(low, high, workerId);
+        int leftHigh = pivot - 1;
+        int rightLow = pivot + 1;
+        // Traced runs partition with Hoare, which splits duplicates evenly
+        if (!Trace) gatherPivotCopies(low, high, pivot, leftHigh, rightLow);
+        if (rightLow < high) {
+            pushTask(workerId, {rightLow, high});
+        }
+        high = leftHigh;
+    }
+    sortSequential<Trace>(low, high, workerId);
+}
+
+template <bool Trace>
+void ParallelQuicksort::sortSequential(int low, int high, int workerId) {
+    if (low >= high) return;
+    
+    if (!Trace) {
+        std::sort(m_data->begin() + low, m_data->begin() + high + 1);
+        return;
+    }
+    
+    // Traced runs keep partitioning so every swap shows up as a step
+    std::vector<Task> stack{{low, high}};
+    while (!stack.empty()) {
+        Task range = stack.back();
+        stack.pop_back();
+        if (range.low >= range.high) continue;
+        
+        int pivot = partition<Trace>(range.low, range.high, workerId);
+        stack.push_back({pivot + 1, range.high});
+        stack.push_back({range.low, pivot - 1});
+    }
+}
+
+template <bool Trace>
+int ParallelQuicksort::partition(int low, int high, int workerId) {
+    std::vector<int>& arr = *m_data;
+    int comparisons = 0;
+    
+    if (Trace) record(workerId, QuicksortStepKind::PROCESS_SUBARRAY, -1, low, high, -1, -1, comparisons);
+    
+    int chosen = medianOfThree(arr, low, low + (high - low) / 2, high, comparisons);
+    if (chosen != low) std::swap(arr[low], arr[chosen]);
+    if (Trace) {
+        record(workerId, QuicksortStepKind::PIVOT_MEDIAN_OF_THREE, low, low, chosen,
+               chosen != low ? low : -1, chosen != low ? chosen : -1, comparisons);
+    }
+    
+    if (!Trace) {
+        return partitionRange(m_kernel, arr.data(), low, high);
+    }
+    
+    // Same Hoare scheme as the serial engine, pivot at arr[low]
+    int pivot = arr[low];
+    int left = low + 1;
+    int right = high;
+    while (true) {
+        while (left <= right && arr[left] < pivot) {
+            left++;
+            comparisons++;
+        }
+        while (left <= right && arr[right] > pivot) {
+            right--;
+            comparisons++;
+        }
+        if (left > right) break;
+        
+        if (left != right) {
+            std::swap(arr[left], arr[right]);
+            if (Trace) record(workerId, QuicksortStepKind::SWAPPED, low, left, right, left, right, comparisons);
+        }
+        left++;
+        right--;
+    }
+    
+    if (right > low) {
+        std::swap(arr[low], arr[right]);
+        if (Trace) record(workerId, QuicksortStepKind::PIVOT_PLACED, right, low, high, low, right, comparisons);
+        return right;
+    }
+    if (Trace) record(workerId, QuicksortStepKind::PIVOT_IN_PLACE, low, low, high, -1, -1, comparisons);
+    return low;
+}
+
+void ParallelQuicksort::gatherPivotCopies(int low, int high, int pivot, int& leftHigh, int& rightLow) {
+    // A split at least 1:7 is left alone; random input rarely pays for the extra scan
+    int smaller = std::min(pivot - low, high - pivot);
+    if (smaller >= (high - low + 1) / 8) return;
+    
+    std::vector<int>& arr = *m_data;
+    const int value = arr[pivot];
+    if (high - pivot > pivot - low) {
+        // Right side holds only values >= pivot, so its copies can move to its front
+        int store = pivot + 1;
+        for (int i = pivot + 1; i <= high; i++) {
+            if (arr[i] == value) std::swap(arr[i], arr[store++]);
+        }
+        rightLow = store;
+    } else {
+        int store = pivot - 1;
+        for (int i = pivot - 1; i >= low; i--) {
+            if (arr[i] == value) std::swap(arr[i], arr[store--]);
+        }
+        leftHigh = store;
+    }
+}
+
+void ParallelQuicksort::pushTask(int workerId, Task task) {
+    // Count the task before it becomes visible so the pool can't drain early
+    m_pendingTasks.fetch_add(1, std::memory_order_acq_rel);
+    WorkerQueue& queue = *m_queues[workerId];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(task);
+}
+
+bool ParallelQuicksort::popTask(int workerId, Task& task) {
+    WorkerQueue& queue = *m_queues[workerId];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ParallelQuicksort::stealTask(int workerId, unsigned int& victimSeed, Task& task) {
+    if (m_workerCount < 2) return false;
+    
+    // Start at a pseudo-random victim and sweep the others once
+    victimSeed = victimSeed * 1103515245u + 12345u;
+    int start = static_cast<int>((victimSeed >> 16) % static_cast<unsigned int>(m_workerCount));
+    for (int i = 0; i < m_workerCount; i++) {
+        int victim = (start + i) % m_workerCount;
+        if (victim == workerId) continue;
+        
+        WorkerQueue& queue = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelQuicksort::record(int workerId, QuicksortStepKind kind, int pivot, int low, int high, int swapFirst, int swapSecond, int& comparisons) {
+    ParallelTraceEvent event;
+    event.sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+    event.kind = kind;
+    event.workerId = workerId;
+    event.pivotIndex = pivot;
+    event.lowIndex = low;
+    event.highIndex = high;
+    event.swapFirst = swapFirst;
+    event.swapSecond = swapSecond;
+    event.comparisons = comparisons;
+    m_events[workerId].push_back(event);
+    comparisons = 0;
+}
+
+std::vector<ParallelScalingResult> ParallelQuicksort::measureScaling(size_t elementCount, const std::vector<int>& threadCounts, unsigned int seed,
+                                                                     PartitionKernel kernel) {
+    std::vector<int> input(elementCount);
+    std::mt19937 rng(seed);
+    for (auto& value : input) {
+        value = static_cast<int>(rng());
+    }
+    
+    // Large leaves keep fork overhead negligible on big inputs
+    int cutoff = static_cast<int>(std::max<size_t>(4096, elementCount / 256));
+    
+    // Thread count 0 times the serial path; no pool, so no spawn or queue overhead in the baseline
+    std::vector<int> runs = {0};
+    runs.insert(runs.end(), threadCounts.begin(), threadCounts.end());
+    
+    std::vector<ParallelScalingResult> results;
+    double baseline = 0.0;
+    for (int threads : runs) {
+        std::vector<int> data = input;
+        ParallelQuicksort sorter(threads, cutoff);
+        sorter.setPartitionKernel(kernel);
+        
+        auto start = std::chrono::steady_clock::now();
+        if (threads == 0) {
+            sorter.sortSerial(data);
+        } else {
+            sorter.sort(data);
+        }
+        auto end = std::chrono::steady_clock::now();
+        
+        double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        if (results.empty()) baseline = milliseconds;
+        results.push_back({threads, milliseconds, milliseconds > 0.0 ? baseline / milliseconds : 0.0});
+    }
+    return results;
+}
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "simulations/sorting/quicksort/PartitionKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIM_PARTITION_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SIM_AVX2_TARGET
+#else
+#include <cpuid.h>
+#define SIM_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Misses are counted for this thread only, user space only. Opening the
+// counter fails in containers and VMs without PMU access; results are then -1.
+class BranchMissCounter {
+public:
+    BranchMissCounter() : m_fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    
+    ~BranchMissCounter() {
+#ifdef __linux__
+        if (m_fd >= 0) close(m_fd);
+#endif
+    }
+    
+    void start() {
+#ifdef __linux__
+        if (m_fd < 0) return;
+        ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    
+    long long stop() {
+#ifdef __linux__
+        if (m_fd < 0) return -1;
+        ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+    
+private:
+    int m_fd;
+};
+
+static int partitionHoare(int* data, int low, int high) {
+    const int pivot = data[low];
+    int left = low + 1;
+    int right = high;
+    while (true) {
+        while (left <= right && data[left] < pivot) left++;
+        while (left <= right && data[right] > pivot) right--;
+        if (left > right) break;
+        
+        std::swap(data[left], data[right]);
+        left++;
+        right--;
+    }
+    std::swap(data[low], data[right]);
+    return right;
+}
+
+static int partitionLomuto(int* data, int low, int high) {
+    const int pivot = data[low];
+    int boundary = low;
+    for (int i = low + 1; i <= high; i++) {
+        if (data[i] < pivot) {
+            std::swap(data[++boundary], data[i]);
+        }
+    }
+    std::swap(data[low], data[boundary]);
+    return boundary;
+}
+
+// Edelkamp & Weiss block partition, with pdqsort's classification and cleanup:
+// the left block flags elements >= pivot as misplaced and the right block
+// flags elements < pivot, so every copy of the pivot ends up on the right.
+static int partitionBranchlessBlock(int* data, int low, int high) {
+    constexpr int BLOCK = 64;
+    const int pivot = data[low];
+    int* first = data + low + 1;
+    int* last = data + high + 1;
+    
+    unsigned char offsetsLeft[BLOCK];
+    unsigned char offsetsRight[BLOCK];
+    int numLeft = 0, numRight = 0;
+    int startLeft = 0, startRight = 0;
+    
+    auto swapOffsets = [&]() {
+        int count = std::min(numLeft, numRight);
+        for (int i = 0; i < count; i++) {
+            std::swap(first[offsetsLeft[startLeft + i]], *(last - offsetsRight[startRight + i]));
+        }
+        numLeft -= count;
+        numRight -= count;
+        startLeft += count;
+        startRight += count;
+    };
+    
+    while (last - first > 2 * BLOCK) {
+        // Record offsets unconditionally and advance the count by the comparison result
+        if (numLeft == 0) {
+            startLeft = 0;
+            for (int i = 0; i < BLOCK; i++) {
+                offsetsLeft[numLeft] = static_cast<unsigned char>(i);
+                numLeft += first[i] >= pivot;
+            }
+        }
+        if (numRight == 0) {
+            startRight = 0;
+            for (int i = 0; i < BLOCK; i++) {
+                offsetsRight[numRight] = static_cast<unsigned char>(i + 1);
+                numRight += *(last - i - 1) < pivot;
+            }
+        }
+        
+        swapOffsets();
+        if (numLeft == 0) first += BLOCK;
+        if (numRight == 0) last -= BLOCK;
+    }
+    
+    // Fewer than two blocks left; size the final blocks to cover the rest exactly
+    int unknown = static_cast<int>(last - first) - ((numLeft || numRight) ? BLOCK : 0);
+    int sizeLeft, sizeRight;
+    if (numRight) {
+        sizeLeft = unknown;
+        sizeRight = BLOCK;
+    } else if (numLeft) {
+        sizeLeft = BLOCK;
+        sizeRight = unknown;
+    } else {
+        sizeLeft = unknown / 2;
+        sizeRight = unknown - sizeLeft;
+    }
+    
+    if (numLeft == 0) {
+        startLeft = 0;
+        for (int i = 0; i < sizeLeft; i++) {
+            offsetsLeft[numLeft] = static_cast<unsigned char>(i);
+            numLeft += first[i] >= pivot;
+        }
+    }
+    if (numRight == 0) {
+        startRight = 0;
+        for (int i = 0; i < sizeRight; i++) {
+            offsetsRight[numRight] = static_cast<unsigned char>(i + 1);
+            numRight += *(last - i - 1) < pivot;
+        }
+    }
+    
+    swapOffsets();
+    if (numLeft == 0) first += sizeLeft;
+    if (numRight == 0) last -= sizeRight;
+    
+    // At most one side still has misplaced elements; move them across the boundary
+    if (numLeft) {
+        while (numLeft--) {
+            std::swap(first[offsetsLeft[startLeft + numLeft]], *--last);
+        }
+        first = last;
+    }
+    if (numRight) {
+        while (numRight--) {
+            std::swap(*(last - offsetsRight[startRight + numRight]), *first);
+            ++first;
+        }
+    }
+    
+    int pivotIndex = static_cast<int>(first - data) - 1;
+    std::swap(data[low], data[pivotIndex]);
+    return pivotIndex;
+}
+
+#ifdef SIM_PARTITION_X86
+
+// For every 8-bit "greater than pivot" mask, a lane order that puts the
+// not-greater lanes first. Indexing with the inverted mask puts greater lanes first.
+struct CompressTable {
+    alignas(32) int lanes[256][8];
+    int greaterCount[256];
+    
+    CompressTable() {
+        for (int mask = 0; mask < 256; mask++) {
+            int slot = 0;
+            for (int lane = 0; lane < 8; lane++) {
+                if (!(mask & (1 << lane))) lanes[mask][slot++] = lane;
+            }
+            greaterCount[mask] = 8 - slot;
+            for (int lane = 0; lane < 8; lane++) {
+                if (mask & (1 << lane)) lanes[mask][slot++] = lane;
+            }
+        }
+    }
+};
+
+static const CompressTable& getCompressTable() {
+    static const CompressTable table;
+    return table;
+}
+
+// Smaller elements are compressed in place behind the read cursor (stores never
+// pass it); greater ones go to a scratch buffer and are copied back at the end.
+// Copies of the pivot stay left with the smaller elements.
+static SIM_AVX2_TARGET int partitionAvx2(int* data, int low, int high) {
+    const CompressTable& table = getCompressTable();
+    const int pivot = data[low];
+    const int count = high - low;
+    int* input = data + low + 1;
+    
+    thread_local std::vector<int> scratch;
+    scratch.resize(static_cast<size_t>(count) + 8);
+    
+    const __m256i pivotVector = _mm256_set1_epi32(pivot);
+    int lessCount = 0;
+    int greaterCount = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(values, pivotVector)));
+        
+        __m256i lessFirst = _mm256_permutevar8x32_epi32(values,
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(table.lanes[mask])));
+        __m256i greaterFirst = _mm256_permutevar8x32_epi32(values,
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(table.lanes[~mask & 0xFF])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(input + lessCount), lessFirst);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(scratch.data() + greaterCount), greaterFirst);
+        
+        greaterCount += table.greaterCount[mask];
+        lessCount += 8 - table.greaterCount[mask];
+    }
+    for (; i < count; i++) {
+        int value = input[i];
+        if (value > pivot) {
+            scratch[greaterCount++] = value;
+        } else {
+            input[lessCount++] = value;
+        }
+    }
+    std::copy(scratch.begin(), scratch.begin() + greaterCount, input + lessCount);
+    
+    int pivotIndex = low + lessCount;
+    std::swap(data[low], data[pivotIndex]);
+    return pivotIndex;
+}
+
+static bool detectAvx2() {
+    // CPUID.7.0:EBX bit 5 reports AVX2; the OS must also save YMM state (OSXSAVE + XCR0 bits 1-2)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    if (!osxsave || !avx2) return false;
+    return (_xgetbv(0) & 0x6) == 0x6;
+#else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    bool osxsave = (ecx & (1u << 27)) != 0;
+    __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+    bool avx2 = (ebx & (1u << 5)) != 0;
+    if (!osxsave || !avx2) return false;
+    unsigned int xcr0Low, xcr0High;
+    __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    return (xcr0Low & 0x6) == 0x6;
+#endif
+}
+
+#endif
+
+bool isPartitionKernelSupported(PartitionKernel kernel) {
+    if (kernel != PartitionKernel::AVX2) return true;
+#ifdef SIM_PARTITION_X86
+    static const bool supported = detectAvx2();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+int partitionRange(PartitionKernel kernel, int* data, int low, int high) {
+    if (low >= high) return low;
+    
+    switch (kernel) {
+        case PartitionKernel::HOARE:
+            return partitionHoare(data, low, high);
+        case PartitionKernel::LOMUTO:
+            return partitionLomuto(data, low, high);
+        case PartitionKernel::AVX2:
+#ifdef SIM_PARTITION_X86
+            if (isPartitionKernelSupported(PartitionKernel::AVX2)) {
+                return partitionAvx2(data, low, high);
+            }
+#endif
+            // Without AVX2 the block kernel is the fastest portable choice
+            return partitionBranchlessBlock(data, low, high);
+        case PartitionKernel::BRANCHLESS_BLOCK:
+        default:
+            return partitionBranchlessBlock(data, low, high);
+    }
+}
+
+std::string getPartitionKernelName(PartitionKernel kernel) {
+    switch (kernel) {
+        case PartitionKernel::HOARE: return "HOARE";
+        case PartitionKernel::LOMUTO: return "LOMUTO";
+        case PartitionKernel::BRANCHLESS_BLOCK: return "BLOCK";
+        case PartitionKernel::AVX2: return "AVX2";
+    }
+    return "";
+}
+
+std::vector<PartitionKernelResult> measurePartitionKernels(size_t elementCount, int repetitions, unsigned int seed) {
+    std::vector<int> input(std::max<size_t>(elementCount, 2));
+    std::mt19937 rng(seed);
+    for (auto& value : input) {
+        value = static_cast<int>(rng());
+    }
+    
+    // Median pivot: every comparison is a coin flip, the worst case for branch prediction
+    std::vector<int> ordered = input;
+    std::nth_element(ordered.begin(), ordered.begin() + ordered.size() / 2, ordered.end());
+    auto median = std::find(input.begin(), input.end(), ordered[ordered.size() / 2]);
+    std::iter_swap(input.begin(), median);
+    
+    const PartitionKernel kernels[] = {
+        PartitionKernel::HOARE,
+        PartitionKernel::LOMUTO,
+        PartitionKernel::BRANCHLESS_BLOCK,
+        PartitionKernel::AVX2
+    };
+    
+    BranchMissCounter counter;
+    std::vector<PartitionKernelResult> results;
+    std::vector<int> work;
+    for (PartitionKernel kernel : kernels) {
+        PartitionKernelResult result{kernel, isPartitionKernelSupported(kernel), 0.0, -1};
+        if (!result.supported) {
+            results.push_back(result);
+            continue;
+        }
+        
+        double bestSeconds = 0.0;
+        for (int run = 0; run < std::max(1, repetitions); run++) {
+            work = input;
+            counter.start();
+            auto start = std::chrono::steady_clock::now();
+            partitionRange(kernel, work.data(), 0, static_cast<int>(work.size()) - 1);
+            auto end = std::chrono::steady_clock::now();
+            long long misses = counter.stop();
+            
+            double seconds = std::chrono::duration<double>(end - start).count();
+            if (run == 0 || seconds < bestSeconds) {
+                bestSeconds = seconds;
+                result.branchMisses = misses;
+            }
+        }
+        result.elementsPerSecond = bestSeconds > 0.0 ? static_cast<double>(work.size()) / bestSeconds : 0.0;
+        results.push_back(result);
+    }
+    return results;
+}
\ No newline at end of file
@@ -1,15 +1,39 @@
 #include "simulations/sorting/quicksort/QuicksortController.h"
+#include "simulations/sorting/quicksort/ParallelQuicksort.h"
+#include "core/TraceLogger.h"
 #include <algorithm>
 #include <random>
 #include <string>
 #include <iostream>
-#include <fstream>
 
-QuicksortController::QuicksortController() 
-    : m_state(QuicksortState::READY)
+QuicksortController::QuicksortController()
+    : m_traceBase(0)
+    , m_state(QuicksortState::READY)
     , m_currentStepIndex(0)
     , m_stepDelay(2500.0f)  // Start much slower - 2.5 seconds per step
     , m_timeSinceLastStep(0.0f)
+    , m_keyframeInterval(1024)
+    , m_lazyGeneration(false)
+    , m_historyLimit(65536)
+    , m_generatorPhase(GeneratorPhase::DONE)
+    , m_parallelTrace(false)
+    , m_rangeLow(0)
+    , m_rangeHigh(-1)
+    , m_rangeBudget(0)
+    , m_pivotValue(0)
+    , m_pivotIndex(-1)
+    , m_leftPointer(0)
+    , m_rightPointer(-1)
+    , m_scanIndex(0)
+    , m_heapSize(0)
+    , m_heapBuildIndex(0)
+    , m_siftNode(0)
+    , m_siftForBuild(false)
+    , m_pivotRng(1)
+    , m_finaleIndex(0)
+    , m_pendingSwapFirst(-1)
+    , m_pendingSwapSecond(-1)
+    , m_stepWorkerId(-1)
     , m_totalOperations(0)
     , m_totalComparisons(0)
     , m_totalSwaps(0)
@@ -31,8 +55,8 @@ void QuicksortController::initialize(const std::vector<int>& data) {
     
     generateSteps();
     
-    if (!m_steps.empty()) {
-        m_currentStep = m_steps[0];
+    if (getTotalSteps() > 0) {
+        m_currentStep = stepAt(0);
         if (m_stepCallback) {
             m_stepCallback(m_currentStep);
         }
@@ -65,8 +89,8 @@ void QuicksortController::reset() {
     
     generateSteps();
     
-    if (!m_steps.empty()) {
-        m_currentStep = m_steps[0];
+    if (getTotalSteps() > 0) {
+        m_currentStep = stepAt(0);
         if (m_stepCallback) {
             m_stepCallback(m_currentStep);
         }
@@ -74,19 +98,123 @@ void QuicksortController::reset() {
 }
 
 void QuicksortController::step() {
-    if (m_currentStepIndex < m_steps.size() - 1) {
-        m_currentStepIndex++;
-        m_currentStep = m_steps[m_currentStepIndex];
-        m_currentArray = m_currentStep.array;
-        
-        if (m_stepCallback) {
-            m_stepCallback(m_currentStep);
-        }
-        
-        if (m_currentStepIndex >= m_steps.size() - 1) {
-            m_state = QuicksortState::COMPLETED;
+    if (!ensureStepGenerated(m_currentStepIndex + 1)) return;
+    
+    if (m_currentStepIndex < m_traceBase) {
+        // The current step fell out of the history window while generating
+        seek(m_currentStepIndex + 1);
+        return;
+    }
+    
+    m_currentStepIndex++;
+    m_currentStep = stepAt(m_currentStepIndex);
+    applyStepDelta(m_currentStep);
+    applyOwnerClaim(m_currentStep, m_barOwners);
+    
+    if (m_stepCallback) {
+        m_stepCallback(m_currentStep);
+    }
+    
+    if (isTraceComplete() && m_currentStepIndex >= getTotalSteps() - 1) {
+        m_state = QuicksortState::COMPLETED;
+    }
+}
+
+void QuicksortController::seek(size_t stepIndex) {
+    if (getTotalSteps() == 0) return;
+    
+    ensureStepGenerated(stepIndex);
+    size_t target = std::min(stepIndex, getTotalSteps() - 1);
+    bool currentValid = m_currentStepIndex >= m_traceBase && m_currentStepIndex < getTotalSteps();
+    
+    if (target < m_traceBase) {
+        // History before the retained window was discarded; regenerate from the start
+        generateSteps();
+        ensureStepGenerated(target);
+        currentValid = false;
+    }
+    
+    // Restore from the nearest keyframe at or before the target unless walking
+    // from the current position is cheaper
+    auto keyframe = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), target,
+        [](size_t index, const QuicksortKeyframe& frame) { return index < frame.stepIndex; });
+    if (keyframe != m_keyframes.begin()) {
+        --keyframe;
+        size_t distanceFromCurrent = (target > m_currentStepIndex) ? target - m_currentStepIndex : m_currentStepIndex - target;
+        // Worker ownership can't be undone step by step, so parallel traces never walk backwards
+        bool mustRestore = m_parallelTrace && target < m_currentStepIndex;
+        if (!currentValid || mustRestore || target - keyframe->stepIndex < distanceFromCurrent) {
+            m_currentArray = keyframe->array;
+            m_barOwners = keyframe->owners;
+            m_currentStepIndex = keyframe->stepIndex;
         }
     }
+    
+    while (m_currentStepIndex < target) {
+        m_currentStepIndex++;
+        applyStepDelta(stepAt(m_currentStepIndex));
+        applyOwnerClaim(stepAt(m_currentStepIndex), m_barOwners);
+    }
+    while (m_currentStepIndex > target) {
+        applyStepDelta(stepAt(m_currentStepIndex));
+        m_currentStepIndex--;
+    }
+    
+    m_currentStep = stepAt(m_currentStepIndex);
+    if (isTraceComplete() && m_currentStepIndex >= getTotalSteps() - 1) {
+        m_state = QuicksortState::COMPLETED;
+    } else if (m_state == QuicksortState::COMPLETED) {
+        m_state = QuicksortState::PAUSED;
+    }
+    
+    if (m_stepCallback) {
+        m_stepCallback(m_currentStep);
+    }
+}
+
+void QuicksortController::setKeyframeInterval(size_t interval) {
+    m_keyframeInterval = std::max<size_t>(1, interval);
+    rebuildKeyframes();
+}
+
+void QuicksortController::setLazyGeneration(bool lazy) {
+    // Takes effect the next time the trace is generated (initialize/reset)
+    m_lazyGeneration = lazy;
+}
+
+void QuicksortController::setHistoryLimit(size_t steps) {
+    // 0 keeps the whole trace; only applies in lazy mode
+    m_historyLimit = steps;
+    trimHistory();
+}
+
+void QuicksortController::setEngineSettings(const QuicksortEngineSettings& settings) {
+    // Takes effect the next time the trace is generated (initialize/reset)
+    m_engineSettings = settings;
+}
+
+std::string QuicksortController::getEngineDescription() const {
+    if (m_engineSettings.workerCount > 0) {
+        return "PARALLEL: " + std::to_string(m_engineSettings.workerCount) + " WORKERS | PIVOT: MEDIAN-OF-3 | PARTITION: HOARE | FORK ABOVE " +
+               std::to_string(m_engineSettings.forkCutoff) + " | NATIVE KERNEL: " + getPartitionKernelName(m_engineSettings.partitionKernel);
+    }
+    
+    std::string description = "PIVOT: ";
+    switch (m_engineSettings.pivotStrategy) {
+        case QuicksortPivotStrategy::FIRST: description += "FIRST"; break;
+        case QuicksortPivotStrategy::MEDIAN_OF_THREE: description += "MEDIAN-OF-3"; break;
+        case QuicksortPivotStrategy::NINTHER: description += "NINTHER"; break;
+        case QuicksortPivotStrategy::RANDOM: description += "RANDOM"; break;
+    }
+    description += " | PARTITION: ";
+    switch (m_engineSettings.partitionScheme) {
+        case QuicksortPartitionScheme::HOARE: description += "HOARE"; break;
+        case QuicksortPartitionScheme::THREE_WAY: description += "3-WAY"; break;
+        case QuicksortPartitionScheme::DUAL_PIVOT: description += "DUAL-PIVOT"; break;
+    }
+    description += m_engineSettings.introsortFallback ? " | INTROSORT: ON" : " | INTROSORT: OFF";
+    description += " | NATIVE KERNEL: " + getPartitionKernelName(m_engineSettings.partitionKernel);
+    return description;
 }
 
 void QuicksortController::setSpeed(float delayMs) {
@@ -109,155 +237,444 @@ void QuicksortController::update(float deltaTime) {
 }
 
 void QuicksortController::generateSteps() {
+    resetGenerator();
+    
+    if (isLazyGeneration()) {
+        // Only the first step up front; the rest is produced as step() asks for it
+        ensureStepGenerated(0);
+    } else {
+        while (advanceGenerator()) {
+        }
+    }
+    m_barOwners.assign(m_parallelTrace ? m_originalArray.size() : 0, -1);
+}
+
+void QuicksortController::resetGenerator() {
     m_steps.clear();
+    m_keyframes.clear();
+    m_traceBase = 0;
     
     // Reset counters
     m_totalOperations = 0;
     m_totalComparisons = 0;
     m_totalSwaps = 0;
+    m_pendingSwapFirst = -1;
+    m_pendingSwapSecond = -1;
+    m_stepWorkerId = -1;
     
-    // Initial state
-    addStep(m_steps, m_originalArray, -1, 0, static_cast<int>(m_originalArray.size()) - 1, "Starting Quicksort");
-    
-    // Generate sorting steps
-    std::vector<int> workingArray = m_originalArray;
-    quicksortRecursive(workingArray, 0, static_cast<int>(workingArray.size()) - 1, m_steps);
-    
-    // Final state
-    addStep(m_steps, workingArray, -1, -1, -1, "Quicksort Complete!");
-    
-    // Add finale sequence - highlight each bar from smallest to largest
-    addFinaleSequence(m_steps, workingArray);
+    m_parallelTrace = m_engineSettings.workerCount > 0;
+    m_workingArray = m_originalArray;
+    m_workingOwners.assign(m_parallelTrace ? m_originalArray.size() : 0, -1);
+    m_rangeStack.clear();
+    m_pivotRng.seed(m_engineSettings.randomSeed);
+    m_finaleIndex = 0;
+    m_generatorPhase = GeneratorPhase::START;
 }
 
-void QuicksortController::quicksortRecursive(std::vector<int>& arr, int low, int high, std::vector<QuicksortStep>& steps) {
-    if (low < high) {
-        // Add step showing the current subarray being processed
-        addStep(steps, arr, -1, low, high, "Processing subarray [" + std::to_string(low) + ", " + std::to_string(high) + "]");
-        
-        // Partition the array
-        int pivotIndex = partition(arr, low, high, steps);
-        
-        // Add step showing the pivot in its final position
-        addStep(steps, arr, pivotIndex, low, high, "Pivot " + std::to_string(arr[pivotIndex]) + " in final position");
-        
-        // Recursively sort left and right subarrays
-        quicksortRecursive(arr, low, pivotIndex - 1, steps);
-        quicksortRecursive(arr, pivotIndex + 1, high, steps);
+bool QuicksortController::ensureStepGenerated(size_t stepIndex) {
+    while (getTotalSteps() <= stepIndex && advanceGenerator()) {
     }
+    return stepIndex < getTotalSteps();
 }
 
-int QuicksortController::partition(std::vector<int>& arr, int low, int high, std::vector<QuicksortStep>& steps) {
-    // Debug logging
-    std::ofstream debug("quicksort_debug.log", std::ios::app);
-    debug << "Partition called: low=" << low << ", high=" << high << ", array_size=" << arr.size() << std::endl;
+bool QuicksortController::advanceGenerator() {
+    std::vector<int>& arr = m_workingArray;
+    int& low = m_rangeLow;
+    int& high = m_rangeHigh;
+    int& left = m_leftPointer;
+    int& right = m_rightPointer;
+    int pivot = m_pivotValue;
+    size_t stepsBefore = getTotalSteps();
     
-    // Bounds checking
-    if (low < 0 || high >= static_cast<int>(arr.size()) || low > high) {
-        debug << "ERROR: Invalid partition bounds!" << std::endl;
-        debug.close();
-        return low; // Safe fallback
-    }
-    
-    // Hoare Partition Scheme - proper two-pointer QuickSort
-    int pivot = arr[low]; // Choose first element as pivot (like OpenDSA reference)
-    int left = low + 1;   // Left pointer starts after pivot
-    int right = high;     // Right pointer starts at end
-    
-    debug << "Initial: pivot=" << pivot << ", left=" << left << ", right=" << right << std::endl;
-    debug.close();
-    
-    // Add step showing the chosen pivot and initial pointers
-    addStep(steps, arr, low, left, right, "Pivot: " + std::to_string(pivot) + " | Left pointer at " + std::to_string(left) + ", Right pointer at " + std::to_string(right));
-    
-    while (left <= right) {
-        // Move left pointer right until we find element >= pivot
-        while (left <= right && arr[left] < pivot) {
-            addStep(steps, arr, low, left, right, "Left scan: " + std::to_string(arr[left]) + " < " + std::to_string(pivot) + " -> move right", true, false);
-            left++;
-        }
-        
-        // Move right pointer left until we find element <= pivot  
-        while (left <= right && arr[right] > pivot) {
-            addStep(steps, arr, low, left, right, "Right scan: " + std::to_string(arr[right]) + " > " + std::to_string(pivot) + " -> move left", true, false);
-            right--;
-        }
-        
-        // If pointers haven't crossed, we found elements to swap
-        if (left <= right) {
-            if (left != right) {
-                // Step 1: Show elements that will be swapped
-                addStep(steps, arr, low, left, right, "Found: " + std::to_string(arr[left]) + " >= " + std::to_string(pivot) + " and " + std::to_string(arr[right]) + " <= " + std::to_string(pivot) + " -> Will swap", false, true);
+    // Run transitions until one of them records a step (or the trace ends)
+    while (m_generatorPhase != GeneratorPhase::DONE && getTotalSteps() == stepsBefore) {
+        switch (m_generatorPhase) {
+            case GeneratorPhase::START:
+                // Initial state
+                addStep(QuicksortStepKind::START, -1, 0, static_cast<int>(arr.size()) - 1);
+                if (m_parallelTrace) {
+                    // The pool sorts in one go; its steps are appended here in merge order
+                    recordParallelTrace();
+                    m_generatorPhase = GeneratorPhase::SORT_COMPLETE;
+                    break;
+                }
+                {
+                    // Introsort budget: log2(n) unbalanced partitions before heapsort
+                    int budget = 0;
+                    for (size_t n = arr.size(); n > 1; n >>= 1) budget++;
+                    m_rangeStack.push_back({0, static_cast<int>(arr.size()) - 1, budget});
+                }
+                m_generatorPhase = GeneratorPhase::NEXT_RANGE;
+                break;
+            
+            case GeneratorPhase::NEXT_RANGE:
+                if (m_rangeStack.empty()) {
+                    m_generatorPhase = GeneratorPhase::SORT_COMPLETE;
+                    break;
+                }
+                low = m_rangeStack.back().low;
+                high = m_rangeStack.back().high;
+                m_rangeBudget = m_rangeStack.back().badPartitionBudget;
+                m_rangeStack.pop_back();
+                if (low < high) {
+                    if (m_engineSettings.introsortFallback && m_rangeBudget <= 0) {
+                        // Pivots keep failing on this input; finish the range with heapsort
+                        addStep(QuicksortStepKind::HEAPSORT_FALLBACK, -1, low, high);
+                        m_heapSize = high - low + 1;
+                        m_heapBuildIndex = m_heapSize / 2 - 1;
+                        m_generatorPhase = GeneratorPhase::HEAP_BUILD;
+                    } else {
+                        // Add step showing the current subarray being processed
+                        addStep(QuicksortStepKind::PROCESS_SUBARRAY, -1, low, high);
+                        m_generatorPhase = GeneratorPhase::SELECT_PIVOT;
+                    }
+                }
+                break;
+            
+            case GeneratorPhase::SELECT_PIVOT: {
+                QuicksortPartitionScheme scheme = m_engineSettings.partitionScheme;
+                bool dual = scheme == QuicksortPartitionScheme::DUAL_PIVOT;
+                if (dual) {
+                    m_generatorPhase = GeneratorPhase::SELECT_SECOND_PIVOT;
+                } else if (scheme == QuicksortPartitionScheme::THREE_WAY) {
+                    m_generatorPhase = GeneratorPhase::THREE_WAY_BEGIN;
+                } else {
+                    m_generatorPhase = GeneratorPhase::PARTITION_BEGIN;
+                }
                 
-                // Perform the swap
-                std::swap(arr[left], arr[right]);
+                // The first element is already in the pivot slot. Dual-pivot
+                // sampling needs at least two elements per outer third.
+                if (m_engineSettings.pivotStrategy == QuicksortPivotStrategy::FIRST || (dual && high - low < 5)) {
+                    if (dual) m_generatorPhase = GeneratorPhase::DUAL_BEGIN;
+                    break;
+                }
                 
-                // Step 2: Show result after swap
-                addStep(steps, arr, low, left, right, "Swapped: " + std::to_string(arr[left]) + " <-> " + std::to_string(arr[right]) + " | Continue scanning", false, true);
+                QuicksortStepKind kind;
+                int chosen = dual ? choosePivotIndex(low, low + (high - low + 1) / 3 - 1, kind) : choosePivotIndex(low, high, kind);
+                if (chosen != low) swapElements(low, chosen);
+                addStep(kind, low, low, chosen, false, chosen != low);
+                break;
             }
             
-            // Move both pointers inward
-            left++;
-            right--;
+            case GeneratorPhase::SELECT_SECOND_PIVOT: {
+                // Second dual pivot comes from the last third and moves to the end
+                QuicksortStepKind kind;
+                int chosen = choosePivotIndex(high - (high - low + 1) / 3 + 1, high, kind);
+                if (chosen != high) swapElements(chosen, high);
+                addStep(kind, high, chosen, high, false, chosen != high);
+                m_generatorPhase = GeneratorPhase::DUAL_BEGIN;
+                break;
+            }
             
-            if (left <= right) {
-                addStep(steps, arr, low, left, right, "Move pointers: Left to " + std::to_string(left) + ", Right to " + std::to_string(right));
+            case GeneratorPhase::PARTITION_BEGIN: {
+                // Hoare Partition Scheme - proper two-pointer QuickSort
+                pivot = m_pivotValue = arr[low]; // Choose first element as pivot (like OpenDSA reference)
+                left = low + 1;   // Left pointer starts after pivot
+                right = high;     // Right pointer starts at end
+                
+                SIM_TRACE_DEBUG("Partition called: low={}, high={}, array_size={}", low, high, arr.size());
+                SIM_TRACE_DEBUG("Initial: pivot={}, left={}, right={}", pivot, left, right);
+                
+                // Add step showing the chosen pivot and initial pointers
+                addStep(QuicksortStepKind::PIVOT_SELECTED, low, left, right);
+                m_generatorPhase = GeneratorPhase::SCAN_LEFT;
+                break;
+            }
+            
+            case GeneratorPhase::SCAN_LEFT:
+                // Move left pointer right until we find element >= pivot
+                if (left <= right && arr[left] < pivot) {
+                    addStep(QuicksortStepKind::LEFT_SCAN, low, left, right, true, false);
+                    left++;
+                } else {
+                    m_generatorPhase = GeneratorPhase::SCAN_RIGHT;
+                }
+                break;
+            
+            case GeneratorPhase::SCAN_RIGHT:
+                // Move right pointer left until we find element <= pivot
+                if (left <= right && arr[right] > pivot) {
+                    addStep(QuicksortStepKind::RIGHT_SCAN, low, left, right, true, false);
+                    right--;
+                } else {
+                    m_generatorPhase = GeneratorPhase::CHECK_SWAP;
+                }
+                break;
+            
+            case GeneratorPhase::CHECK_SWAP:
+                // If pointers haven't crossed, we found elements to swap
+                if (left <= right) {
+                    if (left != right) {
+                        // Show elements that will be swapped
+                        addStep(QuicksortStepKind::SWAP_PENDING, low, left, right, false, true);
+                        m_generatorPhase = GeneratorPhase::SWAP;
+                    } else {
+                        m_generatorPhase = GeneratorPhase::MOVE_POINTERS;
+                    }
+                } else {
+                    m_generatorPhase = GeneratorPhase::PLACE_PIVOT;
+                }
+                break;
+            
+            case GeneratorPhase::SWAP:
+                swapElements(left, right);
+                
+                // Show result after swap
+                addStep(QuicksortStepKind::SWAPPED, low, left, right, false, true);
+                m_generatorPhase = GeneratorPhase::MOVE_POINTERS;
+                break;
+            
+            case GeneratorPhase::MOVE_POINTERS:
+                // Move both pointers inward
+                left++;
+                right--;
+                
+                if (left <= right) {
+                    addStep(QuicksortStepKind::MOVE_POINTERS, low, left, right);
+                }
+                m_generatorPhase = GeneratorPhase::SCAN_LEFT;
+                break;
+            
+            case GeneratorPhase::PLACE_PIVOT: {
+                SIM_TRACE_DEBUG("After loop: left={}, right={}", left, right);
+                
+                // Place pivot in its final position
+                // In Hoare partition, when pointers cross, right pointer indicates where pivot should go
+                // But we need to ensure right is valid (>= low) before swapping
+                if (right > low) {
+                    SIM_TRACE_DEBUG("Swapping pivot at {} with element at {}", low, right);
+                    SIM_TRACE_DEBUG("Before swap: arr[{}]={}, arr[{}]={}", low, arr[low], right, arr[right]);
+                    
+                    addStep(QuicksortStepKind::PIVOT_MOVE_PENDING, low, low, right, false, true);
+                    m_generatorPhase = GeneratorPhase::MOVE_PIVOT;
+                } else {
+                    // Edge case: pivot is already in correct position (smallest element)
+                    SIM_TRACE_DEBUG("Pivot stays at position {} (smallest element)", low);
+                    
+                    addStep(QuicksortStepKind::PIVOT_IN_PLACE, low, low, high);
+                    m_pivotIndex = low;
+                    m_generatorPhase = GeneratorPhase::PARTITION_DONE;
+                }
+                break;
             }
+            
+            case GeneratorPhase::MOVE_PIVOT:
+                swapElements(low, right);
+                SIM_TRACE_DEBUG("After swap: arr[{}]={}, arr[{}]={}", low, arr[low], right, arr[right]);
+                addStep(QuicksortStepKind::PIVOT_PLACED, right, low, high);
+                m_pivotIndex = right;
+                m_generatorPhase = GeneratorPhase::PARTITION_DONE;
+                break;
+            
+            case GeneratorPhase::PARTITION_DONE:
+                // Add step showing the pivot in its final position
+                addStep(QuicksortStepKind::PIVOT_FINAL, m_pivotIndex, low, high);
+                
+                scheduleRanges({{low, m_pivotIndex - 1}, {m_pivotIndex + 1, high}});
+                m_generatorPhase = GeneratorPhase::NEXT_RANGE;
+                break;
+            
+            case GeneratorPhase::THREE_WAY_BEGIN:
+                // Dijkstra's partition: [low, lt) < pivot, [lt, i) == pivot, (gt, high] > pivot
+                left = low;
+                m_scanIndex = low + 1;
+                right = high;
+                addStep(QuicksortStepKind::PIVOT_SELECTED, low, m_scanIndex, right);
+                m_generatorPhase = GeneratorPhase::THREE_WAY_SCAN;
+                break;
+            
+            case GeneratorPhase::THREE_WAY_SCAN: {
+                int& i = m_scanIndex;
+                if (i > right) {
+                    // The equal run is final; only the strict sides recurse
+                    addStep(QuicksortStepKind::THREE_WAY_DONE, left, left, right);
+                    scheduleRanges({{low, left - 1}, {right + 1, high}});
+                    m_generatorPhase = GeneratorPhase::NEXT_RANGE;
+                    break;
+                }
+                
+                // arr[left] always holds the pivot value
+                if (arr[i] < arr[left]) {
+                    swapElements(left, i);
+                    left++;
+                    i++;
+                    addStep(QuicksortStepKind::THREE_WAY_LESS, left, left - 1, i - 1, true, true);
+                } else if (arr[i] > arr[left]) {
+                    if (i != right) swapElements(i, right);
+                    right--;
+                    addStep(QuicksortStepKind::THREE_WAY_GREATER, left, i, right + 1, true, i != right + 1);
+                } else {
+                    i++;
+                    addStep(QuicksortStepKind::THREE_WAY_EQUAL, left, i - 1, right, true, false);
+                }
+                break;
+            }
+            
+            case GeneratorPhase::DUAL_BEGIN: {
+                // Yaroslavskiy-style split into < P, P..Q and > Q with P = arr[low] <= Q = arr[high]
+                bool swapped = arr[low] > arr[high];
+                if (swapped) swapElements(low, high);
+                left = low + 1;
+                m_scanIndex = low + 1;
+                right = high - 1;
+                addStep(QuicksortStepKind::DUAL_PIVOTS_SELECTED, low, m_scanIndex, right, true, swapped, high);
+                m_generatorPhase = GeneratorPhase::DUAL_SCAN;
+                break;
+            }
+            
+            case GeneratorPhase::DUAL_SCAN: {
+                int& k = m_scanIndex;
+                if (k > right) {
+                    m_generatorPhase = GeneratorPhase::DUAL_PLACE_LOW;
+                    break;
+                }
+                
+                if (arr[k] < arr[low]) {
+                    bool swapped = k != left;
+                    if (swapped) swapElements(k, left);
+                    left++;
+                    k++;
+                    addStep(QuicksortStepKind::DUAL_LESS, low, left - 1, k - 1, true, swapped, high);
+                } else if (arr[k] > arr[high]) {
+                    bool swapped = k != right;
+                    if (swapped) swapElements(k, right);
+                    right--;
+                    addStep(QuicksortStepKind::DUAL_GREATER, low, k, right + 1, true, swapped, high);
+                } else {
+                    k++;
+                    addStep(QuicksortStepKind::DUAL_MIDDLE, low, k - 1, right, true, false, high);
+                }
+                break;
+            }
+            
+            case GeneratorPhase::DUAL_PLACE_LOW: {
+                left--;
+                bool swapped = left != low;
+                if (swapped) swapElements(low, left);
+                addStep(QuicksortStepKind::DUAL_PIVOT_PLACED, left, low, left, false, swapped, high);
+                m_generatorPhase = GeneratorPhase::DUAL_PLACE_HIGH;
+                break;
+            }
+            
+            case GeneratorPhase::DUAL_PLACE_HIGH: {
+                right++;
+                bool swapped = right != high;
+                if (swapped) swapElements(right, high);
+                addStep(QuicksortStepKind::DUAL_PIVOT_PLACED, right, right, high, false, swapped, left);
+                
+                // With equal pivots the middle part is all equal and already in place
+                int middleHigh = (arr[left] == arr[right]) ? left : right - 1;
+                scheduleRanges({{low, left - 1}, {left + 1, middleHigh}, {right + 1, high}});
+                m_generatorPhase = GeneratorPhase::NEXT_RANGE;
+                break;
+            }
+            
+            case GeneratorPhase::HEAP_BUILD:
+                if (m_heapBuildIndex >= 0) {
+                    m_siftNode = m_heapBuildIndex--;
+                    m_siftForBuild = true;
+                    m_generatorPhase = GeneratorPhase::HEAP_SIFT;
+                } else {
+                    m_generatorPhase = GeneratorPhase::HEAP_EXTRACT;
+                }
+                break;
+            
+            case GeneratorPhase::HEAP_SIFT: {
+                // One sift-down level per step; heap indices are relative to low
+                int child = 2 * m_siftNode + 1;
+                if (child < m_heapSize) {
+                    if (child + 1 < m_heapSize && arr[low + child + 1] > arr[low + child]) child++;
+                    if (arr[low + child] > arr[low + m_siftNode]) {
+                        swapElements(low + m_siftNode, low + child);
+                        addStep(QuicksortStepKind::HEAP_SIFT, -1, low + m_siftNode, low + child, true, true);
+                        m_siftNode = child;
+                        break;
+                    }
+                }
+                m_generatorPhase = m_siftForBuild ? GeneratorPhase::HEAP_BUILD : GeneratorPhase::HEAP_EXTRACT;
+                break;
+            }
+            
+            case GeneratorPhase::HEAP_EXTRACT:
+                if (m_heapSize > 1) {
+                    m_heapSize--;
+                    swapElements(low, low + m_heapSize);
+                    addStep(QuicksortStepKind::HEAP_EXTRACT, -1, low, low + m_heapSize, false, true);
+                    m_siftNode = 0;
+                    m_siftForBuild = false;
+                    m_generatorPhase = GeneratorPhase::HEAP_SIFT;
+                } else {
+                    m_generatorPhase = GeneratorPhase::NEXT_RANGE;
+                }
+                break;
+            
+            case GeneratorPhase::SORT_COMPLETE:
+                // Final state
+                addStep(QuicksortStepKind::SORT_COMPLETE, -1, -1, -1);
+                m_finaleIndex = 0;
+                m_generatorPhase = GeneratorPhase::FINALE;
+                break;
+            
+            case GeneratorPhase::FINALE:
+                // Finale sequence - highlight each bar from smallest to largest. The
+                // array is sorted here, so each value's first position is a binary search.
+                if (m_finaleIndex < arr.size()) {
+                    int position = static_cast<int>(std::lower_bound(arr.begin(), arr.end(), arr[m_finaleIndex]) - arr.begin());
+                    addStep(QuicksortStepKind::FINALE, position, -1, -1);
+                    m_finaleIndex++;
+                } else {
+                    // Final celebration step
+                    addStep(QuicksortStepKind::FINISHED, -1, -1, -1);
+                    m_generatorPhase = GeneratorPhase::DONE;
+                }
+                break;
+            
+            case GeneratorPhase::DONE:
+                break;
         }
     }
     
-    // Debug final pointer positions
-    std::ofstream debug2("quicksort_debug.log", std::ios::app);
-    debug2 << "After loop: left=" << left << ", right=" << right << std::endl;
+    return getTotalSteps() != stepsBefore;
+}
+
+void QuicksortController::trimHistory() {
+    if (!isLazyGeneration() || m_historyLimit == 0 || getTotalSteps() <= m_historyLimit) return;
     
-    // Place pivot in its final position
-    // In Hoare partition, when pointers cross, right pointer indicates where pivot should go
-    // But we need to ensure right is valid (>= low) before swapping
-    if (right > low) {
-        debug2 << "Swapping pivot at " << low << " with element at " << right << std::endl;
-        debug2 << "Before swap: arr[" << low << "]=" << arr[low] << ", arr[" << right << "]=" << arr[right] << std::endl;
-        
-        addStep(steps, arr, low, low, right, "Partition complete: Moving pivot to position " + std::to_string(right), false, true);
-        std::swap(arr[low], arr[right]);
-        
-        debug2 << "After swap: arr[" << low << "]=" << arr[low] << ", arr[" << right << "]=" << arr[right] << std::endl;
-        debug2.close();
-        
-        addStep(steps, arr, right, -1, -1, "Pivot " + std::to_string(arr[right]) + " in final position | Left partition: [" + std::to_string(low) + "-" + std::to_string(right-1) + "] | Right partition: [" + std::to_string(right+1) + "-" + std::to_string(high) + "]");
-        return right;
-    } else {
-        // Edge case: pivot is already in correct position (smallest element)
-        debug2 << "Pivot stays at position " << low << " (smallest element)" << std::endl;
-        debug2.close();
-        
-        addStep(steps, arr, low, -1, -1, "Pivot " + std::to_string(arr[low]) + " already in final position | Right partition: [" + std::to_string(low+1) + "-" + std::to_string(high) + "]");
-        return low;
+    // Drop whole keyframe intervals so the window always starts at a keyframe
+    size_t oldestWanted = getTotalSteps() - m_historyLimit;
+    while (m_keyframes.size() > 1 && m_keyframes[1].stepIndex <= oldestWanted) {
+        m_keyframes.pop_front();
+        size_t newBase = m_keyframes.front().stepIndex;
+        m_steps.erase(m_steps.begin(), m_steps.begin() + (newBase - m_traceBase));
+        m_traceBase = newBase;
     }
 }
 
 void QuicksortController::stepBack() {
-    if (m_currentStepIndex > 0) {
-        m_currentStepIndex--;
-        m_currentStep = m_steps[m_currentStepIndex];
-        m_currentArray = m_currentStep.array;
-        
-        if (m_stepCallback) {
-            m_stepCallback(m_currentStep);
-        }
+    if (m_currentStepIndex == 0) return;
+    
+    if (m_currentStepIndex - 1 < m_traceBase || m_parallelTrace) {
+        // Previous step was evicted from the history window, or ownership needs a keyframe restore
+        seek(m_currentStepIndex - 1);
+        return;
+    }
+    
+    // Swaps are their own inverse, so undoing a step re-applies its delta
+    applyStepDelta(stepAt(m_currentStepIndex));
+    m_currentStepIndex--;
+    m_currentStep = stepAt(m_currentStepIndex);
+    
+    if (m_stepCallback) {
+        m_stepCallback(m_currentStep);
     }
 }
 
 void QuicksortController::fastForward() {
     // Jump to completion
-    if (!m_steps.empty()) {
-        m_currentStepIndex = m_steps.size() - 1;
-        m_currentStep = m_steps[m_currentStepIndex];
-        m_currentArray = m_currentStep.array;
-        m_state = QuicksortState::COMPLETED;
-        
-        if (m_stepCallback) {
-            m_stepCallback(m_currentStep);
-        }
+    while (advanceGenerator()) {
+    }
+    if (getTotalSteps() > 0) {
+        seek(getTotalSteps() - 1);
     }
 }
 
@@ -269,71 +686,267 @@ void QuicksortController::speedUp() {
     m_stepDelay = std::max(1.0f, m_stepDelay - 100.0f);  // Much faster minimum - down to 1ms
 }
 
+std::string QuicksortController::getCurrentDescription() const {
+    // Formatted on demand from the step's indices and the current array, which
+    // is exactly the state this step describes
+    const QuicksortStep& step = m_currentStep;
+    const std::vector<int>& arr = m_currentArray;
+    if (getTotalSteps() == 0) return "";
+    
+    auto value = [&arr](int index) { return std::to_string(arr[index]); };
+    
+    switch (step.kind) {
+        case QuicksortStepKind::START:
+            return "Starting Quicksort";
+        case QuicksortStepKind::PROCESS_SUBARRAY:
+            return "Processing subarray [" + std::to_string(step.lowIndex) + ", " + std::to_string(step.highIndex) + "]";
+        case QuicksortStepKind::PIVOT_SELECTED:
+            return "Pivot: " + value(step.pivotIndex) + " | Left pointer at " + std::to_string(step.lowIndex) + ", Right pointer at " + std::to_string(step.highIndex);
+        case QuicksortStepKind::LEFT_SCAN:
+            return "Left scan: " + value(step.lowIndex) + " < " + value(step.pivotIndex) + " -> move right";
+        case QuicksortStepKind::RIGHT_SCAN:
+            return "Right scan: " + value(step.highIndex) + " > " + value(step.pivotIndex) + " -> move left";
+        case QuicksortStepKind::SWAP_PENDING:
+            return "Found: " + value(step.lowIndex) + " >= " + value(step.pivotIndex) + " and " + value(step.highIndex) + " <= " + value(step.pivotIndex) + " -> Will swap";
+        case QuicksortStepKind::SWAPPED:
+            return "Swapped: " + value(step.lowIndex) + " <-> " + value(step.highIndex) + " | Continue scanning";
+        case QuicksortStepKind::MOVE_POINTERS:
+            return "Move pointers: Left to " + std::to_string(step.lowIndex) + ", Right to " + std::to_string(step.highIndex);
+        case QuicksortStepKind::PIVOT_MOVE_PENDING:
+            return "Partition complete: Moving pivot to position " + std::to_string(step.highIndex);
+        case QuicksortStepKind::PIVOT_PLACED:
+            return "Pivot " + value(step.pivotIndex) + " in final position | Left partition: [" + std::to_string(step.lowIndex) + "-" + std::to_string(step.pivotIndex - 1) + "] | Right partition: [" + std::to_string(step.pivotIndex + 1) + "-" + std::to_string(step.highIndex) + "]";
+        case QuicksortStepKind::PIVOT_IN_PLACE:
+            return "Pivot " + value(step.pivotIndex) + " already in final position | Right partition: [" + std::to_string(step.pivotIndex + 1) + "-" + std::to_string(step.highIndex) + "]";
+        case QuicksortStepKind::PIVOT_FINAL:
+            return "Pivot " + value(step.pivotIndex) + " in final position";
+        case QuicksortStepKind::SORT_COMPLETE:
+            return "Quicksort Complete!";
+        case QuicksortStepKind::FINALE:
+            return "Finale: Highlighting value " + value(step.pivotIndex) + " (position " + std::to_string(step.pivotIndex) + ")";
+        case QuicksortStepKind::FINISHED:
+            return "Sorting Complete! Array is perfectly ordered.";
+        case QuicksortStepKind::PIVOT_MEDIAN_OF_THREE:
+        case QuicksortStepKind::PIVOT_NINTHER:
+        case QuicksortStepKind::PIVOT_RANDOM: {
+            std::string strategy = step.kind == QuicksortStepKind::PIVOT_RANDOM ? "Random" :
+                                   step.kind == QuicksortStepKind::PIVOT_NINTHER ? "Ninther" : "Median-of-three";
+            int source = (step.lowIndex == step.pivotIndex) ? step.highIndex : step.lowIndex;
+            return strategy + " pivot: " + value(step.pivotIndex) + " (from position " + std::to_string(source) + ")";
+        }
+        case QuicksortStepKind::THREE_WAY_LESS:
+            return "3-way: " + value(step.lowIndex) + " < " + value(step.pivotIndex) + " -> less region";
+        case QuicksortStepKind::THREE_WAY_GREATER:
+            return "3-way: " + value(step.highIndex) + " > " + value(step.pivotIndex) + " -> greater region";
+        case QuicksortStepKind::THREE_WAY_EQUAL:
+            return "3-way: " + value(step.lowIndex) + " == " + value(step.pivotIndex) + " -> joins equal run";
+        case QuicksortStepKind::THREE_WAY_DONE:
+            return "Equal run [" + std::to_string(step.lowIndex) + "-" + std::to_string(step.highIndex) + "] of " + value(step.pivotIndex) + " in final position";
+        case QuicksortStepKind::DUAL_PIVOTS_SELECTED:
+            return "Dual pivots: " + value(step.pivotIndex) + " and " + value(step.secondPivotIndex);
+        case QuicksortStepKind::DUAL_LESS:
+            return "Dual-pivot: " + value(step.lowIndex) + " < " + value(step.pivotIndex) + " -> left region";
+        case QuicksortStepKind::DUAL_GREATER:
+            return "Dual-pivot: " + value(step.highIndex) + " > " + value(step.secondPivotIndex) + " -> right region";
+        case QuicksortStepKind::DUAL_MIDDLE:
+            return "Dual-pivot: " + value(step.pivotIndex) + " <= " + value(step.lowIndex) + " <= " + value(step.secondPivotIndex) + " -> middle region";
+        case QuicksortStepKind::DUAL_PIVOT_PLACED:
+            return "Pivot " + value(step.pivotIndex) + " in final position " + std::to_string(step.pivotIndex);
+        case QuicksortStepKind::HEAPSORT_FALLBACK:
+            return "Too many unbalanced partitions: heapsort on [" + std::to_string(step.lowIndex) + ", " + std::to_string(step.highIndex) + "]";
+        case QuicksortStepKind::HEAP_SIFT:
+            return "Heap sift: " + value(step.highIndex) + " sinks below " + value(step.lowIndex);
+        case QuicksortStepKind::HEAP_EXTRACT:
+            return "Heap extract: max " + value(step.highIndex) + " to position " + std::to_string(step.highIndex);
+    }
+    return "";
+}
+
 int QuicksortController::getOperationCount() const {
-    if (m_currentStepIndex < m_steps.size()) {
-        return m_steps[m_currentStepIndex].operationCount;
+    if (m_currentStepIndex < getTotalSteps()) {
+        return m_currentStep.operationCount;
     }
     return 0;
 }
 
 int QuicksortController::getComparisonCount() const {
-    if (m_currentStepIndex < m_steps.size()) {
-        return m_steps[m_currentStepIndex].comparisonCount;
+    if (m_currentStepIndex < getTotalSteps()) {
+        return m_currentStep.comparisonCount;
     }
     return 0;
 }
 
 int QuicksortController::getSwapCount() const {
-    if (m_currentStepIndex < m_steps.size()) {
-        return m_steps[m_currentStepIndex].swapCount;
+    if (m_currentStepIndex < getTotalSteps()) {
+        return m_currentStep.swapCount;
     }
     return 0;
 }
 
-void QuicksortController::addStep(std::vector<QuicksortStep>& steps, const std::vector<int>& arr, int pivot, int low, int high, const std::string& desc, bool isComparison, bool isSwap) {
+size_t QuicksortController::getTraceMemoryBytes() const {
+    size_t bytes = m_steps.size() * sizeof(QuicksortStep);
+    for (const auto& keyframe : m_keyframes) {
+        bytes += sizeof(QuicksortKeyframe) + (keyframe.array.capacity() + keyframe.owners.capacity()) * sizeof(int);
+    }
+    return bytes;
+}
+
+void QuicksortController::swapElements(int first, int second) {
+    std::swap(m_workingArray[first], m_workingArray[second]);
+    m_pendingSwapFirst = first;
+    m_pendingSwapSecond = second;
+}
+
+int QuicksortController::choosePivotIndex(int low, int high, QuicksortStepKind& kind) {
+    int mid = low + (high - low) / 2;
+    switch (m_engineSettings.pivotStrategy) {
+        case QuicksortPivotStrategy::RANDOM:
+            kind = QuicksortStepKind::PIVOT_RANDOM;
+            return std::uniform_int_distribution<int>(low, high)(m_pivotRng);
+        case QuicksortPivotStrategy::NINTHER:
+            if (high - low + 1 >= 128) {
+                // Tukey's ninther: median of three medians spread across the range
+                int spread = (high - low + 1) / 8;
+                kind = QuicksortStepKind::PIVOT_NINTHER;
+                return medianOfThree(medianOfThree(low, low + spread, low + 2 * spread),
+                                     medianOfThree(mid - spread, mid, mid + spread),
+                                     medianOfThree(high - 2 * spread, high - spread, high));
+            }
+            // Too small for a ninther to pay off
+            [[fallthrough]];
+        case QuicksortPivotStrategy::MEDIAN_OF_THREE:
+            kind = QuicksortStepKind::PIVOT_MEDIAN_OF_THREE;
+            return medianOfThree(low, mid, high);
+        case QuicksortPivotStrategy::FIRST:
+            break;
+    }
+    kind = QuicksortStepKind::PIVOT_SELECTED;
+    return low;
+}
+
+int QuicksortController::medianOfThree(int a, int b, int c) {
+    const std::vector<int>& arr = m_workingArray;
+    auto less = [this, &arr](int x, int y) {
+        m_totalComparisons++;
+        return arr[x] < arr[y];
+    };
+    
+    if (less(a, b)) {
+        if (less(b, c)) return b;
+        return less(a, c) ? c : a;
+    }
+    if (less(a, c)) return a;
+    return less(b, c) ? c : b;
+}
+
+void QuicksortController::scheduleRanges(std::initializer_list<std::pair<int, int>> ranges) {
+    // pdqsort's rule: a partition is bad if one side keeps more than 7/8 of the range
+    int size = m_rangeHigh - m_rangeLow + 1;
+    int largest = 0;
+    for (const auto& range : ranges) {
+        largest = std::max(largest, range.second - range.first + 1);
+    }
+    int budget = m_rangeBudget - (largest > size - size / 8 ? 1 : 0);
+    
+    std::vector<PendingRange> pending;
+    for (const auto& range : ranges) {
+        if (range.first < range.second) {
+            pending.push_back({range.first, range.second, budget});
+        }
+    }
+    
+    if (m_engineSettings.introsortFallback) {
+        // Push larger ranges first so the smallest is sorted next, bounding the stack to O(log n)
+        std::stable_sort(pending.begin(), pending.end(), [](const PendingRange& a, const PendingRange& b) {
+            return a.high - a.low > b.high - b.low;
+        });
+        m_rangeStack.insert(m_rangeStack.end(), pending.begin(), pending.end());
+    } else {
+        // Sort ranges in the order given (left to right)
+        m_rangeStack.insert(m_rangeStack.end(), pending.rbegin(), pending.rend());
+    }
+}
+
+void QuicksortController::addStep(QuicksortStepKind kind, int pivot, int low, int high, bool isComparison, bool isSwap, int secondPivot) {
     QuicksortStep step;
-    step.array = arr;
+    step.kind = kind;
     step.pivotIndex = pivot;
     step.lowIndex = low;
     step.highIndex = high;
-    step.description = desc;
+    step.swapFirst = m_pendingSwapFirst;
+    step.swapSecond = m_pendingSwapSecond;
+    step.secondPivotIndex = secondPivot;
+    step.workerId = m_stepWorkerId;
     step.operationCount = m_totalOperations;
     step.comparisonCount = m_totalComparisons;
     step.swapCount = m_totalSwaps;
-    steps.push_back(step);
+    m_steps.push_back(step);
+    m_pendingSwapFirst = -1;
+    m_pendingSwapSecond = -1;
     
     // Increment counters AFTER adding the step
     if (isComparison) m_totalComparisons++;
     if (isSwap) m_totalSwaps++;
     m_totalOperations++;
+    
+    // The working array already includes this step's delta
+    applyOwnerClaim(step, m_workingOwners);
+    size_t stepIndex = getTotalSteps() - 1;
+    if (stepIndex % getKeyframeSpacing() == 0) {
+        m_keyframes.push_back({stepIndex, m_workingArray, m_workingOwners});
+    }
+    
+    trimHistory();
 }
 
-void QuicksortController::addFinaleSequence(std::vector<QuicksortStep>& steps, const std::vector<int>& arr) {
-    // Create a sorted copy to verify the array is sorted
-    std::vector<int> sortedArr = arr;
-    std::sort(sortedArr.begin(), sortedArr.end());
+void QuicksortController::rebuildKeyframes() {
+    if (m_keyframes.empty()) return;
     
-    // Highlight each element from smallest to largest
-    for (size_t i = 0; i < sortedArr.size(); ++i) {
-        // Find the position of the current value in the actual array
-        int currentValue = sortedArr[i];
-        int position = -1;
-        
-        for (size_t j = 0; j < arr.size(); ++j) {
-            if (arr[j] == currentValue) {
-                position = static_cast<int>(j);
-                break;
-            }
+    // Replay the deltas once from the window's base keyframe, snapshotting at the spacing
+    size_t spacing = getKeyframeSpacing();
+    QuicksortKeyframe base = std::move(m_keyframes.front());
+    m_keyframes.clear();
+    std::vector<int> replay = base.array;
+    std::vector<int> owners = base.owners;
+    m_keyframes.push_back(std::move(base));
+    
+    for (size_t i = m_traceBase + 1; i < getTotalSteps(); ++i) {
+        const QuicksortStep& step = stepAt(i);
+        if (step.swapFirst >= 0 && step.swapSecond >= 0) {
+            std::swap(replay[step.swapFirst], replay[step.swapSecond]);
         }
-        
-        if (position != -1) {
-            // Create a step that highlights this specific bar
-            addStep(steps, arr, position, -1, -1, 
-                    "Finale: Highlighting value " + std::to_string(currentValue) + 
-                    " (position " + std::to_string(position) + ")");
+        applyOwnerClaim(step, owners);
+        if (i % spacing == 0) {
+            m_keyframes.push_back({i, replay, owners});
         }
     }
+}
+
+void QuicksortController::applyOwnerClaim(const QuicksortStep& step, std::vector<int>& owners) const {
+    // A worker owns every index of the range it last started partitioning
+    if (step.kind == QuicksortStepKind::PROCESS_SUBARRAY && step.workerId >= 0 && !owners.empty()) {
+        std::fill(owners.begin() + step.lowIndex, owners.begin() + step.highIndex + 1, step.workerId);
+    }
+}
+
+void QuicksortController::recordParallelTrace() {
+    // Sort a copy on the pool, then replay its events onto the working array so
+    // keyframes and counters come out exactly as they do for the serial engine
+    std::vector<int> scratch = m_workingArray;
+    ParallelQuicksort sorter(m_engineSettings.workerCount, m_engineSettings.forkCutoff);
+    std::vector<ParallelTraceEvent> events = sorter.sortWithTrace(scratch);
     
-    // Final celebration step
-    addStep(steps, arr, -1, -1, -1, "Sorting Complete! Array is perfectly ordered.");
+    for (const ParallelTraceEvent& event : events) {
+        if (event.swapFirst >= 0) swapElements(event.swapFirst, event.swapSecond);
+        m_totalComparisons += event.comparisons;
+        m_stepWorkerId = event.workerId;
+        addStep(event.kind, event.pivotIndex, event.lowIndex, event.highIndex, false, event.swapFirst >= 0);
+    }
+    m_stepWorkerId = -1;
+}
+
+void QuicksortController::applyStepDelta(const QuicksortStep& step) {
+    if (step.swapFirst >= 0 && step.swapSecond >= 0) {
+        std::swap(m_currentArray[step.swapFirst], m_currentArray[step.swapSecond]);
+    }
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "simulations/sorting/quicksort/QuicksortVisualizer.h"
+#include "core/TraceLogger.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <thread>
+#include <chrono>
 
 QuicksortVisualizer::QuicksortVisualizer() 
     : m_controller(nullptr)
@@ -21,6 +24,9 @@ QuicksortVisualizer::QuicksortVisualizer()
     , m_arrayAreaHeight(350.0f)
     , m_barWidth(0.0f)
     , m_barSpacing(2.0f)
+    , m_scrubBarY(485.0f)
+    , m_scrubBarHeight(10.0f)
+    , m_scrubbing(false)
     , m_animationEnabled(true)
     , m_animationSpeed(1.0f)
     , m_animationsInProgress(false)
@@ -78,10 +84,71 @@ void QuicksortVisualizer::handleEvent(const sf::Event* event) {
             case sf::Keyboard::Key::Enter:
                 selectControl();
                 break;
+            case sf::Keyboard::Key::P: {
+                // Cycle pivot strategy
+                QuicksortEngineSettings settings = m_controller->getEngineSettings();
+                settings.pivotStrategy = static_cast<QuicksortPivotStrategy>((static_cast<int>(settings.pivotStrategy) + 1) % 4);
+                applyEngineSettings(settings);
+                break;
+            }
+            case sf::Keyboard::Key::M: {
+                // Cycle partition scheme
+                QuicksortEngineSettings settings = m_controller->getEngineSettings();
+                settings.partitionScheme = static_cast<QuicksortPartitionScheme>((static_cast<int>(settings.partitionScheme) + 1) % 3);
+                applyEngineSettings(settings);
+                break;
+            }
+            case sf::Keyboard::Key::I: {
+                QuicksortEngineSettings settings = m_controller->getEngineSettings();
+                settings.introsortFallback = !settings.introsortFallback;
+                applyEngineSettings(settings);
+                break;
+            }
+            case sf::Keyboard::Key::W: {
+                // Cycle serial -> 2 -> 4 parallel workers
+                QuicksortEngineSettings settings = m_controller->getEngineSettings();
+                settings.workerCount = settings.workerCount == 0 ? 2 : (settings.workerCount == 2 ? 4 : 0);
+                applyEngineSettings(settings);
+                break;
+            }
+            case sf::Keyboard::Key::N: {
+                // Cycle the kernel the native speedup benchmark (B) sorts with
+                QuicksortEngineSettings settings = m_controller->getEngineSettings();
+                settings.partitionKernel = static_cast<PartitionKernel>((static_cast<int>(settings.partitionKernel) + 1) % 4);
+                applyEngineSettings(settings);
+                break;
+            }
+            case sf::Keyboard::Key::B:
+                startScalingBenchmark();
+                break;
+            case sf::Keyboard::Key::K:
+                startKernelBenchmark();
+                break;
+            case sf::Keyboard::Key::T:
+                // Write the in-memory trace to disk on demand
+                if (!TraceLogger::instance().dumpTrace("quicksort_debug.log")) {
+                    std::cout << "Warning: Could not write quicksort_debug.log\n";
+                }
+                break;
             default:
                 break;
         }
     }
+    else if (auto mousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
+        if (mousePressed->button == sf::Mouse::Button::Left) {
+            m_scrubbing = handleScrub(mousePressed->position.x, mousePressed->position.y);
+        }
+    }
+    else if (auto mouseReleased = event->getIf<sf::Event::MouseButtonReleased>()) {
+        if (mouseReleased->button == sf::Mouse::Button::Left) {
+            m_scrubbing = false;
+        }
+    }
+    else if (auto mouseMoved = event->getIf<sf::Event::MouseMoved>()) {
+        if (m_scrubbing) {
+            handleScrub(mouseMoved->position.x, static_cast<int>(m_scrubBarY));
+        }
+    }
 }
 
 void QuicksortVisualizer::update(float deltaTime) {
@@ -93,6 +160,9 @@ void QuicksortVisualizer::update(float deltaTime) {
         m_controller->update(deltaTime);
     }
     
+    pollScalingBenchmark();
+    pollKernelBenchmark();
+    
     // Update bar positions based on current animations
     if (m_animationsInProgress) {
         updateAnimatedBarPositions();
@@ -108,6 +178,7 @@ void QuicksortVisualizer::update(float deltaTime) {
 
 void QuicksortVisualizer::render(sf::RenderWindow& window) {
     drawArray(window);
+    drawScrubBar(window);
     drawInfo(window);
     drawControls(window);
 }
@@ -140,9 +211,12 @@ void QuicksortVisualizer::drawInfo(sf::RenderWindow& window) {
             break;
     }
     
-    const auto& step = m_controller->getCurrentStep();
-    if (!step.description.empty()) {
-        topInfo << " | " << step.description;
+    std::string description = m_controller->getCurrentDescription();
+    if (!description.empty()) {
+        topInfo << " | " << description;
+    }
+    if (m_controller->getCurrentStep().workerId >= 0) {
+        topInfo << " [WORKER " << m_controller->getCurrentStep().workerId << "]";
     }
     
     sf::Text topText(m_font, topInfo.str(), 18);
@@ -153,7 +227,8 @@ void QuicksortVisualizer::drawInfo(sf::RenderWindow& window) {
     // Second line - Statistics
     std::stringstream statsInfo;
     statsInfo << "SPEED: " << static_cast<int>(m_controller->getSpeed()) << "ms | ";
-    statsInfo << "STEP: " << (m_controller->getCurrentStepIndex() + 1) << "/" << m_controller->getTotalSteps() << " | ";
+    statsInfo << "STEP: " << (m_controller->getCurrentStepIndex() + 1) << "/" << m_controller->getTotalSteps()
+              << (m_controller->isTraceComplete() ? "" : "+") << " | ";
     statsInfo << "OPERATIONS: " << m_controller->getOperationCount() << " | ";
     statsInfo << "COMPARISONS: " << m_controller->getComparisonCount() << " | ";
     statsInfo << "SWAPS: " << m_controller->getSwapCount();
@@ -162,13 +237,69 @@ void QuicksortVisualizer::drawInfo(sf::RenderWindow& window) {
     statsText.setFillColor(m_inactiveColor);
     statsText.setPosition({50.0f, 45.0f});
     window.draw(statsText);
+    
+    // Third line - Engine configuration, with the previous run for comparison
+    std::string engineInfo = m_controller->getEngineDescription() + " | P/M/I/W: change engine";
+    if (!m_previousEngineRun.empty()) {
+        engineInfo += " | PREVIOUS ENGINE: " + m_previousEngineRun;
+    }
+    
+    sf::Text engineText(m_font, engineInfo, 14);
+    engineText.setFillColor(m_inactiveColor);
+    engineText.setPosition({50.0f, 70.0f});
+    window.draw(engineText);
+    
+    // Fourth line - Native benchmark results
+    std::string scalingInfo = m_benchmarkSummary.empty() ? "B: measure parallel speedup | N: native kernel | K: compare partition kernels" : m_benchmarkSummary;
+    sf::Text scalingText(m_font, scalingInfo, 14);
+    scalingText.setFillColor(m_inactiveColor);
+    scalingText.setPosition({50.0f, 90.0f});
+    window.draw(scalingText);
+}
+
+void QuicksortVisualizer::drawScrubBar(sf::RenderWindow& window) {
+    if (!m_controller || m_controller->getTotalSteps() == 0) return;
+    
+    sf::RectangleShape track;
+    track.setPosition(sf::Vector2f(m_arrayAreaX, m_scrubBarY));
+    track.setSize(sf::Vector2f(m_arrayAreaWidth, m_scrubBarHeight));
+    track.setFillColor(m_backgroundColor);
+    track.setOutlineThickness(1.0f);
+    track.setOutlineColor(m_inactiveColor);
+    window.draw(track);
+    
+    size_t lastStep = m_controller->getTotalSteps() - 1;
+    float progress = lastStep > 0 ? static_cast<float>(m_controller->getCurrentStepIndex()) / lastStep : 1.0f;
+    
+    sf::RectangleShape fill;
+    fill.setPosition(sf::Vector2f(m_arrayAreaX, m_scrubBarY));
+    fill.setSize(sf::Vector2f(m_arrayAreaWidth * progress, m_scrubBarHeight));
+    fill.setFillColor(m_primaryColor);
+    window.draw(fill);
+}
+
+bool QuicksortVisualizer::handleScrub(int mouseX, int mouseY) {
+    if (!m_controller || m_controller->getTotalSteps() == 0) return false;
+    
+    // Accept clicks slightly above/below the bar so it is easy to grab
+    if (mouseY < m_scrubBarY - 5.0f || mouseY > m_scrubBarY + m_scrubBarHeight + 5.0f ||
+        mouseX < m_arrayAreaX || mouseX > m_arrayAreaX + m_arrayAreaWidth) {
+        return false;
+    }
+    
+    float ratio = (mouseX - m_arrayAreaX) / m_arrayAreaWidth;
+    ratio = std::max(0.0f, std::min(1.0f, ratio));
+    
+    size_t lastStep = m_controller->getTotalSteps() - 1;
+    m_controller->seek(static_cast<size_t>(ratio * lastStep + 0.5f));
+    return true;
 }
 
 void QuicksortVisualizer::drawControls(sf::RenderWindow& window) {
     if (!m_fontLoaded) return;
     
     // Draw instruction text
-    sf::Text instructionText(m_font, "CONTROLS: Use LEFT/RIGHT arrows to navigate, ENTER to select", 14);
+    sf::Text instructionText(m_font, "CONTROLS: Use LEFT/RIGHT arrows to navigate, ENTER to select, click the timeline to seek", 14);
     instructionText.setFillColor(m_inactiveColor);
     instructionText.setPosition({50.0f, 520.0f});
     window.draw(instructionText);
@@ -190,57 +321,87 @@ void QuicksortVisualizer::setAudioManager(AudioManager* audioManager) {
 }
 
 void QuicksortVisualizer::onQuicksortStep(const QuicksortStep& step) {
+    if (!m_controller) return;
+    
+    // Steps only carry deltas; the controller has already applied them
+    const auto& array = m_controller->getCurrentArray();
+    
     // Start smooth animations to new positions
     if (m_animationEnabled) {
-        startBarAnimations(step.array);
+        startBarAnimations(array);
     } else {
         // Instant update without animation
         updateBarPositions();
     }
     
-    // Play audio based on step description
+    // Play audio based on step kind
     if (m_audioManager) {
-        if (step.description.find("Finale:") != std::string::npos) {
-            // Play ascending pitch for finale sequence based on the highlighted value
-            if (step.pivotIndex >= 0 && step.pivotIndex < static_cast<int>(step.array.size())) {
-                int value = step.array[step.pivotIndex];
-                int minVal = *std::min_element(step.array.begin(), step.array.end());
-                int maxVal = *std::max_element(step.array.begin(), step.array.end());
-                float pitch = m_audioManager->mapValueToPitch(value, minVal, maxVal);
-                m_audioManager->playSound(SoundType::COMPARISON, pitch, 1.0f);
-            }
-        } else if (step.description.find("Sorting Complete!") != std::string::npos) {
-            // Play final completion fanfare
-            m_audioManager->playSound(SoundType::ALGORITHM_COMPLETE, 1.0f, 1.0f);
-        } else if (step.description.find("Left scan") != std::string::npos || 
-                   step.description.find("Right scan") != std::string::npos ||
-                   step.description.find("Compare") != std::string::npos) {
-            // Play comparison sound with pitch based on array values
-            if (step.lowIndex >= 0 && step.lowIndex < static_cast<int>(step.array.size())) {
-                int value = step.array[step.lowIndex];
-                int minVal = *std::min_element(step.array.begin(), step.array.end());
-                int maxVal = *std::max_element(step.array.begin(), step.array.end());
-                float pitch = m_audioManager->mapValueToPitch(value, minVal, maxVal);
-                m_audioManager->playSound(SoundType::COMPARISON, pitch, 0.8f);
-            }
-        } else if (step.description.find("Will swap") != std::string::npos || 
-                   step.description.find("Swapped") != std::string::npos) {
-            // Play swap sound
-            m_audioManager->playSound(SoundType::SWAP, 1.0f, 0.9f);
-        } else if (step.description.find("Pivot") != std::string::npos || 
-                   step.description.find("pivot") != std::string::npos) {
-            // Play pivot selection sound
-            m_audioManager->playSound(SoundType::PIVOT_SELECT, 1.0f, 0.7f);
-        } else if (step.description.find("Complete") != std::string::npos) {
-            // Play completion sound
-            m_audioManager->playSound(SoundType::ALGORITHM_COMPLETE, 1.0f, 1.0f);
+        switch (step.kind) {
+            case QuicksortStepKind::FINALE:
+                // Play ascending pitch for finale sequence based on the highlighted value
+                if (step.pivotIndex >= 0 && step.pivotIndex < static_cast<int>(array.size())) {
+                    int value = array[step.pivotIndex];
+                    int minVal = *std::min_element(array.begin(), array.end());
+                    int maxVal = *std::max_element(array.begin(), array.end());
+                    float pitch = m_audioManager->mapValueToPitch(value, minVal, maxVal);
+                    m_audioManager->playSound(SoundType::COMPARISON, pitch, 1.0f);
+                }
+                break;
+            case QuicksortStepKind::FINISHED:
+            case QuicksortStepKind::SORT_COMPLETE:
+                // Play completion fanfare
+                m_audioManager->playSound(SoundType::ALGORITHM_COMPLETE, 1.0f, 1.0f);
+                break;
+            case QuicksortStepKind::LEFT_SCAN:
+            case QuicksortStepKind::RIGHT_SCAN:
+            case QuicksortStepKind::THREE_WAY_EQUAL:
+            case QuicksortStepKind::DUAL_MIDDLE:
+                // Play comparison sound with pitch based on array values
+                if (step.lowIndex >= 0 && step.lowIndex < static_cast<int>(array.size())) {
+                    int value = array[step.lowIndex];
+                    int minVal = *std::min_element(array.begin(), array.end());
+                    int maxVal = *std::max_element(array.begin(), array.end());
+                    float pitch = m_audioManager->mapValueToPitch(value, minVal, maxVal);
+                    m_audioManager->playSound(SoundType::COMPARISON, pitch, 0.8f);
+                }
+                break;
+            case QuicksortStepKind::SWAP_PENDING:
+            case QuicksortStepKind::SWAPPED:
+            case QuicksortStepKind::THREE_WAY_LESS:
+            case QuicksortStepKind::THREE_WAY_GREATER:
+            case QuicksortStepKind::DUAL_LESS:
+            case QuicksortStepKind::DUAL_GREATER:
+            case QuicksortStepKind::HEAP_SIFT:
+            case QuicksortStepKind::HEAP_EXTRACT:
+                // Play swap sound
+                m_audioManager->playSound(SoundType::SWAP, 1.0f, 0.9f);
+                break;
+            case QuicksortStepKind::PIVOT_SELECTED:
+            case QuicksortStepKind::PIVOT_MOVE_PENDING:
+            case QuicksortStepKind::PIVOT_PLACED:
+            case QuicksortStepKind::PIVOT_IN_PLACE:
+            case QuicksortStepKind::PIVOT_FINAL:
+            case QuicksortStepKind::PIVOT_MEDIAN_OF_THREE:
+            case QuicksortStepKind::PIVOT_NINTHER:
+            case QuicksortStepKind::PIVOT_RANDOM:
+            case QuicksortStepKind::THREE_WAY_DONE:
+            case QuicksortStepKind::DUAL_PIVOTS_SELECTED:
+            case QuicksortStepKind::DUAL_PIVOT_PLACED:
+                // Play pivot selection sound
+                m_audioManager->playSound(SoundType::PIVOT_SELECT, 1.0f, 0.7f);
+                break;
+            case QuicksortStepKind::HEAPSORT_FALLBACK:
+                m_audioManager->playSound(SoundType::HIGHLIGHT, 1.0f, 0.8f);
+                break;
+            default:
+                break;
         }
     }
 }
 
 sf::Color QuicksortVisualizer::getBarColor(int index, const QuicksortStep& step) {
     // Special finale sequence highlighting
-    if (step.description.find("Finale:") != std::string::npos) {
+    if (step.kind == QuicksortStepKind::FINALE) {
         if (index == step.pivotIndex) {
             // Bright highlight for the current bar in finale
             return sf::Color(0, 255, 150);  // Bright cyan-green for finale highlight
@@ -254,16 +415,16 @@ sf::Color QuicksortVisualizer::getBarColor(int index, const QuicksortStep& step)
     }
     
     // Final celebration - all bars bright
-    if (step.description.find("Sorting Complete!") != std::string::npos) {
+    if (step.kind == QuicksortStepKind::FINISHED) {
         return sf::Color(0, 255, 65);  // All bars bright green
     }
     
     // Proper QuickSort Hoare partitioning highlighting - focused and clear
     
     // 1. BRIGHTEST: Active scanning pointers (left and right)
-    if (step.description.find("Left scan") != std::string::npos ||
-        step.description.find("Right scan") != std::string::npos ||
-        step.description.find("Move pointers") != std::string::npos) {
+    if (step.kind == QuicksortStepKind::LEFT_SCAN ||
+        step.kind == QuicksortStepKind::RIGHT_SCAN ||
+        step.kind == QuicksortStepKind::MOVE_POINTERS) {
         // Highlight the current left and right pointers
         if (index == step.lowIndex || index == step.highIndex) {
             return sf::Color(0, 255, 65);  // Brightest green - active pointers
@@ -271,20 +432,52 @@ sf::Color QuicksortVisualizer::getBarColor(int index, const QuicksortStep& step)
     }
     
     // 2. BRIGHTEST: Elements being swapped
-    if (step.description.find("Will swap") != std::string::npos || 
-        step.description.find("Swapped") != std::string::npos ||
-        step.description.find("Moving pivot") != std::string::npos ||
-        step.description.find("Partition complete") != std::string::npos) {
+    if (step.kind == QuicksortStepKind::SWAP_PENDING ||
+        step.kind == QuicksortStepKind::SWAPPED ||
+        step.kind == QuicksortStepKind::PIVOT_MOVE_PENDING) {
         if (index == step.lowIndex || index == step.highIndex) {
             return sf::Color(0, 255, 65);  // Brightest green - elements being swapped
         }
     }
     
+    // Alternative engines use the same pair highlight for their scans and swaps
+    switch (step.kind) {
+        case QuicksortStepKind::PIVOT_MEDIAN_OF_THREE:
+        case QuicksortStepKind::PIVOT_NINTHER:
+        case QuicksortStepKind::PIVOT_RANDOM:
+        case QuicksortStepKind::THREE_WAY_LESS:
+        case QuicksortStepKind::THREE_WAY_GREATER:
+        case QuicksortStepKind::THREE_WAY_EQUAL:
+        case QuicksortStepKind::DUAL_LESS:
+        case QuicksortStepKind::DUAL_GREATER:
+        case QuicksortStepKind::DUAL_MIDDLE:
+        case QuicksortStepKind::DUAL_PIVOT_PLACED:
+        case QuicksortStepKind::HEAP_SIFT:
+        case QuicksortStepKind::HEAP_EXTRACT:
+            if (index == step.lowIndex || index == step.highIndex) {
+                return sf::Color(0, 255, 65);  // Brightest green - active pair
+            }
+            break;
+        case QuicksortStepKind::THREE_WAY_DONE:
+            if (index >= step.lowIndex && index <= step.highIndex) {
+                return sf::Color(100, 255, 100);  // Medium green - the equal run is a block of pivots
+            }
+            break;
+        default:
+            break;
+    }
+    
     // 3. MEDIUM: Pivot (always visible as reference)
-    if (index == step.pivotIndex) {
+    if (index == step.pivotIndex || index == step.secondPivotIndex) {
         return sf::Color(100, 255, 100);  // Medium green - pivot reference
     }
     
+    // Parallel traces tint the remaining bars by the worker that owns them
+    const auto& owners = m_controller->getBarOwners();
+    if (index >= 0 && index < static_cast<int>(owners.size()) && owners[index] >= 0) {
+        return getWorkerColor(owners[index]);
+    }
+    
     // 4. NO RANGE HIGHLIGHTING - removed excessive background highlighting
     // Elements are either active (brightest), pivot (medium), or inactive (dim)
     
@@ -377,6 +570,105 @@ void QuicksortVisualizer::initializeControls() {
     }});
 }
 
+void QuicksortVisualizer::applyEngineSettings(const QuicksortEngineSettings& settings) {
+    // Remember how the current engine did on this input before re-running it
+    std::stringstream previous;
+    previous << m_controller->getTotalSteps() << (m_controller->isTraceComplete() ? "" : "+") << " steps";
+    m_previousEngineRun = previous.str();
+    
+    m_controller->setEngineSettings(settings);
+    m_controller->reset();
+    updateBarPositions();
+    m_operationCount = 0;
+    m_comparisonCount = 0;
+    m_swapCount = 0;
+}
+
+void QuicksortVisualizer::startScalingBenchmark() {
+    if (m_scalingFuture.valid()) return;  // Already running
+    
+    std::vector<int> threadCounts = {1, 2, 4};
+    int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (hardwareThreads > 4) {
+        threadCounts.push_back(hardwareThreads);
+    }
+    
+    PartitionKernel kernel = m_controller->getEngineSettings().partitionKernel;
+    m_benchmarkSummary = "MEASURING PARALLEL SPEEDUP ON 2M ELEMENTS WITH " + getPartitionKernelName(kernel) + "...";
+    m_scalingFuture = std::async(std::launch::async, [threadCounts, kernel]() {
+        return ParallelQuicksort::measureScaling(2000000, threadCounts, 12345, kernel);
+    });
+}
+
+void QuicksortVisualizer::pollScalingBenchmark() {
+    if (!m_scalingFuture.valid() ||
+        m_scalingFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    
+    std::stringstream summary;
+    summary << "SPEEDUP VS SERIAL (2M ELEMENTS):";
+    for (const auto& result : m_scalingFuture.get()) {
+        if (result.threadCount == 0) {
+            summary << " SERIAL " << static_cast<int>(result.milliseconds) << "ms |";
+            continue;
+        }
+        summary << " " << result.threadCount << "T " << static_cast<int>(result.milliseconds) << "ms "
+                << static_cast<int>(result.speedup * 100.0 + 0.5) / 100.0 << "x |";
+    }
+    m_benchmarkSummary = summary.str();
+    m_benchmarkSummary.pop_back();
+}
+
+void QuicksortVisualizer::startKernelBenchmark() {
+    if (m_kernelFuture.valid()) return;  // Already running
+    
+    m_benchmarkSummary = "MEASURING PARTITION KERNELS ON 4M ELEMENTS...";
+    m_kernelFuture = std::async(std::launch::async, []() {
+        return measurePartitionKernels(4000000, 5, 12345);
+    });
+}
+
+void QuicksortVisualizer::pollKernelBenchmark() {
+    if (!m_kernelFuture.valid() ||
+        m_kernelFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    
+    // Throughput in million elements/s, branch misses in thousands per partition
+    std::stringstream summary;
+    summary << "PARTITION 4M (MELEM/S, K BRANCH MISSES):";
+    for (const auto& result : m_kernelFuture.get()) {
+        summary << " " << getPartitionKernelName(result.kernel) << " ";
+        if (!result.supported) {
+            summary << "N/A |";
+            continue;
+        }
+        summary << static_cast<int>(result.elementsPerSecond / 1000000.0);
+        if (result.branchMisses >= 0) {
+            summary << " " << result.branchMisses / 1000 << "K";
+        }
+        summary << " |";
+    }
+    m_benchmarkSummary = summary.str();
+    m_benchmarkSummary.pop_back();
+}
+
+sf::Color QuicksortVisualizer::getWorkerColor(int workerId) const {
+    // Dim tints so active highlights still stand out
+    static const sf::Color palette[] = {
+        sf::Color(0, 102, 0),     // Theme dim green
+        sf::Color(150, 100, 0),   // Amber
+        sf::Color(0, 110, 130),   // Cyan
+        sf::Color(120, 50, 140),  // Violet
+        sf::Color(130, 130, 30),  // Olive
+        sf::Color(140, 50, 50),   // Rust
+        sf::Color(50, 70, 150),   // Blue
+        sf::Color(110, 110, 110)  // Grey
+    };
+    return palette[workerId % 8];
+}
+
 void QuicksortVisualizer::navigateControlsLeft() {
     if (m_selectedControlIndex > 0) {
         m_selectedControlIndex--;